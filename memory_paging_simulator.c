@@ -1,42 +1,895 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <string.h>
-#include <math.h>
+#include <limits.h>
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <sched.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+#if defined(__GNUC__)
+#define SPECIALIZE_INLINE static inline __attribute__((always_inline))
+#else
+#define SPECIALIZE_INLINE static inline
+#endif
 
 #define MENU_VIEW_MEMORY 1
 #define MENU_VIEW_PAGE_TABLE 2
 #define MENU_CREATE_PROCESS 3
-#define MENU_EXIT 4
+#define MENU_MEMORY_MAP 4
+#define MENU_ACCESS_MEMORY 5
+#define MENU_VIEW_STATISTICS 6
+#define MENU_REPLAY_TRACE 7
+#define MENU_CONFIGURE_PREFETCHER 8
+#define MENU_CONFIGURE_WRITEBACK 9
+#define MENU_CONFIGURE_CACHES 10
+#define MENU_VIRTUAL_MACHINES 11
+#define MENU_CONFIGURE_TIERING 12
+#define MENU_DUMP_STATE 13
+#define MENU_CONFIGURE_SAMPLING 14
+#define MENU_CONFIGURE_SCHEDULER 15
+#define MENU_TRANSLATE_BATCH 16
+#define MENU_PARALLEL_REPLAY 17
+#define MENU_SPECULATIVE_REPLAY 18
+#define MENU_VIEW_FRAME_MAP 19
+#define MENU_EXIT 0
+
+#define MMAP_MENU_MAP 1
+#define MMAP_MENU_UNMAP 2
+#define MMAP_MENU_PROTECT 3
+#define MMAP_MENU_BRK 4
+#define MMAP_MENU_VIEW 5
+#define MMAP_MENU_BACK 0
+
+#define VM_MENU_CREATE 1
+#define VM_MENU_CREATE_PROCESS 2
+#define VM_MENU_MEMORY_MAP 3
+#define VM_MENU_ACCESS 4
+#define VM_MENU_STATISTICS 5
+#define VM_MENU_GUEST_STATISTICS 6
+#define VM_MENU_CONFIGURE_TLB 7
+#define VM_MENU_REPLAY 8
+#define VM_MENU_BALLOON_TARGET 9
+#define VM_MENU_CONFIGURE_OVERCOMMIT 10
+#define VM_MENU_OVERCOMMIT_SUMMARY 11
+#define VM_MENU_BACK 0
+#define INITIAL_VM_LIST_CAPACITY 4
+
+#define OVERCOMMIT_DEFAULT_PERCENT 100
+#define BALLOON_DEFAULT_LOW_WATERMARK 5
+#define BALLOON_DEFAULT_HIGH_WATERMARK 10
+#define BALLOON_MAX_PERCENT 75
+#define BALLOON_DEFLATE_STEP 4
+#define BALLOON_CHECK_INTERVAL 64
+
+#define MEMORY_BACKING_HEAP 0
+#define MEMORY_BACKING_ANONYMOUS 1
+#define MEMORY_BACKING_FILE 2
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#define DUMP_FORMAT_TEXT 0
+#define DUMP_FORMAT_JSON 1
+#define DUMP_FORMAT_CSV 2
+#define DUMP_FORMAT_BINARY 3
+#define DUMP_MAGIC 0x4453504Du
+#define DUMP_VERSION 1
+#define WRITER_BUFFER_SIZE (1 << 20)
+#define FRAME_STATE_SLOW_TIER 4
+#define FRAME_MAP_MAX_RANGES 32
+#define JOURNAL_MAGIC 0x4A53504Du
+#define JOURNAL_VERSION 1
+#define JOURNAL_RING_EVENTS (1 << 16)
+#define JOURNAL_REPLAY_BLOCK 4096
+#define JOURNAL_WRITER_IDLE_NS 200000L
+#define JOURNAL_PROCESS_CREATE 1
+#define JOURNAL_PROCESS_EXIT 2
+#define JOURNAL_FRAME_ALLOC 3
+#define JOURNAL_FRAME_FREE 4
+#define JOURNAL_FAULT 5
+#define JOURNAL_EVICTION 6
+#define JOURNAL_MIGRATION 7
+#define JOURNAL_TIER_ADDED 8
+#define TIMESERIES_MAGIC 0x5354504Du
+#define TIMESERIES_VERSION 1
+#define TIMESERIES_FIXED_COLUMNS 7
+#define TIMESERIES_INITIAL_SAMPLES 256
+#define TIMESERIES_NAME_SIZE 32
+#define TIMESERIES_SCAN_FRAMES_PER_REFERENCE 2
+#define FRAME_MAP_STRIP_WIDTH 64
+#define OCCUPANCY_RAMP " .:-=+*#%@"
+#define FRAGMENTATION_RAMP ".:-=+*#%@"
 
 #define INITIAL_PROCESS_LIST_CAPACITY 10
+#define PID_MAP_INITIAL_CAPACITY 32
+#define PAGE_TABLE_BLOCK_ENTRIES 65536
+#define PAGE_TABLE_SIZE_CLASSES 32
+#define PAGE_TABLE_SPAN_POOL_BLOCK_OBJECTS 256
+#define POOL_ALIGNMENT 16
+#define VMA_POOL_BLOCK_OBJECTS 256
+#define FILE_PAGE_POOL_BLOCK_OBJECTS 64
 #define INPUT_BUFFER_SIZE 100
 
+#define PTE_NOT_PRESENT 0u
+#define PTE_PRESENT (1u << 0)
+#define PTE_SWAPPED (1u << 1)
+#define PTE_ACCESSED (1u << 2)
+#define PTE_DIRTY (1u << 3)
+#define PTE_PROT_SHIFT 4
+#define PTE_PROT_MASK (7u << PTE_PROT_SHIFT)
+#define PTE_INDEX_SHIFT 7
+#define PTE_INDEX_LIMIT (1 << (32 - PTE_INDEX_SHIFT))
+#define PTE_IS_PRESENT(entry) (((entry) & PTE_PRESENT) != 0)
+#define PTE_IS_SWAPPED(entry) (((entry) & PTE_SWAPPED) != 0)
+#define PTE_FRAME(entry) ((int)((entry) >> PTE_INDEX_SHIFT))
+#define PTE_SWAP_SLOT(entry) ((int)((entry) >> PTE_INDEX_SHIFT))
+#define PTE_PROT(entry) ((int)(((entry) & PTE_PROT_MASK) >> PTE_PROT_SHIFT))
+#define PTE_MAKE_PRESENT(frame, prot) \
+    (((uint32_t)(frame) << PTE_INDEX_SHIFT) | ((uint32_t)(prot) << PTE_PROT_SHIFT) | PTE_PRESENT)
+#define PTE_MAKE_SWAP(slot) (((uint32_t)(slot) << PTE_INDEX_SHIFT) | PTE_SWAPPED)
+#define PTE_WITH_FRAME(entry, frame) \
+    (((entry) & ((1u << PTE_INDEX_SHIFT) - 1)) | ((uint32_t)(frame) << PTE_INDEX_SHIFT))
+#define PTE_WITH_PROT(entry, prot) (((entry) & ~PTE_PROT_MASK) | ((uint32_t)(prot) << PTE_PROT_SHIFT))
+#define PTE_CHUNK_SHIFT 6
+#define PTE_CHUNK_ENTRIES (1 << PTE_CHUNK_SHIFT)
+#define PTE_COMPRESS_MIN_PAGES 1024
+
+#define FRAME_FREE 0
+#define FRAME_ANONYMOUS 1
+#define FRAME_PAGE_CACHE 2
+#define FRAME_BALLOON 3
+
+#define SWAP_SIZE_MULTIPLIER 2
+#define FILE_STORE_BUCKETS 1024
+#define READAHEAD_PAGES 4
+
+#define PREFETCH_SEQUENTIAL 1
+#define PREFETCH_STRIDE 2
+#define PREFETCH_MARKOV 4
+
+#define PREFETCH_INITIAL_WINDOW 4
+#define PREFETCH_DEFAULT_MAX_WINDOW 64
+#define PREFETCH_STRIDE_DEGREE 4
+#define PREFETCH_STRIDE_CONFIDENCE 2
+#define MARKOV_TABLE_SIZE 4096
+#define MARKOV_SUCCESSORS 2
+
+#define TRACE_LINE_SIZE 256
+
+#define WRITEBACK_DEFAULT_BACKGROUND_RATIO 10
+#define WRITEBACK_DEFAULT_DIRTY_RATIO 20
+#define WRITEBACK_DEFAULT_BATCH_PAGES 32
+#define WRITEBACK_DEFAULT_INTERVAL_NS 1000000LL
+
+#define CACHE_LEVELS 3
+#define CACHE_LINE_SIZE 64
+#define CACHE_INCLUSIVE 0
+#define CACHE_NON_INCLUSIVE 1
+#define CACHE_EXCLUSIVE 2
+#define CACHE_MAX_COLORS_SHOWN 64
+
+#define L1_DEFAULT_SIZE (32 * 1024)
+#define L1_DEFAULT_ASSOCIATIVITY 8
+#define L1_LATENCY_NS 1
+#define L2_DEFAULT_SIZE (256 * 1024)
+#define L2_DEFAULT_ASSOCIATIVITY 8
+#define L2_LATENCY_NS 4
+#define LLC_DEFAULT_SIZE (2 * 1024 * 1024)
+#define LLC_DEFAULT_ASSOCIATIVITY 16
+#define LLC_LATENCY_NS 12
+
+#define TLB_DEFAULT_ENTRIES 64
+#define TLB_DEFAULT_ASSOCIATIVITY 4
+
+#define PAGE_TABLE_REGION_STRIDE (1LL << 31)
+
+#define WALK_LEVELS 4
+#define WALK_INDEX_BITS 9
+#define PSC_DEFAULT_PML4_ENTRIES 2
+#define PSC_DEFAULT_PDPT_ENTRIES 4
+#define PSC_DEFAULT_PDE_ENTRIES 32
+
+#define MEMORY_TIERS 2
+#define TIER_DRAM 0
+#define TIER_SLOW 1
+#define TIER_DEFAULT_SLOW_LATENCY_NS 300
+#define TIER_DEFAULT_PROMOTION_RATE 64
+#define TIER_DEFAULT_HOTNESS_THRESHOLD 2
+#define TIER_DEFAULT_SAMPLE_INTERVAL 4
+#define TIER_HOTNESS_WINDOW_NS 1000000LL
+#define TIER_RATE_WINDOW_NS 1000000LL
+#define COST_MIGRATION_NS 2000
+
+#define SCHED_NONE 0
+#define SCHED_ROUND_ROBIN 1
+#define SCHED_FAIR 2
+#define SCHED_TLB_FLUSH 0
+#define SCHED_TLB_ASID 1
+#define SCHED_MAX_ASIDS 64
+#define SCHED_DEFAULT_ASIDS 6
+#define SCHED_DEFAULT_QUANTUM 100
+#define SCHED_DEFAULT_LATENCY 600
+#define SCHED_DEFAULT_MIN_GRANULARITY 75
+#define SCHED_DEFAULT_SWITCH_NS 2000
+#define SCHED_NICE_0_WEIGHT 1024
+#define INITIAL_STREAM_CAPACITY 64
+#define PARALLEL_MAX_WORKERS 256
+#define PARALLEL_EPOCH_REFERENCES (1 << 16)
+#define PARALLEL_MIN_QUOTA 2
+#define PARALLEL_REBALANCE_DIVISOR 8
+#define SPECULATION_CONTINUED 0
+#define SPECULATION_ACCEPTED 1
+#define SPECULATION_RERUN 2
+#define SPECULATION_MAX_EPOCHS (1 << 16)
+#define TRANSLATE_BATCH_MAX (1 << 20)
+#define TRANSLATE_BATCH_SHOWN 16
+#define PTE_READABLE (PTE_PRESENT | ((uint32_t)VMA_PROT_READ << PTE_PROT_SHIFT))
+#define PAGE_TABLE_FLAT 0
+#define PAGE_TABLE_COMPRESSED 1
+#define PAGE_TABLE_LAYOUTS 2
+#define PAGE_TABLE_ANY -1
+#define TRANSLATE_ISA_SCALAR 0
+#define TRANSLATE_ISA_AVX2 1
+#define TRANSLATE_ISA_AVX512 2
+#define TRANSLATE_ISAS 3
+
+#define GUEST_TABLE_REGION_BASE (1LL << 48)
+#define GUEST_TABLE_REGION_STRIDE (1LL << 40)
+
+#define COLOR_POLICY_NONE 0
+#define COLOR_POLICY_SPREAD 1
+#define COLOR_POLICY_PARTITION 2
+
+#define COST_MEMORY_ACCESS_NS 100
+#define COST_MINOR_FAULT_NS 1000
+#define COST_DISK_IO_NS 100000
+#define COST_DISK_PAGE_NS 10000
+
+#define VMA_PROT_NONE 0
+#define VMA_PROT_READ 1
+#define VMA_PROT_WRITE 2
+#define VMA_PROT_EXEC 4
+
+#define VMA_FLAG_FILE 1
+#define VMA_FLAG_SHARED 2
+#define VMA_FLAG_HEAP 4
+
+#define ACCESS_READ 0
+#define ACCESS_WRITE 1
+
+#define ACCESS_OK 0
+#define ACCESS_SEGFAULT -1
+#define ACCESS_PROTECTION -2
+#define ACCESS_OUT_OF_MEMORY -3
+
+typedef struct PoolBlock
+{
+    struct PoolBlock *next;
+} PoolBlock;
+
+typedef struct
+{
+    size_t object_size;
+    int objects_per_block;
+    PoolBlock *blocks;
+    void *free_list;
+    unsigned char *next_object;
+    int objects_left;
+    long long live_objects;
+} ObjectPool;
+
+typedef struct VmArea
+{
+    int start;
+    int end;
+    int prot;
+    int flags;
+    int file_id;
+    int file_offset;
+    int height;
+    struct VmArea *left;
+    struct VmArea *right;
+} VmArea;
+
+typedef uint32_t PageTableEntry;
+
+typedef struct PageTableBlock
+{
+    struct PageTableBlock *next;
+    size_t capacity;
+    size_t used;
+    PageTableEntry entries[];
+} PageTableBlock;
+
+typedef struct PageTableSpan
+{
+    PageTableEntry *entries;
+    struct PageTableSpan *next;
+} PageTableSpan;
+
+typedef struct
+{
+    PageTableBlock *head;
+    PageTableSpan *free_spans[PAGE_TABLE_SIZE_CLASSES];
+    ObjectPool span_nodes;
+    long long reserved_entries;
+    long long free_entries;
+} PageTableArena;
+
+typedef struct
+{
+    PageTableArena page_tables;
+    ObjectPool vma_nodes;
+} ProcessAllocator;
+
 typedef struct
 {
     int process_id;
     int process_size;
     int number_of_pages;
-    int *page_table;
+    PageTableEntry *page_table;
+    PageTableEntry *pte_directory;
+    int pte_chunks;
+    int pte_chunk_capacity;
+    ProcessAllocator *allocator;
+    VmArea *vma_root;
+    int vma_count;
+    int heap_start;
+    int brk;
+    int mmap_base;
+    int page_faults;
+    int last_fault_page;
+    int stride;
+    int stride_confidence;
+    int readahead_window;
+    int readahead_end;
+    int readahead_marker;
+    int color_first;
+    int color_count;
+    int color_cursor;
 } Process;
 
+typedef int (*TranslateKernel)(const Process *process, int page_shift, const int *vaddrs, int count,
+                               int *out_paddrs, uint64_t *fault_mask);
+
+struct PhysicalMemory;
+struct ProcessList;
+
+typedef int (*AccessKernel)(struct PhysicalMemory *phys_mem, struct ProcessList *proc_list, Process *process,
+                            int address, int access_type, int *physical_address);
+
+typedef struct
+{
+    int page_shift;
+    TranslateKernel kernels[TRANSLATE_ISAS][PAGE_TABLE_LAYOUTS];
+    AccessKernel access_kernels[PAGE_TABLE_LAYOUTS];
+    const char *names[TRANSLATE_ISAS];
+} TranslateKernelSet;
+
+typedef struct
+{
+    int type;
+    int owner;
+    int page;
+    int file_id;
+    int map_count;
+    int referenced;
+    int dirty;
+    int pinned;
+    int prefetched;
+    int swap_slot;
+    int cache_next;
+    int hotness;
+    long long last_sample_ns;
+} FrameInfo;
+
+typedef struct
+{
+    unsigned char *data;
+    int number_of_slots;
+    int *free_slots;
+    int free_slot_count;
+} SwapSpace;
+
+typedef struct FilePage
+{
+    int file_id;
+    int page;
+    unsigned char *data;
+    struct FilePage *next;
+} FilePage;
+
+typedef struct
+{
+    FilePage **buckets;
+    ObjectPool pages;
+    int page_count;
+} FileStore;
+
+typedef struct
+{
+    long long accesses;
+    long long minor_faults;
+    long long major_faults;
+    long long swap_ins;
+    long long swap_outs;
+    long long swap_writebacks;
+    long long page_cache_hits;
+    long long page_cache_misses;
+    long long readahead_pages;
+    long long writeback_pages;
+    long long anonymous_evictions;
+    long long page_cache_evictions;
+    long long clean_evictions;
+    long long dirty_evictions;
+    long long writeback_ios;
+    long long writeback_time_ns;
+    long long background_flushes;
+    long long throttle_events;
+    long long stall_time_ns;
+    long long simulated_time_ns;
+} MemoryStats;
+
+typedef struct
+{
+    int owner;
+    int page;
+    int successors[MARKOV_SUCCESSORS];
+} MarkovEntry;
+
+typedef struct
+{
+    int flags;
+    int max_window;
+    MarkovEntry *markov_table;
+    long long issued;
+    long long useful;
+    long long polluted;
+    long long demand_faults;
+    long long io_time_ns;
+} Prefetcher;
+
+typedef struct
+{
+    int background_ratio;
+    int dirty_ratio;
+    int batch_pages;
+    long long interval_ns;
+    long long last_flush_ns;
+    int dirty_pages;
+    int cursor;
+} WritebackControl;
+
+typedef struct
+{
+    int reference_interval;
+    long long interval_ns;
+    char path[INPUT_BUFFER_SIZE];
+} SamplingControl;
+
+typedef struct
+{
+    int space;
+    int offset;
+    int frame;
+} WritebackItem;
+
+typedef struct
+{
+    int size;
+    int associativity;
+    int sets;
+    int latency_ns;
+    long long *tags;
+    unsigned long long *last_used;
+    unsigned char *walk_lines;
+    long long hits;
+    long long misses;
+} CacheLevel;
+
+typedef struct
+{
+    int enabled;
+    int inclusion_policy;
+    CacheLevel levels[CACHE_LEVELS];
+    unsigned long long clock;
+    int colors;
+    long long *color_accesses;
+    long long *color_misses;
+    long long back_invalidations;
+    long long walk_accesses;
+    long long walk_memory_accesses;
+} CacheHierarchy;
+
+typedef struct
+{
+    int owner;
+    int page;
+    int frame;
+    unsigned long long last_used;
+} TlbEntry;
+
+typedef struct
+{
+    TlbEntry *entries;
+    int number_of_entries;
+    int associativity;
+    int sets;
+    unsigned long long clock;
+    long long hits;
+    long long misses;
+    long long walk_references;
+} Tlb;
+
+typedef struct
+{
+    int owner;
+    int prefix;
+    unsigned long long last_used;
+} PscEntry;
+
+typedef struct
+{
+    PscEntry *entries;
+    int number_of_entries;
+    long long lookups;
+    long long hits;
+    long long references_saved;
+} PagingStructureCache;
+
+typedef struct
+{
+    int enabled;
+    PagingStructureCache levels[WALK_LEVELS - 1];
+    unsigned long long clock;
+    long long walks;
+} PageWalker;
+
+typedef struct
+{
+    int policy;
+    int quantum;
+    int target_latency;
+    int min_granularity;
+    int context_switch_ns;
+    int tlb_mode;
+    int asid_count;
+    int asid_owners[SCHED_MAX_ASIDS];
+    unsigned long long asid_last_used[SCHED_MAX_ASIDS];
+    unsigned long long asid_clock;
+    int current;
+    long long context_switches;
+    long long tlb_flushes;
+    long long asid_recycles;
+    long long switch_time_ns;
+} Scheduler;
+
+typedef struct
+{
+    int access_type;
+    int address;
+} TraceReference;
+
+typedef struct
+{
+    TraceReference *references;
+    int count;
+    int capacity;
+    int next;
+} ReferenceStream;
+
+typedef struct
+{
+    int process;
+    int access_type;
+    int address;
+} ShardReference;
+
+typedef struct
+{
+    int policy;
+    int colors;
+    int bin_capacity;
+    int *free_counts;
+    int cursor;
+    long long partition_overflows;
+} ColorAllocator;
+
+typedef struct
+{
+    long long references;
+    long long faults;
+    long long segfaults;
+    long long protection_faults;
+    long long out_of_memory;
+    long long unknown_processes;
+    long long malformed_lines;
+    long long simulated_time_ns;
+} ReplayResult;
+
+typedef struct
+{
+    int column_count;
+    int process_count;
+    long long **columns;
+    int samples;
+    int capacity;
+    int failed;
+    int reference_interval;
+    long long interval_ns;
+    long long next_reference;
+    long long next_time_ns;
+    long long last_references;
+    long long last_faults;
+    long long last_evictions;
+    long long scan_credit;
+    int fragmentation_permille;
+} TimeSeries;
+
+typedef struct
+{
+    FILE *out;
+    char *data;
+    size_t used;
+    size_t capacity;
+    int failed;
+} BufferedWriter;
+
+typedef struct
+{
+    int free_frames;
+    int free_ranges;
+    int largest_free;
+} FreeRunSummary;
+
+typedef struct
+{
+    int type;
+    const char *path;
+    int huge_pages;
+    int fd;
+    size_t mapped_size;
+} MemoryBacking;
+
+typedef struct
+{
+    uint32_t type;
+    int32_t pid;
+    int32_t page;
+    int32_t frame;
+    int32_t value;
+    int32_t extra;
+    int64_t time_ns;
+} JournalEvent;
+
+typedef struct
+{
+    int pid;
+    int resident;
+    int live;
+    long long faults;
+} JournalProcess;
+
+typedef struct
+{
+    int pid;
+    int row;
+} PidMapSlot;
+
+typedef struct
+{
+    PidMapSlot *slots;
+    int capacity;
+    int count;
+} PidMap;
+
+typedef struct
+{
+    JournalEvent *events;
+    size_t capacity;
+    _Atomic size_t head;
+    _Atomic size_t tail;
+    atomic_int running;
+    atomic_int failed;
+    pthread_t writer;
+    FILE *out;
+    const char *path;
+    long long recorded;
+    long long full_waits;
+} EventJournal;
+
+typedef struct
+{
+    MemoryBacking backing;
+    const char *journal_path;
+    const char *replay_journal_path;
+    long long replay_index;
+    uint64_t seed;
+    int seeded;
+} CommandLineOptions;
+
+typedef struct
+{
+    uint64_t state[4];
+} RandomState;
+
+typedef struct
+{
+    int first_frame;
+    int number_of_frames;
+    int latency_ns;
+    int *free_frames;
+    int free_count;
+    int clock_hand;
+    long long accesses;
+} MemoryTier;
+
 typedef struct
+{
+    int tier_count;
+    MemoryTier tiers[MEMORY_TIERS];
+    int promotion_rate;
+    int hotness_threshold;
+    int sample_interval;
+    long long sample_counter;
+    long long rate_window_start_ns;
+    int promotions_in_window;
+    long long samples;
+    long long promotions;
+    long long demotions;
+    long long promotions_throttled;
+    long long slow_evictions;
+} TierControl;
+
+typedef struct PhysicalMemory
 {
     unsigned char *memory;
     int total_size;
     int page_size;
+    int page_shift;
+    int page_mask;
     int number_of_frames;
     int *free_frames;
     int free_frame_count;
+    ColorAllocator color_allocator;
+    FrameInfo *frames;
+    int clock_hand;
+    SwapSpace swap;
+    int *page_cache_buckets;
+    int page_cache_bucket_count;
+    int page_cache_pages;
+    FileStore file_store;
+    MemoryStats stats;
+    Prefetcher prefetcher;
+    WritebackControl writeback;
+    SamplingControl sampling;
+    CacheHierarchy caches;
+    Tlb tlb;
+    PageWalker walker;
+    Scheduler scheduler;
+    TierControl tiering;
+    MemoryBacking backing;
+    EventJournal *journal;
+    RandomState random;
+    TranslateKernel translate_kernels[PAGE_TABLE_LAYOUTS];
+    AccessKernel access_kernels[PAGE_TABLE_LAYOUTS];
+    const char *translate_kernel_name;
+    int guest_mode;
 } PhysicalMemory;
 
-typedef struct
+typedef struct ProcessList
 {
     Process *processes;
+    int *process_ids;
+    int *resident_pages;
+    int *weights;
+    long long *vruntimes;
+    long long *quanta;
+    long long *scheduled_references;
+    long long *cpu_time_ns;
+    PidMap pid_index;
     int count;
     int capacity;
+    ProcessAllocator *allocator;
 } ProcessList;
 
+typedef struct
+{
+    int vm_id;
+    int vmm_pid;
+    int guest_base;
+    long long table_base;
+    PhysicalMemory guest;
+    ProcessList guest_processes;
+    Tlb combined_tlb;
+    long long accesses;
+    long long nested_walks;
+    long long guest_references;
+    long long host_references;
+    int max_walk_references;
+    int *balloon_frames;
+    int balloon_pages;
+    long long balloon_inflations;
+    long long balloon_deflations;
+    long long balloon_guest_evictions;
+    long long host_pages_saved;
+    long long ballooned_accesses;
+    long long ballooned_faults;
+    long long unballooned_accesses;
+    long long unballooned_faults;
+} VirtualMachine;
+
+typedef struct
+{
+    VirtualMachine *vms;
+    int count;
+    int capacity;
+    int overcommit_percent;
+    long long committed_bytes;
+    int balloon_enabled;
+    int low_watermark;
+    int high_watermark;
+} VmList;
+
+typedef struct
+{
+    unsigned char *memory;
+    int number_of_frames;
+    int *spare_frames;
+    int spare_count;
+} ReplayPool;
+
+typedef struct
+{
+    PhysicalMemory memory;
+    ProcessList processes;
+    ReplayPool *pool;
+    ShardReference *references;
+    long long reference_count;
+    long long next_reference;
+    long long epoch_end;
+    int quota;
+    int quota_target;
+    long long frames_received;
+    long long frames_donated;
+    long long epoch_references;
+    long long epoch_faults;
+    ReplayResult result;
+} ReplayShard;
+
+typedef struct
+{
+    ReplayShard shard;
+    ReplayPool pool;
+    int seeded;
+} SpeculativeWorker;
+
+typedef struct
+{
+    SpeculativeWorker *worker;
+    const ShardReference *references;
+    long long warmup_start;
+    long long start;
+    long long end;
+    ReplayResult result;
+    long long simulated_time_ns;
+    long long *start_pages;
+    int start_page_count;
+    long long *end_pages;
+    int end_page_count;
+    int divergence;
+    int status;
+} SpeculativeEpoch;
+
 /**
  * Checks if a number is a power of two.
  *
@@ -45,153 +898,11163 @@ typedef struct
  */
 int is_power_of_two(int number);
 
+/**
+ * Returns the base-2 logarithm of a power of two. Zero and values that are not powers
+ * of two are outside the domain and fail an assertion.
+ *
+ * @param value A power of two, from 1 to 2^63.
+ * @return log2 of the value, from 0 to 63.
+ */
+int log2_exact(uint64_t value);
+
+/**
+ * Returns the number of pages needed to hold a size, rounding up. Exact over the full
+ * 64-bit range, with no intermediate overflow: a size of 0 needs 0 pages and UINT64_MAX
+ * needs (UINT64_MAX >> page_shift) + 1 for any shift above 0. A shift outside [0, 63]
+ * fails an assertion.
+ *
+ * @param size Size in bytes.
+ * @param page_shift log2 of the page size, below 64.
+ * @return Number of pages.
+ */
+uint64_t pages_for_size(uint64_t size, int page_shift);
+
+/**
+ * Rounds a value up to a multiple of a power-of-two alignment. Zero and values already
+ * aligned, including UINT64_MAX with a shift of 0, are returned unchanged; a value within
+ * one alignment of UINT64_MAX is rejected rather than wrapped. A shift outside [0, 63]
+ * fails an assertion.
+ *
+ * @param value Value to round.
+ * @param shift log2 of the alignment, below 64.
+ * @param aligned Receives the rounded value.
+ * @return 1 on success, 0 if the rounded value does not fit in 64 bits.
+ */
+int align_up(uint64_t value, int shift, uint64_t *aligned);
+
 /**
  * Initializes the physical memory structure.
  *
  * @param phys_mem Pointer to the PhysicalMemory structure to initialize.
  * @param total_size Total size of physical memory in bytes.
  * @param page_size Size of each page/frame in bytes.
+ * @param backing How to back the simulated RAM array, or NULL for a heap allocation.
  */
-void initialize_physical_memory(PhysicalMemory *phys_mem, int total_size, int page_size);
+void initialize_physical_memory(PhysicalMemory *phys_mem, int total_size, int page_size,
+                                const MemoryBacking *backing);
 
 /**
- * Initializes the process list structure.
+ * Initializes the physical memory structure around an existing RAM array, allocating the
+ * frame, swap and page cache metadata. The backing is left to the caller.
  *
- * @param proc_list Pointer to the ProcessList structure to initialize.
+ * @param phys_mem Pointer to the PhysicalMemory structure to initialize.
+ * @param memory Simulated RAM array of total_size bytes.
+ * @param total_size Total size of physical memory in bytes.
+ * @param page_size Size of each page/frame in bytes.
+ * @param swap_slots Number of pages the swap area holds.
  */
-void initialize_process_list(ProcessList *proc_list);
+void attach_physical_memory(PhysicalMemory *phys_mem, unsigned char *memory, int total_size, int page_size,
+                            int swap_slots);
 
 /**
- * Allocates free frames for a process.
+ * Allocates the simulated RAM array. Heap backing uses calloc. Anonymous backing maps
+ * zero-filled memory with MAP_NORESERVE, so the host commits pages only as the simulation
+ * touches them. File backing maps the file shared, so its contents survive across runs.
+ * Huge pages are requested with MAP_HUGETLB, falling back to transparent huge pages. The
+ * hugetlb mapping keeps its reservation: with MAP_NORESERVE an empty hugetlb pool would
+ * only surface as SIGBUS on first touch.
  *
- * @param phys_mem Pointer to the PhysicalMemory structure.
- * @param required_frames Number of frames required.
- * @param allocated_frames Array to store allocated frame indices.
- * @return 1 if allocation is successful, 0 otherwise.
+ * @param backing Backing configuration; fd and mapped_size are filled in.
+ * @param size Size of the array in bytes.
+ * @return Pointer to the array, or NULL on failure.
  */
-int allocate_frames(PhysicalMemory *phys_mem, int required_frames, int *allocated_frames);
+unsigned char *map_memory_array(MemoryBacking *backing, size_t size);
 
 /**
- * Creates a new process, allocates memory, and initializes its page table.
+ * Resizes the simulated RAM array, preserving its contents. New bytes are zero for heap
+ * and anonymous backing and come from the file for file backing.
  *
- * @param phys_mem Pointer to the PhysicalMemory structure.
- * @param proc_list Pointer to the ProcessList structure.
- * @param max_process_size Maximum allowed size for a process in bytes.
+ * @param backing Backing configuration.
+ * @param memory Current array.
+ * @param old_size Current size in bytes.
+ * @param new_size Required size in bytes.
+ * @return Pointer to the resized array, or NULL on failure (the old array stays valid).
  */
-void create_process(PhysicalMemory *phys_mem, ProcessList *proc_list, int max_process_size);
+unsigned char *resize_memory_array(MemoryBacking *backing, unsigned char *memory, size_t old_size, size_t new_size);
 
 /**
- * Displays the current state of physical memory, including free frames and frame statuses.
+ * Releases the simulated RAM array and closes its backing file.
  *
- * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param backing Backing configuration.
+ * @param memory Array to release.
  */
-void view_physical_memory(const PhysicalMemory *phys_mem);
+void unmap_memory_array(MemoryBacking *backing, unsigned char *memory);
 
 /**
- * Displays the page table of a specified process.
+ * Parses the command line options: how simulated RAM is backed, where to record the
+ * event journal and which journal to replay.
  *
- * @param proc_list Pointer to the ProcessList structure.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param options Options to fill in.
+ * @return 1 on success, 0 if the arguments are invalid.
  */
-void view_page_table(const ProcessList *proc_list);
+int parse_arguments(int argc, char *argv[], CommandLineOptions *options);
 
 /**
- * Frees all dynamically allocated memory before exiting the program.
+ * Advances a SplitMix64 generator and returns its next output. Used to expand a single
+ * seed into a full xoshiro256** state.
  *
- * @param phys_mem Pointer to the PhysicalMemory structure.
- * @param proc_list Pointer to the ProcessList structure.
+ * @param state Generator state.
+ * @return Next 64-bit output.
  */
-void free_memory(PhysicalMemory *phys_mem, ProcessList *proc_list);
+uint64_t splitmix64_next(uint64_t *state);
 
 /**
- * Clears the input buffer to handle invalid inputs.
+ * Seeds a xoshiro256** generator from a 64-bit seed.
+ *
+ * @param random Generator to seed.
+ * @param seed Seed value.
  */
-void clear_input_buffer(void);
+void random_seed(RandomState *random, uint64_t seed);
 
-int main()
-{
-    srand((unsigned int)time(NULL));
+/**
+ * Returns the next output of a xoshiro256** generator.
+ *
+ * @param random Generator state.
+ * @return Next 64-bit output.
+ */
+uint64_t random_next(RandomState *random);
 
-    PhysicalMemory phys_mem;
-    ProcessList proc_list;
-    int total_memory_size, page_size, max_process_size;
+/**
+ * Splits off an independent stream: the child continues the parent's sequence and the
+ * parent jumps 2^128 outputs ahead, so the two never overlap.
+ *
+ * @param parent Generator to split; advanced past the child's stream.
+ * @param child Receives the new stream.
+ */
+void random_split(RandomState *parent, RandomState *child);
 
-    printf("=== Memory Paging Simulator ===\n\n");
-    printf("Initial Configuration:\n");
+/**
+ * Opens an event journal: writes the file header and starts the writer thread that
+ * drains the ring buffer to the file.
+ *
+ * @param journal Pointer to the EventJournal.
+ * @param path Journal file path.
+ * @param phys_mem Pointer to the PhysicalMemory structure described by the header.
+ * @return 1 on success, 0 on failure.
+ */
+int journal_open(EventJournal *journal, const char *path, const PhysicalMemory *phys_mem);
 
-    while (1)
-    {
-        printf("Enter the size of physical memory in bytes (power of 2): ");
-        if (scanf("%d", &total_memory_size) != 1)
-        {
-            printf("Invalid input. Please enter a valid integer.\n");
-            clear_input_buffer();
-            continue;
-        }
-        if (!is_power_of_two(total_memory_size))
-        {
-            printf("Error: Size must be a power of 2.\n");
-            continue;
-        }
-        break;
+/**
+ * Appends an event to the journal ring buffer. The simulation thread is the only
+ * producer, so publishing an event is a plain store followed by a release store of the
+ * head index. When the ring is full the producer yields until the writer catches up,
+ * so no event is ever dropped. Does nothing when no journal is attached.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param type One of the JOURNAL_* event types.
+ * @param pid Process ID, or -1.
+ * @param page Virtual page or file page, or -1.
+ * @param frame Frame index, or -1.
+ * @param value Event-specific value.
+ * @param extra Event-specific value.
+ */
+void journal_record(PhysicalMemory *phys_mem, int type, int pid, int page, int frame, int value, int extra);
+
+/**
+ * Records a JOURNAL_PROCESS_EXIT event for every process of a list. Processes only exit
+ * when the simulator shuts down, so this runs once, before teardown, and only when a
+ * journal is attached.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void journal_process_exits(PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Body of the journal writer thread: copies published events from the ring to the file
+ * in contiguous batches until the journal is stopped and the ring is empty.
+ *
+ * @param argument Pointer to the EventJournal.
+ * @return NULL.
+ */
+void *journal_writer_thread(void *argument);
+
+/**
+ * Stops the writer thread after it drains the ring, closes the file and releases the
+ * ring.
+ *
+ * @param journal Pointer to the EventJournal.
+ * @return 1 if every event was written, 0 otherwise.
+ */
+int journal_close(EventJournal *journal);
+
+/**
+ * Looks a process up by PID in an open-addressing hash map. Slots carry the PID next to
+ * the row, so a probe never touches the rows themselves.
+ *
+ * @param map Pointer to the PidMap.
+ * @param pid Process ID.
+ * @return Row index of the process, or -1 if it is not in the map.
+ */
+int pid_map_find(const PidMap *map, int pid);
+
+/**
+ * Doubles the table of a PID map until it can hold count PIDs while staying at most half
+ * full.
+ *
+ * @param map Pointer to the PidMap.
+ * @param count Number of PIDs the map must hold.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int pid_map_reserve(PidMap *map, int count);
+
+/**
+ * Maps a PID to a row, replacing an earlier row with the same PID.
+ *
+ * @param map Pointer to the PidMap.
+ * @param pid Process ID.
+ * @param row Row the PID maps to.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int pid_map_insert(PidMap *map, int pid, int row);
+
+/**
+ * Checks a journal event before it is applied. The journal is untrusted input, so every
+ * frame index, frame type and frame count is checked against the current frame map.
+ *
+ * @param event Event to check.
+ * @param number_of_frames Number of frames in the reconstructed map.
+ * @param owner Row of the event's process, or NULL if its PID is unknown.
+ * @return NULL if the event is valid, otherwise a description of the problem.
+ */
+const char *journal_event_error(const JournalEvent *event, int number_of_frames, const JournalProcess *owner);
+
+/**
+ * Reconstructs the frame map and process table from a journal by applying its events up
+ * to an index, and prints the result. Replay stops with an error at the first invalid
+ * event or at a truncated final event. Processes only exit when the simulator shuts
+ * down, so every process stays live until the exit events at the end of the journal.
+ *
+ * @param path Journal file path.
+ * @param index Number of events to apply, or -1 for all of them.
+ * @return 1 on success, 0 if the journal cannot be read.
+ */
+int replay_journal(const char *path, long long index);
+
+/**
+ * Initializes the process list structure.
+ *
+ * @param proc_list Pointer to the ProcessList structure to initialize.
+ */
+void initialize_process_list(ProcessList *proc_list);
+
+/**
+ * Makes room for one more process in a process list, including its PID index entry.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @return 1 on success, 0 if the list could not be grown.
+ */
+int reserve_process_slot(ProcessList *proc_list);
+
+/**
+ * Resizes an int column of a process list.
+ *
+ * @param column Pointer to the column; left unchanged on failure.
+ * @param capacity Number of rows the column must hold.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int resize_int_column(int **column, int capacity);
+
+/**
+ * Resizes a counter column of a process list.
+ *
+ * @param column Pointer to the column; left unchanged on failure.
+ * @param capacity Number of rows the column must hold.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int resize_counter_column(long long **column, int capacity);
+
+/**
+ * Appends a process to a list that has a slot reserved by reserve_process_slot, filling
+ * its columns and indexing its PID. The scheduler counters of the new row start at zero.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Process record to store.
+ * @param resident_pages Number of pages already resident for the process.
+ * @param weight Scheduler weight of the process.
+ * @return Pointer to the stored process.
+ */
+Process *add_process(ProcessList *proc_list, const Process *process, int resident_pages, int weight);
+
+/**
+ * Returns the size class of a page table: the smallest c with 2^c >= entries. Tables are
+ * carved in spans of exactly 2^c entries, so a freed span fits any later table of the
+ * same class.
+ *
+ * @param entries Number of entries the table needs.
+ * @return Size class.
+ */
+int page_table_size_class(size_t entries);
+
+/**
+ * Puts a run of page table entries on the arena's free lists, split into power-of-two
+ * spans, so later tables can reuse it. Spans whose record cannot be allocated are left
+ * unused.
+ *
+ * @param arena Pointer to the PageTableArena.
+ * @param entries First entry of the span.
+ * @param count Number of entries in the span.
+ */
+void push_page_table_span(PageTableArena *arena, PageTableEntry *entries, size_t count);
+
+/**
+ * Carves a page table out of the arena shared by every process of a list. The table gets
+ * a span of 2^c entries for its size class c. A span freed by an earlier table is reused
+ * first, splitting a larger one if its own class is empty. Otherwise the span is
+ * bump-allocated from the current block of PAGE_TABLE_BLOCK_ENTRIES entries, so tables
+ * created one after another share blocks and the whole arena is released at once.
+ *
+ * @param arena Pointer to the PageTableArena.
+ * @param entries Number of entries the table needs.
+ * @return Pointer to the table, or NULL if a new block could not be allocated.
+ */
+PageTableEntry *allocate_page_table(PageTableArena *arena, int entries);
+
+/**
+ * Grows a page table allocated from an arena. A table that still fits its span, or that
+ * sits at the top of the current block, is extended in place; otherwise it is copied to a
+ * fresh span and the old span goes back on the free lists.
+ *
+ * @param arena Pointer to the PageTableArena.
+ * @param table Current table.
+ * @param old_entries Number of entries in the current table.
+ * @param new_entries Number of entries required.
+ * @return Pointer to the grown table, or NULL on allocation failure.
+ */
+PageTableEntry *grow_page_table(PageTableArena *arena, PageTableEntry *table, int old_entries, int new_entries);
+
+/**
+ * Returns a page table to its arena. The most recent allocation shrinks the current block;
+ * any other table goes on the free list for its size class.
+ *
+ * @param arena Pointer to the PageTableArena.
+ * @param table Table to release.
+ * @param entries Number of entries in the table.
+ */
+void release_page_table(PageTableArena *arena, PageTableEntry *table, int entries);
+
+/**
+ * Releases every block of a page table arena.
+ *
+ * @param arena Pointer to the PageTableArena.
+ */
+void free_page_table_arena(PageTableArena *arena);
+
+/**
+ * Initializes a pool of fixed-size objects carved from blocks of objects_per_block.
+ *
+ * @param pool Pointer to the ObjectPool.
+ * @param object_size Size of one object in bytes.
+ * @param objects_per_block Number of objects allocated together.
+ */
+void initialize_object_pool(ObjectPool *pool, size_t object_size, int objects_per_block);
+
+/**
+ * Takes an object from a pool, reusing a freed one if available.
+ *
+ * @param pool Pointer to the ObjectPool.
+ * @return Pointer to the object, or NULL if a new block could not be allocated.
+ */
+void *pool_alloc(ObjectPool *pool);
+
+/**
+ * Returns an object to its pool's free list.
+ *
+ * @param pool Pointer to the ObjectPool.
+ * @param object Object previously returned by pool_alloc.
+ */
+void pool_free(ObjectPool *pool, void *object);
+
+/**
+ * Releases every block of a pool, and with it every object still allocated.
+ *
+ * @param pool Pointer to the ObjectPool.
+ */
+void free_object_pool(ObjectPool *pool);
+
+/**
+ * Allocates free frames for a process, choosing LLC colors according to the allocation policy.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param process Process the frames are for, or NULL for shared page cache frames.
+ * @param required_frames Number of frames required.
+ * @param allocated_frames Array to store allocated frame indices.
+ * @return 1 if allocation is successful, 0 otherwise.
+ */
+int allocate_frames(PhysicalMemory *phys_mem, Process *process, int required_frames, int *allocated_frames);
+
+/**
+ * Rebuilds the per-color free frame bins from the frame table. Called at startup and
+ * whenever the LLC geometry changes the number of page colors.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int rebuild_color_bins(PhysicalMemory *phys_mem);
+
+/**
+ * Returns a freed frame to the free list of its tier: the color bins for DRAM, a plain
+ * stack for the slow tier.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame index.
+ */
+void push_free_frame(PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Returns the memory tier a frame belongs to.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame index.
+ * @return TIER_DRAM or TIER_SLOW.
+ */
+int frame_tier(const PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Returns the LLC color of a frame.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame index.
+ * @return Color index.
+ */
+int frame_color(const PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Picks the color bin the next frame for a process should come from. Under the partition
+ * policy a process that has exhausted its colors falls back to any free color.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param process Process the frame is for, or NULL.
+ * @return Color index, or -1 if no frame is free.
+ */
+int select_frame_color(PhysicalMemory *phys_mem, Process *process);
+
+/**
+ * Returns frames to the free frame list.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frames Array of frame indices to release.
+ * @param count Number of frames in the array.
+ */
+void release_frames(PhysicalMemory *phys_mem, const int *frames, int count);
+
+/**
+ * Creates a new process, allocates memory, and initializes its page table. The image is a
+ * load rather than a write, so its pages start clean and do not count toward the dirty
+ * ratio; a clean anonymous page without a swap slot is still written to swap when evicted.
+ * Under the partition coloring policy the color range is asked for before the image is
+ * allocated, so the image itself lands in the process's partition.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param max_process_size Maximum allowed size for a process in bytes.
+ */
+void create_process(PhysicalMemory *phys_mem, ProcessList *proc_list, int max_process_size);
+
+/**
+ * Displays the current state of physical memory, including free frames and frame statuses.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void view_physical_memory(const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Displays the page table of a specified process.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void view_page_table(const ProcessList *proc_list);
+
+/**
+ * Prepares a buffered writer over a stream. Output is collected in a WRITER_BUFFER_SIZE
+ * buffer and handed to the stream in large blocks.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param out Destination stream.
+ * @return 1 on success, 0 if the buffer could not be allocated.
+ */
+int writer_open(BufferedWriter *writer, FILE *out);
+
+/**
+ * Appends raw bytes to a buffered writer.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param bytes Bytes to append.
+ * @param length Number of bytes.
+ */
+void writer_bytes(BufferedWriter *writer, const void *bytes, size_t length);
+
+/**
+ * Appends a NUL-terminated string to a buffered writer.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param text String to append.
+ */
+void writer_string(BufferedWriter *writer, const char *text);
+
+/**
+ * Appends the decimal form of an integer to a buffered writer without going through
+ * printf.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param value Integer to append.
+ */
+void writer_int(BufferedWriter *writer, long long value);
+
+/**
+ * Appends a 32-bit word in host byte order to a buffered writer.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param value Word to append.
+ */
+void writer_u32(BufferedWriter *writer, uint32_t value);
+
+/**
+ * Flushes a buffered writer to its stream.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ */
+void writer_flush(BufferedWriter *writer);
+
+/**
+ * Flushes a buffered writer and releases its buffer.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @return 1 if every write succeeded, 0 otherwise.
+ */
+int writer_close(BufferedWriter *writer);
+
+/**
+ * Returns the state of a frame used to group frames into runs: its type, plus
+ * FRAME_STATE_SLOW_TIER for frames of the slow tier.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame index.
+ * @return Frame state code.
+ */
+int frame_state(const PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Counts the free frames among the first frames of physical memory and the runs they
+ * form. A run ends at a used frame or at the boundary between tiers.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame_count Number of frames to scan, starting at frame 0.
+ * @param summary Receives the free frame count, the number of free runs and the longest.
+ */
+void summarize_free_runs(const PhysicalMemory *phys_mem, int frame_count, FreeRunSummary *summary);
+
+/**
+ * Returns the external fragmentation of a set of free runs: the share of free frames
+ * outside the longest run, in permille.
+ *
+ * @param summary Free run summary.
+ * @return Fragmentation in permille.
+ */
+int free_run_fragmentation_permille(const FreeRunSummary *summary);
+
+/**
+ * Prints every range of frames with the same state, one line per range.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void view_frame_map(const PhysicalMemory *phys_mem);
+
+/**
+ * Prints a summary of the frame map: the first FRAME_MAP_MAX_RANGES ranges of frames
+ * with the same state and owner, free range statistics and occupancy and fragmentation
+ * heat strips. View Full Frame Map lists every range.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure, used to name owners.
+ */
+void view_frame_map_summary(const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Returns the last frame of the run of frames in the same state that starts at a frame.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param first First frame of the run.
+ * @return Last frame of the run.
+ */
+int frame_run_end(const PhysicalMemory *phys_mem, int first);
+
+/**
+ * Returns the first page at or after a page whose entry is not empty, skipping
+ * unpopulated chunks of compressed tables.
+ *
+ * @param process Pointer to the process.
+ * @param page First page to consider.
+ * @return Page number, or number_of_pages if there is none.
+ */
+int next_mapped_page(const Process *process, int page);
+
+/**
+ * Returns the last page of the run that starts at a page: consecutive pages with the same
+ * flags mapping consecutive frames or swap slots.
+ *
+ * @param process Pointer to the process.
+ * @param first First page of the run; its entry must not be empty.
+ * @return Last page of the run.
+ */
+int page_run_end(const Process *process, int first);
+
+/**
+ * Writes one run of frames in a dump format.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param format One of the DUMP_FORMAT_* values.
+ * @param first First frame of the run.
+ * @param last Last frame of the run.
+ * @param state Frame state code shared by the run.
+ * @param index Position of the run in its list, used for separators.
+ */
+void write_frame_run(BufferedWriter *writer, int format, int first, int last, int state, int index);
+
+/**
+ * Writes one run of page table entries in a dump format.
+ *
+ * @param writer Pointer to the BufferedWriter.
+ * @param format One of the DUMP_FORMAT_* values.
+ * @param pid Process ID owning the run.
+ * @param first First page of the run.
+ * @param last Last page of the run.
+ * @param entry Entry of the first page.
+ * @param index Position of the run in its list, used for separators.
+ */
+void write_page_run(BufferedWriter *writer, int format, int pid, int first, int last, PageTableEntry entry,
+                    int index);
+
+/**
+ * Writes the frame map and every page table as run-length-compressed records.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param format One of the DUMP_FORMAT_* values.
+ * @param out Destination stream.
+ * @return 1 on success, 0 on allocation or write failure.
+ */
+int dump_memory_state(const PhysicalMemory *phys_mem, const ProcessList *proc_list, int format, FILE *out);
+
+/**
+ * Prompts for a dump format and destination and writes the memory state.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void dump_memory_menu(const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Looks up a process by its ID through the list's PID index.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param pid Process ID to search for.
+ * @return Pointer to the process, or NULL if no process has that ID.
+ */
+Process *find_process(const ProcessList *proc_list, int pid);
+
+/**
+ * Rounds an address up to the next page boundary.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param address Address in bytes.
+ * @return The page-aligned address, or -1 if it would overflow.
+ */
+int page_align_up(const PhysicalMemory *phys_mem, long long address);
+
+/**
+ * Returns the highest usable virtual address (exclusive) for a process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @return Page-aligned upper bound of the virtual address space.
+ */
+int address_space_limit(const PhysicalMemory *phys_mem);
+
+/**
+ * Grows a process page table so that it covers at least the given number of pages.
+ * New entries are marked as not present.
+ *
+ * @param process Pointer to the process.
+ * @param pages Number of virtual pages the table must cover.
+ * @return 1 on success, 0 if the table could not be grown in the page table arena.
+ */
+int ensure_page_table_span(Process *process, int pages);
+
+/**
+ * Reads a page table entry, in either the flat or the compressed layout.
+ *
+ * @param process Pointer to the process.
+ * @param page Virtual page number, below number_of_pages.
+ * @return The entry; PTE_NOT_PRESENT for pages in an unallocated chunk.
+ */
+PageTableEntry pte_get(const Process *process, int page);
+
+/**
+ * Reads a page table entry from a table of a known layout: one array lookup for a flat
+ * table, directory then chunk for a compressed one. PAGE_TABLE_ANY falls back to pte_get.
+ *
+ * @param process Pointer to the process.
+ * @param page Virtual page number, below number_of_pages.
+ * @param layout PAGE_TABLE_FLAT, PAGE_TABLE_COMPRESSED or PAGE_TABLE_ANY.
+ * @return The entry; PTE_NOT_PRESENT for pages in an unallocated chunk.
+ */
+SPECIALIZE_INLINE PageTableEntry pte_get_layout(const Process *process, int page, int layout);
+
+/**
+ * Writes a page table entry. In the compressed layout a chunk is allocated the first time
+ * a non-empty entry is stored in it; that allocation is the only way the write can fail,
+ * so overwriting an entry that is already non-empty always succeeds.
+ *
+ * @param process Pointer to the process.
+ * @param page Virtual page number, below number_of_pages.
+ * @param entry Entry to store.
+ * @return 1 on success, or 0 if a page table chunk could not be allocated.
+ */
+int pte_set(Process *process, int page, PageTableEntry entry);
+
+/**
+ * Converts a flat page table into the compressed layout: a directory with one word per
+ * PTE_CHUNK_ENTRIES pages, holding the 1-based index of the chunk that stores them, or 0
+ * if none of those pages has ever been mapped. Only populated chunks are kept.
+ *
+ * @param process Pointer to the process.
+ * @param pages Number of virtual pages the directory must cover.
+ * @return 1 on success, 0 if the arena could not supply the directory or chunks.
+ */
+int compress_page_table(Process *process, int pages);
+
+/**
+ * Releases the chunks of a compressed page table that no longer hold any entry, among
+ * those covering a range of pages, and clears their directory slots. The last chunk moves
+ * into each freed one so the chunks stay dense, and the chunk array shrinks once it is
+ * at most a quarter full.
+ *
+ * @param process Pointer to the process.
+ * @param start_page First virtual page of the range.
+ * @param end_page Virtual page after the last one in the range.
+ */
+void release_empty_pte_chunks(Process *process, int start_page, int end_page);
+
+/**
+ * Returns the protection bits to cache in a PTE mapping a frame through a VMA. Private
+ * mappings of page cache frames are cached read-only so that writes take the
+ * copy-on-write fault.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param vma VMA covering the page.
+ * @param frame Frame being mapped.
+ * @return Combination of VMA_PROT_* bits.
+ */
+int pte_protection(const PhysicalMemory *phys_mem, const VmArea *vma, int frame);
+
+/**
+ * Tests and clears the referenced bit of a frame for the reclaim clocks. Anonymous frames
+ * are tracked by the accessed bit of their owner's PTE; page cache frames, which may be
+ * mapped many times, by the frame's own referenced flag.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param frame Frame index.
+ * @return 1 if the frame had been referenced since the last test.
+ */
+int test_and_clear_referenced(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame);
+
+/**
+ * Returns the height of a VMA tree node (0 for an empty subtree).
+ *
+ * @param node Tree node, may be NULL.
+ * @return Height of the subtree.
+ */
+int vma_height(const VmArea *node);
+
+/**
+ * Recomputes the cached height of a VMA tree node from its children.
+ *
+ * @param node Tree node.
+ */
+void vma_update_height(VmArea *node);
+
+/**
+ * Performs a left rotation around a VMA tree node.
+ *
+ * @param node Root of the subtree to rotate.
+ * @return New root of the subtree.
+ */
+VmArea *vma_rotate_left(VmArea *node);
+
+/**
+ * Performs a right rotation around a VMA tree node.
+ *
+ * @param node Root of the subtree to rotate.
+ * @return New root of the subtree.
+ */
+VmArea *vma_rotate_right(VmArea *node);
+
+/**
+ * Restores the AVL balance invariant at a VMA tree node.
+ *
+ * @param node Root of the subtree to rebalance.
+ * @return New root of the subtree.
+ */
+VmArea *vma_rebalance(VmArea *node);
+
+/**
+ * Inserts a VMA into a tree ordered by start address.
+ *
+ * @param root Root of the tree.
+ * @param vma VMA to insert; must not overlap any VMA already in the tree.
+ * @return New root of the tree.
+ */
+VmArea *vma_tree_insert(VmArea *root, VmArea *vma);
+
+/**
+ * Unlinks the VMA starting at the given address from a tree. The node itself is not freed.
+ *
+ * @param root Root of the tree.
+ * @param start Start address of the VMA to unlink.
+ * @return New root of the tree.
+ */
+VmArea *vma_tree_remove(VmArea *root, int start);
+
+/**
+ * Finds the VMA containing an address in O(log n).
+ *
+ * @param root Root of the tree.
+ * @param address Virtual address to look up.
+ * @return The containing VMA, or NULL if the address is unmapped.
+ */
+VmArea *vma_find(VmArea *root, int address);
+
+/**
+ * Finds the lowest VMA that overlaps the range [start, end).
+ *
+ * @param root Root of the tree.
+ * @param start Start of the range.
+ * @param end End of the range (exclusive).
+ * @return The first overlapping VMA, or NULL if the range is unmapped.
+ */
+VmArea *vma_find_overlap(VmArea *root, int start, int end);
+
+/**
+ * Splits a VMA at a page-aligned address inside it.
+ *
+ * @param process Process owning the VMA.
+ * @param vma VMA to split; keeps the lower half.
+ * @param address Split point, strictly inside the VMA.
+ * @return The newly created upper half, or NULL on allocation failure.
+ */
+VmArea *vma_split(Process *process, VmArea *vma, int address);
+
+/**
+ * Allocates and initializes a VMA tree node.
+ *
+ * @param pool Pool the node is allocated from.
+ * @param start Page-aligned start address.
+ * @param end Page-aligned end address (exclusive).
+ * @param prot Combination of VMA_PROT_* bits.
+ * @param flags Combination of VMA_FLAG_* bits.
+ * @param file_id Backing file for file-backed mappings.
+ * @param file_offset Offset into the backing file corresponding to start.
+ * @return The new node, or NULL on allocation failure.
+ */
+VmArea *vma_create(ObjectPool *pool, int start, int end, int prot, int flags, int file_id, int file_offset);
+
+/**
+ * Maps a new region into a process address space.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param process Target process.
+ * @param address Requested start address, or 0 to let the simulator choose one.
+ * @param length Length of the region in bytes; rounded up to whole pages.
+ * @param prot Combination of VMA_PROT_* bits.
+ * @param flags Combination of VMA_FLAG_* bits.
+ * @param file_id Backing file for file-backed mappings.
+ * @param file_offset Page-aligned offset into the backing file.
+ * @return Start address of the mapping, or -1 on failure.
+ */
+int process_mmap(PhysicalMemory *phys_mem, Process *process, int address, int length,
+                 int prot, int flags, int file_id, int file_offset);
+
+/**
+ * Unmaps a range from a process address space and releases its resident frames.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Process list holding the process.
+ * @param process Target process.
+ * @param address Page-aligned start of the range.
+ * @param length Length of the range in bytes; rounded up to whole pages.
+ * @return 1 on success, 0 on invalid arguments or allocation failure.
+ */
+int process_munmap(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address, int length);
+
+/**
+ * Releases the resident frames backing a range of virtual pages and clears their entries,
+ * returning page table chunks left empty.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Process list holding the process.
+ * @param process Target process.
+ * @param start_page First virtual page of the range.
+ * @param end_page Virtual page after the last one in the range.
+ */
+void release_page_range(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int start_page,
+                        int end_page);
+
+/**
+ * Changes the protection of a fully mapped range, splitting VMAs as needed.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param process Target process.
+ * @param address Page-aligned start of the range.
+ * @param length Length of the range in bytes; rounded up to whole pages.
+ * @param prot New combination of VMA_PROT_* bits.
+ * @return 1 on success, 0 if the range is invalid or not fully mapped.
+ */
+int process_mprotect(PhysicalMemory *phys_mem, Process *process, int address, int length, int prot);
+
+/**
+ * Moves the program break of a process, growing or shrinking its heap VMA.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Process list holding the process.
+ * @param process Target process.
+ * @param new_brk Requested program break.
+ * @return The resulting program break, or -1 if the request cannot be satisfied.
+ */
+int process_brk(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int new_brk);
+
+/**
+ * Returns the index of a process within the process list.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Process stored in the list.
+ * @return Index of the process.
+ */
+int process_index(const ProcessList *proc_list, const Process *process);
+
+/**
+ * Takes a slot from the swap area.
+ *
+ * @param swap Pointer to the SwapSpace structure.
+ * @return Slot index, or -1 if swap is full.
+ */
+int allocate_swap_slot(SwapSpace *swap);
+
+/**
+ * Returns a slot to the swap area.
+ *
+ * @param swap Pointer to the SwapSpace structure.
+ * @param slot Slot index to release.
+ */
+void release_swap_slot(SwapSpace *swap, int slot);
+
+/**
+ * Hashes a (file, page) key for the page cache and the file store.
+ *
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ * @return Hash value.
+ */
+unsigned int file_page_hash(int file_id, int file_page);
+
+/**
+ * Computes the page cache hash bucket for a file page.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ * @return Bucket index.
+ */
+int page_cache_bucket(const PhysicalMemory *phys_mem, int file_id, int file_page);
+
+/**
+ * Looks up a file page in the page cache without reading it.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ * @return Frame holding the page, or -1 if it is not cached.
+ */
+int page_cache_lookup(const PhysicalMemory *phys_mem, int file_id, int file_page);
+
+/**
+ * Inserts a freshly filled frame into the page cache.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame holding the page.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ */
+void page_cache_insert(PhysicalMemory *phys_mem, int frame, int file_id, int file_page);
+
+/**
+ * Removes a frame from the page cache hash table.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame to remove.
+ */
+void page_cache_remove(PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Returns the frame caching a file page, reading it and the following readahead window on a miss.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure, used for reclaim.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ * @param window Number of pages to read on a miss, including the requested one.
+ * @return Frame holding the page, or -1 if no frame could be obtained.
+ */
+int page_cache_get(PhysicalMemory *phys_mem, ProcessList *proc_list, int file_id, int file_page, int window);
+
+/**
+ * Looks up the written-back copy of a file page.
+ *
+ * @param store Pointer to the FileStore structure.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ * @return The stored page, or NULL if the page has never been written back.
+ */
+FilePage *file_store_find(const FileStore *store, int file_id, int file_page);
+
+/**
+ * Looks up the written-back copy of a file page, adding an empty one if the page has
+ * never been written back.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ * @return The stored page, or NULL if the file store could not grow.
+ */
+FilePage *file_store_insert(PhysicalMemory *phys_mem, int file_id, int file_page);
+
+/**
+ * Fills a frame with the contents of a backing file page.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame index to fill.
+ * @param file_id Backing file.
+ * @param file_page Page index within the file.
+ */
+void read_file_page(PhysicalMemory *phys_mem, int frame, int file_id, int file_page);
+
+/**
+ * Copies a page cache frame into the file store without charging any I/O time.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Page cache frame to store.
+ * @return 1 on success, 0 if the file store could not grow.
+ */
+int store_file_page(PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Synchronously writes a dirty page cache frame back to its file and marks it clean.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Page cache frame to write back.
+ * @return 1 on success, 0 if the file store could not grow.
+ */
+int write_back_page(PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Marks a frame dirty, updating the global dirty page count.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame that was written.
+ * @return 1 if the frame was clean before, 0 if it was already dirty.
+ */
+int mark_frame_dirty(PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Marks a frame clean, updating the global dirty page count.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Frame whose contents now match its backing store.
+ */
+void mark_frame_clean(PhysicalMemory *phys_mem, int frame);
+
+/**
+ * Charges the cost of a write I/O to the writeback device and, when synchronous,
+ * to the writer as stall time.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param ios Number of I/O requests.
+ * @param pages Number of pages written.
+ * @param synchronous 1 if the writer waits for the I/O to complete.
+ */
+void charge_write_io(PhysicalMemory *phys_mem, int ios, int pages, int synchronous);
+
+/**
+ * Orders writeback items by backing space (swap or file) and then by offset.
+ *
+ * @param a First WritebackItem.
+ * @param b Second WritebackItem.
+ * @return Negative, zero or positive as for qsort.
+ */
+int compare_writeback_items(const void *a, const void *b);
+
+/**
+ * Cleans up to a batch of dirty frames. Anonymous pages are pre-cleaned to swap slots and
+ * page cache pages to their files; the batch is sorted by swap slot or file offset and
+ * contiguous runs are issued as a single I/O.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param max_pages Maximum number of pages to clean.
+ * @param synchronous 1 if the calling writer waits for the batch.
+ * @return Number of pages cleaned.
+ */
+int flush_dirty_pages(PhysicalMemory *phys_mem, int max_pages, int synchronous);
+
+/**
+ * Applies the dirty thresholds after a page is dirtied: wakes the rate-limited background
+ * flusher above the background ratio, and throttles the writer with synchronous writeback
+ * above the dirty ratio.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void balance_dirty_pages(PhysicalMemory *phys_mem);
+
+/**
+ * Allocates a set-associative cache level and empties it.
+ *
+ * @param level Pointer to the CacheLevel structure.
+ * @param size Capacity in bytes.
+ * @param associativity Number of ways per set.
+ * @param latency_ns Hit latency in nanoseconds.
+ * @return 1 on success, 0 if the geometry is invalid or allocation fails.
+ */
+int initialize_cache_level(CacheLevel *level, int size, int associativity, int latency_ns);
+
+/**
+ * Releases the storage of a cache level.
+ *
+ * @param level Pointer to the CacheLevel structure.
+ */
+void free_cache_level(CacheLevel *level);
+
+/**
+ * Sets up the L1/L2/LLC hierarchy with default geometry. The model starts disabled.
+ *
+ * @param caches Pointer to the CacheHierarchy structure.
+ * @param page_size Size of a page in bytes, used to derive the number of LLC page colors.
+ */
+void initialize_cache_hierarchy(CacheHierarchy *caches, int page_size);
+
+/**
+ * Recomputes the number of LLC page colors and resets the per-color counters.
+ *
+ * @param caches Pointer to the CacheHierarchy structure.
+ * @param page_size Size of a page in bytes.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int update_cache_colors(CacheHierarchy *caches, int page_size);
+
+/**
+ * Looks a line up in one cache level and refreshes its LRU position on a hit.
+ *
+ * @param level Pointer to the CacheLevel structure.
+ * @param line Physical line number.
+ * @param stamp Current LRU clock value.
+ * @return Way index within the set on a hit, or -1 on a miss.
+ */
+int cache_level_lookup(CacheLevel *level, long long line, unsigned long long stamp);
+
+/**
+ * Inserts a line into one cache level, evicting the least recently used way of its set.
+ *
+ * @param level Pointer to the CacheLevel structure.
+ * @param line Physical line number.
+ * @param walk_line 1 if the line holds page table entries.
+ * @param stamp Current LRU clock value.
+ * @param victim_walk Receives the page-table flag of the evicted line.
+ * @return The evicted line number, or -1 if an empty way was used.
+ */
+long long cache_level_insert(CacheLevel *level, long long line, int walk_line, unsigned long long stamp,
+                             int *victim_walk);
+
+/**
+ * Removes a line from one cache level if present.
+ *
+ * @param level Pointer to the CacheLevel structure.
+ * @param line Physical line number.
+ * @return 1 if the line was present, 0 otherwise.
+ */
+int cache_level_invalidate(CacheLevel *level, long long line);
+
+/**
+ * Sends a physical address through the L1/L2/LLC hierarchy under the configured inclusion
+ * policy and returns the access latency.
+ *
+ * @param caches Pointer to the CacheHierarchy structure.
+ * @param physical_address Physical byte address.
+ * @param page_shift log2 of the page size, used for page color accounting.
+ * @param walk_reference 1 if the access is a page-table walk reference.
+ * @param memory_latency_ns Latency of the memory tier holding the address, paid on a miss.
+ * @return Latency of the access in nanoseconds.
+ */
+int cache_access(CacheHierarchy *caches, long long physical_address, int page_shift, int walk_reference,
+                 int memory_latency_ns);
+
+/**
+ * Allocates a set-associative TLB.
+ *
+ * @param tlb Pointer to the Tlb structure.
+ * @param entries Total number of entries.
+ * @param associativity Number of ways per set.
+ * @return 1 on success, 0 if the geometry is invalid or allocation fails.
+ */
+int initialize_tlb(Tlb *tlb, int entries, int associativity);
+
+/**
+ * Looks a translation up in the TLB. An entry whose cached frame no longer matches the
+ * page table is treated as a miss, which models a perfect shootdown on every PTE change.
+ *
+ * @param tlb Pointer to the Tlb structure.
+ * @param owner Index of the process in the process list.
+ * @param page Virtual page number.
+ * @param frame Frame currently mapped by the page table.
+ * @return 1 on a hit, 0 on a miss.
+ */
+int tlb_lookup(Tlb *tlb, int owner, int page, int frame);
+
+/**
+ * Installs a translation in the TLB, replacing the least recently used way of its set.
+ *
+ * @param tlb Pointer to the Tlb structure.
+ * @param owner Index of the process in the process list.
+ * @param page Virtual page number.
+ * @param frame Mapped frame.
+ */
+void tlb_insert(Tlb *tlb, int owner, int page, int frame);
+
+/**
+ * Returns the synthetic physical address of the paging-structure entry a walk reads at a
+ * given level. The flat page table is walked as a four-level radix tree (PML4, PDPT, PD,
+ * PT) of WALK_INDEX_BITS per level; the tables live in a kernel region above every memory
+ * tier, one fixed-size window per process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param owner Index of the process in the process list.
+ * @param level Table level (0 = PML4, WALK_LEVELS - 1 = PT).
+ * @param page Virtual page number.
+ * @return Physical address of the entry.
+ */
+long long page_table_entry_address(const PhysicalMemory *phys_mem, int owner, int level, int page);
+
+/**
+ * Allocates one paging-structure cache.
+ *
+ * @param cache Pointer to the PagingStructureCache structure.
+ * @param entries Number of entries (fully associative, LRU).
+ * @return 1 on success, 0 if the size is invalid or allocation fails.
+ */
+int initialize_paging_structure_cache(PagingStructureCache *cache, int entries);
+
+/**
+ * Sets up the PML4, PDPT and PDE caches with default sizes. They start enabled.
+ *
+ * @param walker Pointer to the PageWalker structure.
+ */
+void initialize_page_walker(PageWalker *walker);
+
+/**
+ * Looks up the cached entry covering a virtual address prefix and refreshes its LRU stamp.
+ *
+ * @param cache Pointer to the PagingStructureCache structure.
+ * @param owner Index of the process in the process list.
+ * @param prefix Virtual page number shifted down to the cached level.
+ * @param stamp Current LRU clock value.
+ * @return 1 on a hit, 0 on a miss.
+ */
+int psc_lookup(PagingStructureCache *cache, int owner, int prefix, unsigned long long stamp);
+
+/**
+ * Installs an entry in a paging-structure cache, replacing the least recently used one.
+ *
+ * @param cache Pointer to the PagingStructureCache structure.
+ * @param owner Index of the process in the process list.
+ * @param prefix Virtual page number shifted down to the cached level.
+ * @param stamp Current LRU clock value.
+ */
+void psc_insert(PagingStructureCache *cache, int owner, int prefix, unsigned long long stamp);
+
+/**
+ * Consults the paging-structure caches for a walk and returns the level it can start at.
+ *
+ * @param walker Pointer to the PageWalker structure.
+ * @param owner Index of the process in the process list.
+ * @param page Virtual page number.
+ * @return First table level the walk must read (0 if every cache missed).
+ */
+int psc_walk_start(PageWalker *walker, int owner, int page);
+
+/**
+ * Records the entry read at one walk level in its paging-structure cache.
+ *
+ * @param walker Pointer to the PageWalker structure.
+ * @param owner Index of the process in the process list.
+ * @param page Virtual page number.
+ * @param level Table level that was read.
+ */
+void psc_fill(PageWalker *walker, int owner, int page, int level);
+
+/**
+ * Performs the page walk for a TLB miss. The deepest paging-structure cache hit decides
+ * the level the walk starts at; each remaining level costs one memory reference.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param owner Index of the process in the process list.
+ * @param page Virtual page number.
+ * @return Latency of the walk in nanoseconds.
+ */
+int page_walk(PhysicalMemory *phys_mem, int owner, int page);
+
+/**
+ * Prompts for paging-structure cache settings and reinitializes the caches.
+ *
+ * @param walker Pointer to the PageWalker structure.
+ */
+void configure_page_walker(PageWalker *walker);
+
+/**
+ * Returns the latency of one memory reference, through the cache model when it is enabled.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param physical_address Physical byte address.
+ * @param walk_reference 1 if the access is a page-table walk reference.
+ * @return Latency in nanoseconds.
+ */
+int memory_reference_cost(PhysicalMemory *phys_mem, long long physical_address, int walk_reference);
+
+/**
+ * Displays TLB and cache hierarchy statistics, including per-color LLC behavior.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void view_cache_statistics(const PhysicalMemory *phys_mem);
+
+/**
+ * Prompts for a new geometry for one cache level and reinitializes it.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param index Level index (0 = L1, 1 = L2, 2 = LLC).
+ */
+void configure_cache_level(PhysicalMemory *phys_mem, int index);
+
+/**
+ * Displays free and allocated frames per LLC color and the color partition of each process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void view_color_occupancy(const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Splits the LLC colors into equal, disjoint partitions, one per process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void partition_colors_evenly(const PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Prompts for a contiguous range of LLC colors for a process partition.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param first Receives the first color of the partition.
+ * @param count Receives the number of colors, 0 for all of them.
+ * @return 1 if a valid partition was entered, 0 otherwise.
+ */
+int prompt_color_partition(const PhysicalMemory *phys_mem, int *first, int *count);
+
+/**
+ * Creates a virtual machine whose guest-physical memory is an anonymous mapping in an
+ * existing host process (the VMM), with its own guest memory, processes and combined TLB.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm_list Pointer to the VmList structure.
+ */
+void create_virtual_machine(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list);
+
+/**
+ * Prompts for a VM ID and returns the matching virtual machine.
+ *
+ * @param vm_list Pointer to the VmList structure.
+ * @return Pointer to the VM, or NULL if not found.
+ */
+VirtualMachine *prompt_for_vm(VmList *vm_list);
+
+/**
+ * Performs the guest-dimension half of a two-dimensional page walk. Every guest paging
+ * structure reference is itself a guest-physical address that needs a host walk first.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param vm Pointer to the VirtualMachine structure.
+ * @param vmm_owner Index of the VMM process in the host process list.
+ * @param guest_owner Index of the guest process in the guest process list.
+ * @param page Guest-virtual page number.
+ * @return Latency of the walk in nanoseconds.
+ */
+int nested_walk(PhysicalMemory *host, VirtualMachine *vm, int vmm_owner, int guest_owner, int page);
+
+/**
+ * Translates a guest-virtual address to host-physical through the guest and host page
+ * tables. The combined TLB caches the full translation; on a miss the cost is a 2D walk of
+ * up to WALK_LEVELS * (WALK_LEVELS + 1) + WALK_LEVELS references, reduced by the guest and
+ * host paging-structure caches and by the host TLB on the final guest-physical address.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm Pointer to the VirtualMachine structure.
+ * @param process Guest process issuing the access.
+ * @param address Guest-virtual address.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @param guest_physical_address Receives the guest-physical address on success.
+ * @param host_physical_address Receives the host-physical address on success.
+ * @return ACCESS_OK on success, or an ACCESS_* error code from either layer.
+ */
+int vm_access_memory(PhysicalMemory *host, ProcessList *host_list, VirtualMachine *vm, Process *process,
+                     int address, int access_type, int *guest_physical_address, int *host_physical_address);
+
+/**
+ * Prompts for a guest process and address and performs a nested access.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm Pointer to the VirtualMachine structure.
+ */
+void vm_access_memory_menu(PhysicalMemory *host, ProcessList *host_list, VirtualMachine *vm);
+
+/**
+ * Displays combined TLB and two-dimensional walk statistics for a VM.
+ *
+ * @param vm Pointer to the VirtualMachine structure.
+ */
+void view_vm_statistics(const VirtualMachine *vm);
+
+/**
+ * Grows a VM's balloon: the guest gives up frames (reclaiming its own pages if needed) and
+ * the host releases the memory backing them.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm Pointer to the VirtualMachine structure.
+ * @param pages Number of pages to add to the balloon.
+ * @return Number of pages actually added.
+ */
+int inflate_balloon(PhysicalMemory *host, ProcessList *host_list, VirtualMachine *vm, int pages);
+
+/**
+ * Shrinks a VM's balloon, returning frames to the guest. The host backs them again on the
+ * guest's next touch.
+ *
+ * @param vm Pointer to the VirtualMachine structure.
+ * @param pages Number of pages to remove from the balloon.
+ * @return Number of pages actually removed.
+ */
+int deflate_balloon(VirtualMachine *vm, int pages);
+
+/**
+ * Runs the balloon manager: below the low watermark of free host frames, balloons are
+ * inflated evenly across VMs until the high watermark is restored; above the high
+ * watermark, balloons are deflated a step at a time.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm_list Pointer to the VmList structure.
+ */
+void balance_balloons(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list);
+
+/**
+ * Replays a trace of "<vm_id> <pid> <r|w> <address>" lines against the guests, running the
+ * balloon manager every BALLOON_CHECK_INTERVAL references.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm_list Pointer to the VmList structure.
+ * @param trace Open trace file.
+ * @param result Receives the replay counters.
+ */
+void replay_guest_trace(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list, FILE *trace,
+                        ReplayResult *result);
+
+/**
+ * Displays host commitment, balloon sizes, host savings and guest fault inflation.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param vm_list Pointer to the VmList structure.
+ */
+void view_overcommit_summary(const PhysicalMemory *host, const VmList *vm_list);
+
+/**
+ * Prompts for the overcommit ratio and balloon manager settings.
+ *
+ * @param vm_list Pointer to the VmList structure.
+ */
+void configure_overcommit(VmList *vm_list);
+
+/**
+ * Runs the interactive virtual machine menu.
+ *
+ * @param host Pointer to the host PhysicalMemory structure.
+ * @param host_list Pointer to the host ProcessList structure.
+ * @param vm_list Pointer to the VmList structure.
+ */
+void virtual_machine_menu(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list);
+
+/**
+ * Frees every virtual machine and its guest memory.
+ *
+ * @param vm_list Pointer to the VmList structure.
+ */
+void free_virtual_machines(VmList *vm_list);
+
+/**
+ * Runs the interactive CPU cache, TLB and page coloring configuration menu.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void configure_caches_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Displays per-tier occupancy and traffic together with migration counters.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void view_tier_statistics(const PhysicalMemory *phys_mem);
+
+/**
+ * Runs the interactive memory tiering configuration menu.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void configure_tiering_menu(PhysicalMemory *phys_mem);
+
+/**
+ * Runs the interactive writeback configuration menu.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void configure_writeback_menu(PhysicalMemory *phys_mem);
+
+/**
+ * Clears every page table entry that maps a page cache frame.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param frame Page cache frame to unmap.
+ */
+void unmap_page_cache_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame);
+
+/**
+ * Rewrites the entries of one process that map a page cache frame through the file-backed
+ * VMAs of a subtree. The caller adjusts the resident page count of the process.
+ *
+ * @param process Process whose page table is updated.
+ * @param node Root of the VMA subtree to search.
+ * @param page_shift log2 of the page size.
+ * @param frame Page cache frame to unmap.
+ * @param info Metadata of the frame, identifying the cached file page.
+ * @param replacement Frame the page has moved to, or -1 to unmap it.
+ * @return Number of entries rewritten.
+ */
+int unmap_file_page_in_tree(Process *process, const VmArea *node, int page_shift, int frame,
+                            const FrameInfo *info, int replacement);
+
+/**
+ * Evicts a frame: anonymous pages go to swap, page cache pages are written back if dirty.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param frame Frame to evict.
+ * @return 1 if the frame was freed, 0 if it could not be evicted.
+ */
+int evict_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame);
+
+/**
+ * Moves a page to another frame, carrying its metadata, dirty state and swap cache slot
+ * along and repointing every page table entry that maps it. The source frame is freed.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param source Frame currently holding the page.
+ * @param destination Free frame to move the page to.
+ */
+void migrate_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int source, int destination);
+
+/**
+ * Evicts one frame of the slow tier to swap or the file store, using the tier's own clock.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @return 1 if a frame was freed, 0 otherwise.
+ */
+int reclaim_slow_frame(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Moves a cold DRAM page to the slow tier instead of evicting it, making room in the slow
+ * tier first if it is full.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param frame DRAM frame to demote.
+ * @return 1 if the page was demoted, 0 if the slow tier had no room.
+ */
+int demote_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame);
+
+/**
+ * Samples an access to a slow-tier page. Every sample_interval-th access bumps the page's
+ * hotness; a page that reaches the threshold within TIER_HOTNESS_WINDOW_NS is promoted to
+ * DRAM, subject to the per-millisecond promotion rate limit.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param frame Slow-tier frame that was accessed.
+ * @return Frame holding the page afterwards.
+ */
+int sample_slow_access(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame);
+
+/**
+ * Adds a slow memory tier behind DRAM. Its frames are numbered after the DRAM frames, and
+ * swap space and the page cache hash grow with the frame count. Physical addresses are
+ * ints, so DRAM and the tier together must fit in INT_MAX bytes.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param size Capacity of the tier in bytes.
+ * @param latency_ns Access latency of the tier.
+ * @return 1 on success, 0 if the tier is too large or allocation fails.
+ */
+int add_slow_tier(PhysicalMemory *phys_mem, int size, int latency_ns);
+
+/**
+ * Frees frames with a clock (second chance) sweep over DRAM in which anonymous and page
+ * cache frames compete on equal terms. With a slow tier, victims are demoted rather than
+ * evicted.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param target Number of frames to free.
+ * @return Number of frames actually freed.
+ */
+int reclaim_frames(PhysicalMemory *phys_mem, ProcessList *proc_list, int target);
+
+/**
+ * Allocates a single frame, reclaiming one first if memory is full.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Process the frame is for, or NULL for shared page cache frames.
+ * @param frame Receives the allocated frame index.
+ * @return 1 on success, 0 if nothing could be reclaimed.
+ */
+int obtain_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int *frame);
+
+/**
+ * Copies a swapped-out page into a frame. While swap is less than half full the slot stays
+ * allocated, so the page can be evicted again without a write as long as it remains clean;
+ * otherwise the slot is released and the page becomes dirty.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param frame Destination frame.
+ * @param slot Swap slot holding the page.
+ * @return The retained slot, or -1 if it was released.
+ */
+int swap_in_page(PhysicalMemory *phys_mem, int frame, int slot);
+
+/**
+ * Records a frame as the private anonymous page of a process and maps it.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Owning process.
+ * @param page Virtual page number.
+ * @param frame Frame to install.
+ * @param swap_slot Swap slot holding an identical copy (the page is clean), or -1 if the
+ *                  page has no backing copy and is therefore dirty.
+ * @param prot Protection of the covering VMA, cached in the PTE.
+ * @return 1 on success, or 0 if the page table could not be extended; the frame is then
+ *         left untouched for the caller to release.
+ */
+int install_anonymous_page(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process,
+                            int page, int frame, int swap_slot, int prot);
+
+/**
+ * Resolves a fault on a page: demand-zero, swap-in, page cache mapping or copy-on-write
+ * of a private file page.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Faulting process.
+ * @param vma VMA containing the faulting page.
+ * @param page Virtual page number.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @return ACCESS_OK on success, or ACCESS_OUT_OF_MEMORY.
+ */
+int handle_page_fault(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process,
+                      const VmArea *vma, int page, int access_type);
+
+/**
+ * Translates a virtual address for a read or write, faulting the page in if needed.
+ * Calls the access kernel selected at initialization for the page size and the page
+ * table layout of the process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Accessing process.
+ * @param address Virtual address.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @param physical_address Receives the physical address on success.
+ * @return ACCESS_OK, or one of the ACCESS_* error codes.
+ */
+int access_memory(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                  int access_type, int *physical_address);
+
+/**
+ * Body shared by the access kernels. Inlined into each kernel, so that with a constant
+ * shift and layout the page split, the first page table lookup and the physical address
+ * compile to immediate shifts and masks with no layout branch.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Accessing process.
+ * @param address Virtual address.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @param physical_address Receives the physical address on success.
+ * @param shift log2 of the page size.
+ * @param layout Layout of the process's page table, or PAGE_TABLE_ANY to test it.
+ * @return ACCESS_OK, or one of the ACCESS_* error codes.
+ */
+SPECIALIZE_INLINE int access_memory_with(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process,
+                                         int address, int access_type, int *physical_address, int shift,
+                                         int layout);
+
+/**
+ * Access kernel for page sizes without a specialized kernel, for either layout.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Accessing process.
+ * @param address Virtual address.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @param physical_address Receives the physical address on success.
+ * @return ACCESS_OK, or one of the ACCESS_* error codes.
+ */
+int access_memory_generic(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                          int access_type, int *physical_address);
+
+/**
+ * Translates a batch of virtual addresses of one process for reading, without faulting
+ * pages in or touching the TLB and caches. Addresses whose page is unmapped, swapped out
+ * or unreadable are reported in the fault bitmask and translate to -1; the caller can
+ * take them through access_memory.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param pid Process ID.
+ * @param vaddrs Virtual addresses.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Receives one bit per address, (count + 63) / 64 words.
+ * @return Number of faulting addresses, or -1 if the process does not exist.
+ */
+int translate_batch(const PhysicalMemory *phys_mem, const ProcessList *proc_list, int pid, const int *vaddrs,
+                    int count, int *out_paddrs, uint64_t *fault_mask);
+
+/**
+ * Scalar translation kernel: translates addresses from index first to count one at a
+ * time. Also finishes the tail the vector kernels leave over.
+ *
+ * @param process Translating process.
+ * @param page_shift log2 of the page size.
+ * @param vaddrs Virtual addresses.
+ * @param first First index to translate.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses in the range.
+ */
+int translate_range_scalar(const Process *process, int page_shift, const int *vaddrs, int first, int count,
+                           int *out_paddrs, uint64_t *fault_mask);
+
+/**
+ * Body of the scalar translation kernels, inlined into each so that a constant shift and
+ * layout become immediate shifts and masks and a fixed walk depth.
+ *
+ * @param process Translating process.
+ * @param shift log2 of the page size.
+ * @param layout Layout of the process's page table, or PAGE_TABLE_ANY to test it.
+ * @param vaddrs Virtual addresses.
+ * @param first First index to translate.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses in the range.
+ */
+SPECIALIZE_INLINE int translate_range_with(const Process *process, int shift, int layout, const int *vaddrs,
+                                           int first, int count, int *out_paddrs, uint64_t *fault_mask);
+
+/**
+ * Scalar translation kernel with the TranslateKernel signature.
+ *
+ * @param process Translating process.
+ * @param page_shift log2 of the page size.
+ * @param vaddrs Virtual addresses.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses.
+ */
+int translate_batch_scalar(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                           uint64_t *fault_mask);
+
+#ifdef SIMD_X86
+/**
+ * Body of the AVX2 translation kernels: splits eight addresses at a time into page and
+ * offset with vector shifts and masks and gathers their entries from the page table (two
+ * dependent gathers for the compressed layout). Inlined into each kernel, so a constant
+ * shift becomes an immediate operand and a constant layout drops the layout test.
+ *
+ * @param process Translating process.
+ * @param shift log2 of the page size.
+ * @param layout Layout of the process's page table, or PAGE_TABLE_ANY to test it.
+ * @param vaddrs Virtual addresses.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses.
+ */
+SPECIALIZE_INLINE int translate_avx2_with(const Process *process, int shift, int layout, const int *vaddrs,
+                                          int count, int *out_paddrs, uint64_t *fault_mask);
+
+/**
+ * AVX2 translation kernel for any page size and layout.
+ *
+ * @param process Translating process.
+ * @param page_shift log2 of the page size.
+ * @param vaddrs Virtual addresses.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses.
+ */
+int translate_batch_avx2(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                         uint64_t *fault_mask);
+
+/**
+ * Body of the AVX-512 translation kernels: the AVX2 body widened to sixteen addresses,
+ * with lane validity kept in mask registers.
+ *
+ * @param process Translating process.
+ * @param shift log2 of the page size.
+ * @param layout Layout of the process's page table, or PAGE_TABLE_ANY to test it.
+ * @param vaddrs Virtual addresses.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses.
+ */
+SPECIALIZE_INLINE int translate_avx512_with(const Process *process, int shift, int layout, const int *vaddrs,
+                                            int count, int *out_paddrs, uint64_t *fault_mask);
+
+/**
+ * AVX-512 translation kernel for any page size and layout.
+ *
+ * @param process Translating process.
+ * @param page_shift log2 of the page size.
+ * @param vaddrs Virtual addresses.
+ * @param count Number of addresses.
+ * @param out_paddrs Receives the physical addresses.
+ * @param fault_mask Fault bitmask, cleared by the caller.
+ * @return Number of faulting addresses.
+ */
+int translate_batch_avx512(const Process *process, int page_shift, const int *vaddrs, int count,
+                           int *out_paddrs, uint64_t *fault_mask);
+#endif
+
+/*
+ * Define translation and access kernels specialized for one page size and page table
+ * layout. The page shift and the layout are passed to the inlined bodies as constants, so
+ * splitting an address and rebuilding the physical address compile to immediate shifts
+ * and masks, and the walk is fixed at one level for a flat table and two (directory, then
+ * chunk) for a compressed one.
+ */
+#define DEFINE_TRANSLATE_KERNEL(name, shift, layout)                                                        \
+    int name(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,         \
+             uint64_t *fault_mask)                                                                          \
+    {                                                                                                       \
+        (void)page_shift;                                                                                   \
+        return translate_range_with(process, shift, layout, vaddrs, 0, count, out_paddrs, fault_mask);      \
+    }
+
+#define DEFINE_VECTOR_TRANSLATE_KERNEL(name, isa, features, shift, layout)                                  \
+    __attribute__((target(features))) int name(const Process *process, int page_shift, const int *vaddrs,   \
+                                             int count, int *out_paddrs, uint64_t *fault_mask)              \
+    {                                                                                                       \
+        (void)page_shift;                                                                                   \
+        return translate_##isa##_with(process, shift, layout, vaddrs, count, out_paddrs, fault_mask);       \
+    }
+
+#define DEFINE_ACCESS_KERNEL(name, shift, layout)                                                           \
+    int name(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,               \
+             int access_type, int *physical_address)                                                        \
+    {                                                                                                       \
+        return access_memory_with(phys_mem, proc_list, process, address, access_type, physical_address,     \
+                                  shift, layout);                                                           \
+    }
+
+/**
+ * Scalar translation kernels specialized for 4 KiB, 16 KiB, 64 KiB and 2 MiB pages, for
+ * flat and compressed page tables. Same contract as translate_batch_scalar.
+ */
+int translate_4k_flat(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                      uint64_t *fault_mask);
+int translate_4k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                            int *out_paddrs, uint64_t *fault_mask);
+int translate_16k_flat(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                       uint64_t *fault_mask);
+int translate_16k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                             int *out_paddrs, uint64_t *fault_mask);
+int translate_64k_flat(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                       uint64_t *fault_mask);
+int translate_64k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                             int *out_paddrs, uint64_t *fault_mask);
+int translate_2m_flat(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                      uint64_t *fault_mask);
+int translate_2m_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                            int *out_paddrs, uint64_t *fault_mask);
+
+#ifdef SIMD_X86
+/**
+ * AVX2 and AVX-512 translation kernels specialized for the same page sizes and layouts.
+ * Same contract as translate_batch_avx2 and translate_batch_avx512.
+ */
+int translate_avx2_4k_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                           int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_4k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                 int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_16k_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                            int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_16k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                  int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_64k_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                            int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_64k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                  int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_2m_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                           int *out_paddrs, uint64_t *fault_mask);
+int translate_avx2_2m_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                 int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_4k_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                             int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_4k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                   int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_16k_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                              int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_16k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                    int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_64k_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                              int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_64k_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                    int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_2m_flat(const Process *process, int page_shift, const int *vaddrs, int count,
+                             int *out_paddrs, uint64_t *fault_mask);
+int translate_avx512_2m_compressed(const Process *process, int page_shift, const int *vaddrs, int count,
+                                   int *out_paddrs, uint64_t *fault_mask);
+#endif
+
+/**
+ * Access kernels specialized for the same page sizes and layouts. Same contract as
+ * access_memory.
+ */
+int access_4k_flat(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                   int access_type, int *physical_address);
+int access_4k_compressed(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                         int access_type, int *physical_address);
+int access_16k_flat(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                    int access_type, int *physical_address);
+int access_16k_compressed(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                          int access_type, int *physical_address);
+int access_64k_flat(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                    int access_type, int *physical_address);
+int access_64k_compressed(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                          int access_type, int *physical_address);
+int access_2m_flat(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                   int access_type, int *physical_address);
+int access_2m_compressed(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                         int access_type, int *physical_address);
+
+/**
+ * Selects the translation and access kernels for the page size of a physical memory,
+ * once at initialization. Batch translation uses the widest vector instruction set the
+ * CPU supports, specialized for the page size when one of the fixed sizes is in use;
+ * access_memory uses the access kernels for that size, or the generic ones otherwise.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure, with page_shift set.
+ */
+void select_translate_kernels(PhysicalMemory *phys_mem);
+
+/**
+ * Prompts for a process and an address range and translates it in one batch.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void translate_batch_menu(const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Resets the prefetcher to its defaults (all predictors disabled) and allocates the Markov table.
+ *
+ * @param prefetcher Pointer to the Prefetcher structure.
+ */
+void initialize_prefetcher(Prefetcher *prefetcher);
+
+/**
+ * Brings a non-resident page in ahead of demand and maps it. Only swapped-out anonymous pages
+ * and file-backed pages are prefetched; untouched anonymous pages have nothing to fetch.
+ * I/O time is charged to the prefetcher rather than to the faulting process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Process whose page is prefetched.
+ * @param page Virtual page number.
+ * @return 1 if the page was brought in, 0 otherwise.
+ */
+int prefetch_page(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int page);
+
+/**
+ * Prefetches a run of consecutive pages.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Process whose pages are prefetched.
+ * @param start First virtual page of the run.
+ * @param count Number of pages in the run.
+ */
+void prefetch_range(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int start, int count);
+
+/**
+ * Returns the Markov table slot for a (process, page) pair.
+ *
+ * @param owner Index of the process in the process list.
+ * @param page Virtual page number.
+ * @return Slot index.
+ */
+int markov_slot(int owner, int page);
+
+/**
+ * Fault-time hook: updates the sequential, stride and Markov predictors and issues their prefetches.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Faulting process.
+ * @param page Faulting virtual page.
+ */
+void prefetch_on_fault(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int page);
+
+/**
+ * Hit-time hook: credits a prefetched page on first use and extends the sequential window
+ * asynchronously when the readahead marker is reached.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Accessing process.
+ * @param page Accessed virtual page.
+ */
+void prefetch_on_hit(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int page);
+
+/**
+ * Parses one trace line of the form "<pid> <r|w> <address>".
+ *
+ * @param line Text of the line.
+ * @param pid Receives the process ID.
+ * @param access_type Receives ACCESS_READ or ACCESS_WRITE.
+ * @param address Receives the virtual address.
+ * @return 1 if the line is a reference, 0 if it is blank or a comment, -1 if it is malformed.
+ */
+int parse_trace_line(const char *line, int *pid, int *access_type, int *address);
+
+/**
+ * Replays a single reference of a process, writing the low byte of the address on writes.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Referencing process.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @param address Virtual address.
+ * @param result Counters updated with the outcome of the reference.
+ */
+void replay_process_reference(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int access_type,
+                              int address, ReplayResult *result);
+
+/**
+ * Replays a single reference, writing the low byte of the address on writes.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param pid Referencing process ID.
+ * @param access_type ACCESS_READ or ACCESS_WRITE.
+ * @param address Virtual address.
+ * @param result Counters updated with the outcome of the reference.
+ */
+void replay_reference(PhysicalMemory *phys_mem, ProcessList *proc_list, int pid, int access_type,
+                      int address, ReplayResult *result);
+
+/**
+ * Replays a reference trace against the current simulation state.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param trace Open trace file.
+ * @param result Receives the replay counters.
+ * @param series Time series sampled during the replay, or NULL.
+ */
+void replay_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, ReplayResult *result,
+                  TimeSeries *series);
+
+/**
+ * Replays a reference trace with the references of each process interleaved by the CPU
+ * scheduler instead of in trace order. The trace is split into one stream per process;
+ * the scheduler then runs the process it picks for one slice, charging a context switch
+ * whenever the running process changes. Each replay starts with no process running.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param trace Open trace file.
+ * @param result Receives the replay counters.
+ * @param series Time series sampled during the replay, or NULL.
+ */
+void schedule_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, ReplayResult *result,
+                    TimeSeries *series);
+
+/**
+ * Sets up the scheduler with round-robin and CFS defaults. Scheduling starts disabled.
+ *
+ * @param scheduler Pointer to the Scheduler structure.
+ */
+void initialize_scheduler(Scheduler *scheduler);
+
+/**
+ * Picks the next process to run among those with references left and returns the length
+ * of its slice. Round-robin rotates with a fixed quantum. The fair policy runs the
+ * process with the smallest virtual runtime for a share of the target latency
+ * proportional to its weight, but never less than the minimum granularity.
+ *
+ * @param scheduler Pointer to the Scheduler structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param streams Reference stream of each process.
+ * @param slice Receives the slice length in references.
+ * @return Index of the process to run, or -1 if every stream is exhausted.
+ */
+int pick_next_process(const Scheduler *scheduler, const ProcessList *proc_list, const ReferenceStream *streams,
+                      int *slice);
+
+/**
+ * Switches the CPU to a process. Without ASIDs the TLB and paging-structure caches are
+ * flushed; with ASIDs the process keeps its translations as long as it holds an ASID,
+ * and taking the least recently used ASID from another process flushes only that
+ * process's entries.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param next Index of the process to run.
+ */
+void context_switch(PhysicalMemory *phys_mem, int next);
+
+/**
+ * Invalidates the TLB and paging-structure cache entries of one process.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param owner Index of the process in the process list, or -1 for every process.
+ */
+void flush_translations(PhysicalMemory *phys_mem, int owner);
+
+/**
+ * Prints the context-switch counters and the per-process quantum accounting.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void view_scheduler_statistics(const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Runs the interactive scheduler configuration menu.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void configure_scheduler_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Returns the external fragmentation of DRAM: the share of free frames outside the
+ * largest free run, in permille.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @return Fragmentation in permille.
+ */
+int external_fragmentation_permille(const PhysicalMemory *phys_mem);
+
+/**
+ * Prepares a time series with one column per fixed metric plus one RSS column per
+ * existing process. Each column is stored contiguously.
+ *
+ * @param series Pointer to the TimeSeries.
+ * @param sampling Sampling intervals.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int timeseries_init(TimeSeries *series, const SamplingControl *sampling, const ProcessList *proc_list);
+
+/**
+ * Appends one sample of the memory state to a time series and schedules the next one.
+ * Fragmentation needs a scan of the frames, so it is recomputed only once the replay
+ * has earned TIMESERIES_SCAN_FRAMES_PER_REFERENCE frames of scan budget per reference;
+ * in between, samples repeat the last value. This bounds the sampling overhead
+ * regardless of the interval.
+ *
+ * @param series Pointer to the TimeSeries.
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param references References replayed so far.
+ */
+void timeseries_sample(TimeSeries *series, const PhysicalMemory *phys_mem, const ProcessList *proc_list,
+                       long long references);
+
+/**
+ * Writes a time series as a columnar file: a header, the column names, then each column
+ * as a contiguous array of 64-bit values.
+ *
+ * @param series Pointer to the TimeSeries.
+ * @param proc_list Pointer to the ProcessList structure, used to name RSS columns.
+ * @param path Output file path.
+ * @return 1 on success, 0 on failure.
+ */
+int timeseries_write(const TimeSeries *series, const ProcessList *proc_list, const char *path);
+
+/**
+ * Prints the extremes of a time series: the lowest free frame count and the peak fault,
+ * eviction, swap and fragmentation samples.
+ *
+ * @param series Pointer to the TimeSeries.
+ */
+void print_timeseries_summary(const TimeSeries *series);
+
+/**
+ * Releases the columns of a time series.
+ *
+ * @param series Pointer to the TimeSeries.
+ */
+void timeseries_free(TimeSeries *series);
+
+/**
+ * Runs the interactive time-series sampling configuration menu.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void configure_sampling_menu(PhysicalMemory *phys_mem);
+
+/**
+ * Prints the counters collected by a trace replay.
+ *
+ * @param result Replay counters.
+ */
+void print_replay_result(const ReplayResult *result);
+
+/**
+ * Prompts for a trace file and replays it.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void replay_trace_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Reads every valid reference of a trace into one buffer, in trace order, and counts the
+ * references of each process.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param trace Open trace file.
+ * @param references Receives the buffer; each entry holds the index of its process.
+ * @param count Receives the number of references.
+ * @param process_references Per-process reference counts, incremented while reading.
+ * @param result Counts malformed lines and unknown processes.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int load_trace_references(const ProcessList *proc_list, FILE *trace, ShardReference **references,
+                          long long *count, long long *process_references, ReplayResult *result);
+
+/**
+ * Assigns whole processes to replay workers, largest first, each to the worker with the
+ * fewest references so far. Ties go to the lower PID and the lower worker, so the
+ * assignment depends only on the trace and the worker count.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process_references Number of references of each process.
+ * @param workers Maximum number of workers.
+ * @param owners Receives the worker of each process, or -1 if it has no references.
+ * @param loads Receives the number of references assigned to each worker.
+ * @return Number of workers used: the smaller of workers and processes with references.
+ */
+int assign_replay_shards(const ProcessList *proc_list, const long long *process_references, int workers,
+                         int *owners, long long *loads);
+
+/**
+ * Returns why the host state cannot be copied into replay workers: workers model DRAM
+ * only and replay each process's references in trace order, so a slow memory tier or a
+ * CPU scheduler policy is rejected rather than silently dropped.
+ *
+ * @param phys_mem Host PhysicalMemory structure.
+ * @return Description of the unsupported setting, or NULL if the state can be copied.
+ */
+const char *replay_copy_limitation(const PhysicalMemory *phys_mem);
+
+/**
+ * Looks for a file mapped shared in a memory map that a process on another worker also
+ * maps. Each worker keeps its own copy of the files, so writes through such a mapping
+ * would not be seen by the other worker.
+ *
+ * @param node Root of the VMA subtree to search.
+ * @param proc_list Pointer to the host ProcessList structure.
+ * @param owners Worker of each host process, or -1.
+ * @param owner Worker of the process that owns the tree.
+ * @return The file ID, or -1 if there is none.
+ */
+int find_cross_worker_file(const VmArea *node, const ProcessList *proc_list, const int *owners, int owner);
+
+/**
+ * Returns whether a memory map contains a mapping of a file.
+ *
+ * @param node Root of the VMA subtree to search.
+ * @param file_id File to look for.
+ * @return 1 if the file is mapped, 0 otherwise.
+ */
+int vma_tree_maps_file(const VmArea *node, int file_id);
+
+/**
+ * Returns whether any process of a list maps a file.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param file_id File to look for.
+ * @return 1 if the file is mapped, 0 otherwise.
+ */
+int processes_map_file(const ProcessList *proc_list, int file_id);
+
+/**
+ * Copies the host prefetcher, writeback, cache, TLB, page walker and page color settings
+ * into a replay worker memory. Only the configuration is copied; the worker starts with
+ * cold caches and counters of its own.
+ *
+ * @param memory Worker PhysicalMemory structure.
+ * @param phys_mem Host PhysicalMemory structure.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int copy_memory_config(PhysicalMemory *memory, const PhysicalMemory *phys_mem);
+
+/**
+ * Allocates the RAM shared by a set of replay workers. Every frame of the pool is owned
+ * by at most one worker; the others hold it in their balloon.
+ *
+ * @param pool Pointer to the ReplayPool.
+ * @param number_of_frames Frames in the pool.
+ * @param page_size Size of each frame in bytes.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int initialize_replay_pool(ReplayPool *pool, int number_of_frames, int page_size);
+
+/**
+ * Releases the RAM of a replay pool.
+ *
+ * @param pool Pointer to the ReplayPool.
+ */
+void free_replay_pool(ReplayPool *pool);
+
+/**
+ * Sets up a replay worker: a physical memory over the pool RAM in which the worker owns
+ * the quota frames starting at first_frame and every other frame is ballooned. Only the
+ * frame metadata is private; the worker is seeded by splitting streams and carries the
+ * host prefetcher, writeback and walker settings.
+ *
+ * @param shard Pointer to the ReplayShard.
+ * @param phys_mem Host PhysicalMemory structure.
+ * @param streams Copy of the host random stream that the worker streams are split from.
+ * @param pool RAM shared with the other workers.
+ * @param first_frame First frame owned by the worker.
+ * @param quota Frames owned by the worker.
+ * @param swap_slots Size of the private swap area of the worker in pages.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int initialize_replay_shard(ReplayShard *shard, const PhysicalMemory *phys_mem, RandomState *streams,
+                            ReplayPool *pool, int first_frame, int quota, int swap_slots);
+
+/**
+ * Copies a process into a replay worker: same PID, size, memory map and color partition.
+ * Anonymous pages keep their contents, dirty state and PTE bits. Resident pages stay
+ * resident while the worker has free frames and start out in the worker swap otherwise;
+ * swapped pages, and the swap copies of clean resident pages, get a slot of their own.
+ * Page cache mappings are restored afterwards by copy_files_to_shard.
+ *
+ * @param shard Pointer to the ReplayShard.
+ * @param phys_mem Host PhysicalMemory structure.
+ * @param proc_list Host process list holding the source process.
+ * @param source Process to copy.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int copy_process_to_shard(ReplayShard *shard, const PhysicalMemory *phys_mem, const ProcessList *proc_list,
+                          const Process *source);
+
+/**
+ * Copies the files mapped by the processes of a replay worker: their written-back pages,
+ * as many of their page cache pages as the worker has free frames, and the mappings of
+ * those pages. Dirty page cache pages that do not fit are written to the worker file
+ * store instead, so no change is lost. Called once all the processes are copied.
+ *
+ * @param shard Pointer to the ReplayShard.
+ * @param phys_mem Host PhysicalMemory structure.
+ * @param proc_list Pointer to the host ProcessList structure.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int copy_files_to_shard(ReplayShard *shard, const PhysicalMemory *phys_mem, const ProcessList *proc_list);
+
+/**
+ * Counts the anonymous pages of a process that are resident or swapped out, which bounds
+ * the swap slots that copying the process into a replay worker takes.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param process Process to count.
+ * @return Number of anonymous pages with contents.
+ */
+int count_anonymous_pages(const PhysicalMemory *phys_mem, const Process *process);
+
+/**
+ * Copies a memory map into another tree.
+ *
+ * @param pool Pool the copies are allocated from.
+ * @param node Root of the tree to copy.
+ * @param root Root of the destination tree, updated as areas are inserted.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int copy_vma_tree(ObjectPool *pool, const VmArea *node, VmArea **root);
+
+/**
+ * Inflates or deflates a worker balloon until the worker holds quota_target frames.
+ * Inflating reclaims frames like any other allocation and hands them to the pool;
+ * deflating takes frames from the pool. Runs only while the workers are stopped.
+ *
+ * @param shard Pointer to the ReplayShard.
+ */
+void resize_shard_quota(ReplayShard *shard);
+
+/**
+ * Replays a range of references on a worker.
+ *
+ * @param shard Pointer to the ReplayShard.
+ * @param references References, each holding the index of its process in the worker.
+ * @param start First reference to replay.
+ * @param end One past the last reference to replay.
+ * @param result Counters updated with the outcome of each reference.
+ */
+void replay_shard_range(ReplayShard *shard, const ShardReference *references, long long start, long long end,
+                        ReplayResult *result);
+
+/**
+ * Worker thread body: replays the worker's references up to the end of the epoch.
+ *
+ * @param argument Pointer to the ReplayShard.
+ * @return NULL.
+ */
+void *replay_shard_epoch(void *argument);
+
+/**
+ * Returns whether a worker faulted more often per reference than another during the
+ * last epoch.
+ *
+ * @param shard Worker to compare.
+ * @param other Worker to compare against.
+ * @return 1 if shard has the higher fault rate, 0 otherwise.
+ */
+int shard_faults_more(const ReplayShard *shard, const ReplayShard *other);
+
+/**
+ * Moves frame quota between workers at an epoch barrier. Workers are ranked by their
+ * fault rate in the epoch; the k-th lowest shrinks by 1/PARALLEL_REBALANCE_DIVISOR of
+ * its quota plus one frame if the k-th highest faulted more, and finished workers shrink
+ * to min_quota. Frames released by earlier epochs are granted to the active workers that
+ * fault the most. The plan is computed serially from epoch counters alone.
+ *
+ * @param shards Replay workers.
+ * @param shard_count Number of workers.
+ * @param pool_frames Frames shared by all the workers.
+ * @param min_quota Frames no worker is shrunk below.
+ */
+void rebalance_shard_quotas(ReplayShard *shards, int shard_count, int pool_frames, int min_quota);
+
+/**
+ * Replays a trace on worker threads, one per group of processes. Each worker owns
+ * private copies of its processes with their own page tables, TLB and caches, and a
+ * quota of the frames of one pool the size of the host DRAM. Workers run in epochs of
+ * PARALLEL_EPOCH_REFERENCES references and only touch their own state and frames between
+ * barriers, where quotas are rebalanced by moving frames from donors to the pool and from
+ * the pool to recipients, so the outcome depends only on the seed, the trace and the
+ * worker count. The workers are seeded from a copy of the host random stream, so the
+ * host state is left unchanged. Workers start from a full copy of the host state, so a
+ * replay is refused when a slow memory tier or a CPU scheduler policy is configured, or
+ * when processes on different workers share a file mapping.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param trace Open trace file.
+ * @param workers Maximum number of worker threads.
+ * @param result Receives the combined replay counters; the simulated time is that of the
+ *               slowest worker.
+ */
+void parallel_replay_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, int workers,
+                           ReplayResult *result);
+
+/**
+ * Prints the references, faults and quota movements of each replay worker.
+ *
+ * @param shards Replay workers.
+ * @param shard_count Number of workers.
+ */
+void view_replay_shards(const ReplayShard *shards, int shard_count);
+
+/**
+ * Releases everything owned by a replay worker.
+ *
+ * @param shard Pointer to the ReplayShard.
+ */
+void free_replay_shard(ReplayShard *shard);
+
+/**
+ * Prompts for a trace file and a worker count and replays the trace in parallel.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void parallel_replay_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Orders long long values ascending.
+ *
+ * @param a First value.
+ * @param b Second value.
+ * @return Negative, zero or positive as for qsort.
+ */
+int compare_long_long(const void *a, const void *b);
+
+/**
+ * Lists the resident pages of a memory as sorted keys: the process index and page for
+ * anonymous frames, the file and file page for page cache frames.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param pages Receives the keys; the caller frees them.
+ * @return Number of keys, or -1 on allocation failure.
+ */
+int capture_residency(const PhysicalMemory *phys_mem, long long **pages);
+
+/**
+ * Counts the pages resident in exactly one of two residency lists.
+ *
+ * @param pages Sorted keys of the first list.
+ * @param count Number of keys in the first list.
+ * @param other_pages Sorted keys of the second list.
+ * @param other_count Number of keys in the second list.
+ * @return Size of the symmetric difference.
+ */
+int residency_divergence(const long long *pages, int count, const long long *other_pages, int other_count);
+
+/**
+ * Thread body of one speculative epoch: replays the warm-up prefix to predict the
+ * starting state, records it, then replays and counts the epoch itself.
+ *
+ * @param argument Pointer to the SpeculativeEpoch.
+ * @return NULL.
+ */
+void *speculate_epoch(void *argument);
+
+/**
+ * Resets a speculative worker to a copy of a memory state and its traced process,
+ * reusing the frames of the worker's pool.
+ *
+ * @param worker Pointer to the SpeculativeWorker.
+ * @param phys_mem Pointer to the host PhysicalMemory, whose settings the worker copies.
+ * @param streams Random stream the worker is seeded from; advanced on return.
+ * @param state Memory holding the state to copy, the host's or another worker's.
+ * @param processes Processes of that memory.
+ * @param process_id Traced process, or -1 when the trace references none.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int seed_speculative_worker(SpeculativeWorker *worker, const PhysicalMemory *phys_mem, RandomState *streams,
+                            const PhysicalMemory *state, const ProcessList *processes, int process_id);
+
+/**
+ * Replays a single-process trace as consecutive epochs simulated speculatively in
+ * parallel, for traces too long to replay on one thread. Epochs run in waves of one per
+ * worker, and each worker keeps one memory the size of the host DRAM for the whole
+ * replay. The first epoch of a wave continues from the reconciled state; every other
+ * epoch starts from a copy of it and predicts the state at its first reference by
+ * replaying the warm-up references before it. Epochs are then reconciled in order: an
+ * epoch whose predicted resident set differs from the reconciled end state of the
+ * previous epoch by at most tolerance pages is accepted; otherwise it is replayed again
+ * after the previous epoch on the worker holding the reconciled state. The first epoch
+ * of a wave is never replayed again.
+ *
+ * The reported divergence estimate is a heuristic, not a bound: it is the sum of the
+ * divergences of the accepted epochs, assuming that each page resident in only one of
+ * two states shifts one fault before they converge, as it does under LRU when the states
+ * differ only in which pages they hold. It does not cover states that differ in recency
+ * order alone, nor policies such as FIFO or Clock whose states need not converge, so the
+ * fault counts can be off by more. Even a tolerance of 0 is not exact: the comparison
+ * covers only which pages are resident, not the clock hand, the referenced and dirty
+ * bits, the swap slot assignment or the TLB and paging-structure cache contents, so an
+ * accepted epoch can still fault differently from a serial replay.
+ *
+ * The epochs are seeded from a copy of the host random stream, so the host state is left
+ * unchanged. A replay is refused when a slow memory tier or a CPU scheduler policy is
+ * configured.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param trace Open trace file.
+ * @param epoch_count Number of epochs.
+ * @param workers Maximum number of worker threads.
+ * @param warmup References replayed before each epoch to predict its starting state.
+ * @param tolerance Largest accepted divergence in pages.
+ * @param result Receives the combined replay counters.
+ */
+void speculative_replay_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, int epoch_count,
+                              int workers, long long warmup, int tolerance, ReplayResult *result);
+
+/**
+ * Prompts for a trace file and the speculation parameters and replays the trace.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void speculative_replay_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Runs the interactive prefetcher configuration menu.
+ *
+ * @param prefetcher Pointer to the Prefetcher structure.
+ */
+void configure_prefetcher_menu(Prefetcher *prefetcher);
+
+/**
+ * Parses a protection string such as "rw-" or "r-x" into VMA_PROT_* bits.
+ *
+ * @param text Protection string.
+ * @return The protection bits, or -1 if the string is invalid.
+ */
+int parse_protection(const char *text);
+
+/**
+ * Formats VMA_PROT_* bits as an "rwx" string.
+ *
+ * @param prot Protection bits.
+ * @param buffer Output buffer of at least 4 bytes.
+ */
+void format_protection(int prot, char *buffer);
+
+/**
+ * Prompts for an integer, accepting decimal, octal and hexadecimal notation.
+ *
+ * @param prompt Text to display.
+ * @param value Receives the parsed value.
+ * @return 1 if a value was read, 0 on invalid input.
+ */
+int read_int(const char *prompt, int *value);
+
+/**
+ * Prompts for a process ID and looks the process up.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @return The selected process, or NULL if input was invalid or no such process exists.
+ */
+Process *prompt_for_process(const ProcessList *proc_list);
+
+/**
+ * Prints the VMAs of a process in address order.
+ *
+ * @param node Root of the VMA subtree to print.
+ */
+void print_vma_tree(const VmArea *node);
+
+/**
+ * Displays the memory map (VMAs, heap and resident set) of a process.
+ *
+ * @param proc_list Pointer to the ProcessList structure.
+ * @param process Process to display.
+ */
+void view_memory_map(const ProcessList *proc_list, const Process *process);
+
+/**
+ * Runs the interactive mmap/munmap/mprotect/brk submenu.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void memory_map_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Prompts for a virtual address and performs a read or write through the page table.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void access_memory_menu(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Displays fault, swap, page cache and simulated time statistics.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ */
+void view_statistics(const PhysicalMemory *phys_mem);
+
+/**
+ * Frees all dynamically allocated memory before exiting the program.
+ *
+ * @param phys_mem Pointer to the PhysicalMemory structure.
+ * @param proc_list Pointer to the ProcessList structure.
+ */
+void free_memory(PhysicalMemory *phys_mem, ProcessList *proc_list);
+
+/**
+ * Clears the input buffer to handle invalid inputs.
+ */
+void clear_input_buffer(void);
+
+int main(int argc, char *argv[])
+{
+    CommandLineOptions options = {{MEMORY_BACKING_HEAP, NULL, 0, -1, 0}, NULL, NULL, -1, 0, 0};
+    if (!parse_arguments(argc, argv, &options))
+    {
+        fprintf(stderr,
+                "Usage: %s [--anonymous] [--memory-file PATH] [--huge-pages] [--journal PATH] [--seed N]\n"
+                "       %s --replay-journal PATH [--journal-index N]\n",
+                argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (options.replay_journal_path != NULL)
+    {
+        return replay_journal(options.replay_journal_path, options.replay_index) ? 0 : EXIT_FAILURE;
+    }
+
+    if (!options.seeded)
+    {
+        options.seed = (uint64_t)time(NULL);
+    }
+
+    PhysicalMemory phys_mem;
+    ProcessList proc_list;
+    EventJournal journal;
+    VmList vm_list = {NULL, 0, 0, OVERCOMMIT_DEFAULT_PERCENT, 0, 1, BALLOON_DEFAULT_LOW_WATERMARK,
+                      BALLOON_DEFAULT_HIGH_WATERMARK};
+    int total_memory_size, page_size, max_process_size;
+
+    printf("=== Memory Paging Simulator ===\n\n");
+    printf("Initial Configuration:\n");
+
+    while (1)
+    {
+        printf("Enter the size of physical memory in bytes (power of 2): ");
+        if (scanf("%d", &total_memory_size) != 1)
+        {
+            printf("Invalid input. Please enter a valid integer.\n");
+            clear_input_buffer();
+            continue;
+        }
+        if (!is_power_of_two(total_memory_size))
+        {
+            printf("Error: Size must be a power of 2.\n");
+            continue;
+        }
+        break;
+    }
+
+    while (1)
+    {
+        printf("Enter the size of a page/frame in bytes (power of 2): ");
+        if (scanf("%d", &page_size) != 1)
+        {
+            printf("Invalid input. Please enter a valid integer.\n");
+            clear_input_buffer();
+            continue;
+        }
+        if (!is_power_of_two(page_size))
+        {
+            printf("Error: Page size must be a power of 2.\n");
+            continue;
+        }
+        if (page_size > total_memory_size)
+        {
+            printf("Error: Page size cannot exceed total memory size.\n");
+            continue;
+        }
+        break;
+    }
+
+    while (1)
+    {
+        printf("Enter the maximum size of a process in bytes (power of 2): ");
+        if (scanf("%d", &max_process_size) != 1)
+        {
+            printf("Invalid input. Please enter a valid integer.\n");
+            clear_input_buffer();
+            continue;
+        }
+        if (!is_power_of_two(max_process_size))
+        {
+            printf("Error: Maximum process size must be a power of 2.\n");
+            continue;
+        }
+        if (max_process_size > total_memory_size)
+        {
+            printf("Error: Maximum process size cannot exceed total memory size.\n");
+            continue;
+        }
+        break;
+    }
+
+    initialize_physical_memory(&phys_mem, total_memory_size, page_size, &options.backing);
+    initialize_process_list(&proc_list);
+    random_seed(&phys_mem.random, options.seed);
+    printf("Random Seed: %llu (pass --seed to reproduce this run)\n", (unsigned long long)options.seed);
+    if (options.journal_path != NULL)
+    {
+        if (!journal_open(&journal, options.journal_path, &phys_mem))
+        {
+            fprintf(stderr, "Failed to open the event journal '%s'.\n", options.journal_path);
+            exit(EXIT_FAILURE);
+        }
+        phys_mem.journal = &journal;
+    }
+
+    int choice;
+    while (1)
+    {
+        printf("\n+------------------------------------------+\n");
+        printf("|                MAIN MENU                 |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. View Physical Memory                  |\n");
+        printf("| 2. View Process Page Table               |\n");
+        printf("| 3. Create Process                        |\n");
+        printf("| 4. Memory Map Operations                 |\n");
+        printf("| 5. Access Memory                         |\n");
+        printf("| 6. View Statistics                       |\n");
+        printf("| 7. Replay Reference Trace                |\n");
+        printf("| 8. Configure Prefetcher                  |\n");
+        printf("| 9. Configure Writeback                   |\n");
+        printf("| 10. Configure CPU Caches and TLB         |\n");
+        printf("| 11. Virtual Machines                     |\n");
+        printf("| 12. Configure Memory Tiering             |\n");
+        printf("| 13. Dump Memory State                    |\n");
+        printf("| 14. Configure Time-Series Sampling       |\n");
+        printf("| 15. Configure CPU Scheduler              |\n");
+        printf("| 16. Translate Address Batch              |\n");
+        printf("| 17. Parallel Trace Replay                |\n");
+        printf("| 18. Speculative Trace Replay             |\n");
+        printf("| 19. View Full Frame Map                  |\n");
+        printf("| 0. Exit                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
+        {
+            printf("Invalid input. Please enter a valid option.\n");
+            clear_input_buffer();
+            continue;
+        }
+
+        switch (choice)
+        {
+        case MENU_VIEW_MEMORY:
+            view_physical_memory(&phys_mem, &proc_list);
+            break;
+        case MENU_CREATE_PROCESS:
+            create_process(&phys_mem, &proc_list, max_process_size);
+            break;
+        case MENU_VIEW_PAGE_TABLE:
+            view_page_table(&proc_list);
+            break;
+        case MENU_MEMORY_MAP:
+            memory_map_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_ACCESS_MEMORY:
+            access_memory_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_VIEW_STATISTICS:
+            view_statistics(&phys_mem);
+            break;
+        case MENU_REPLAY_TRACE:
+            replay_trace_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_CONFIGURE_PREFETCHER:
+            configure_prefetcher_menu(&phys_mem.prefetcher);
+            break;
+        case MENU_CONFIGURE_WRITEBACK:
+            configure_writeback_menu(&phys_mem);
+            break;
+        case MENU_CONFIGURE_CACHES:
+            configure_caches_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_VIRTUAL_MACHINES:
+            virtual_machine_menu(&phys_mem, &proc_list, &vm_list);
+            break;
+        case MENU_CONFIGURE_TIERING:
+            configure_tiering_menu(&phys_mem);
+            break;
+        case MENU_DUMP_STATE:
+            dump_memory_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_CONFIGURE_SAMPLING:
+            configure_sampling_menu(&phys_mem);
+            break;
+        case MENU_CONFIGURE_SCHEDULER:
+            configure_scheduler_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_TRANSLATE_BATCH:
+            translate_batch_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_PARALLEL_REPLAY:
+            parallel_replay_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_SPECULATIVE_REPLAY:
+            speculative_replay_menu(&phys_mem, &proc_list);
+            break;
+        case MENU_VIEW_FRAME_MAP:
+            view_frame_map(&phys_mem);
+            break;
+        case MENU_EXIT:
+            printf("Exiting the simulator...\n");
+            if (phys_mem.journal != NULL)
+            {
+                journal_process_exits(&phys_mem, &proc_list);
+            }
+            free_virtual_machines(&vm_list);
+            free_memory(&phys_mem, &proc_list);
+            if (phys_mem.journal != NULL)
+            {
+                long long recorded = journal.recorded;
+                if (!journal_close(&journal))
+                {
+                    printf("Error: Failed to write the event journal.\n");
+                    return EXIT_FAILURE;
+                }
+                printf("Journal: %lld events written to %s.\n", recorded, options.journal_path);
+            }
+            return 0;
+        default:
+            printf("Invalid option. Please select a valid option from the menu.\n");
+        }
+    }
+
+    return 0;
+}
+
+int is_power_of_two(int number)
+{
+    return (number > 0) && ((number & (number - 1)) == 0);
+}
+
+int log2_exact(uint64_t value)
+{
+    assert(value != 0 && (value & (value - 1)) == 0);
+    int shift = 0;
+    while (value > 1)
+    {
+        value >>= 1;
+        shift++;
+    }
+    return shift;
+}
+
+uint64_t pages_for_size(uint64_t size, int page_shift)
+{
+    assert(page_shift >= 0 && page_shift < 64);
+    uint64_t mask = (UINT64_C(1) << page_shift) - 1;
+    return (size >> page_shift) + ((size & mask) != 0);
+}
+
+int align_up(uint64_t value, int shift, uint64_t *aligned)
+{
+    assert(shift >= 0 && shift < 64);
+    uint64_t mask = (UINT64_C(1) << shift) - 1;
+    if (value > UINT64_MAX - mask)
+    {
+        return 0;
+    }
+    *aligned = (value + mask) & ~mask;
+    return 1;
+}
+
+int parse_arguments(int argc, char *argv[], CommandLineOptions *options)
+{
+    MemoryBacking *backing = &options->backing;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--anonymous") == 0)
+        {
+            backing->type = MEMORY_BACKING_ANONYMOUS;
+        }
+        else if (strcmp(argv[i], "--memory-file") == 0 && i + 1 < argc)
+        {
+            backing->type = MEMORY_BACKING_FILE;
+            backing->path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--huge-pages") == 0)
+        {
+            backing->huge_pages = 1;
+        }
+        else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc)
+        {
+            options->journal_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay-journal") == 0 && i + 1 < argc)
+        {
+            options->replay_journal_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            char *end;
+            options->seed = (uint64_t)strtoull(argv[++i], &end, 0);
+            options->seeded = 1;
+            if (*end != '\0')
+            {
+                return 0;
+            }
+        }
+        else if (strcmp(argv[i], "--journal-index") == 0 && i + 1 < argc)
+        {
+            char *end;
+            options->replay_index = strtoll(argv[++i], &end, 10);
+            if (*end != '\0' || options->replay_index < 0)
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    if (backing->huge_pages && backing->type == MEMORY_BACKING_HEAP)
+    {
+        backing->type = MEMORY_BACKING_ANONYMOUS;
+    }
+    return 1;
+}
+
+unsigned char *map_memory_array(MemoryBacking *backing, size_t size)
+{
+    if (backing->type == MEMORY_BACKING_HEAP)
+    {
+        backing->mapped_size = size;
+        return (unsigned char *)calloc(size, sizeof(unsigned char));
+    }
+
+    void *memory = MAP_FAILED;
+    if (backing->type == MEMORY_BACKING_FILE)
+    {
+        if (backing->fd < 0 && (backing->fd = open(backing->path, O_RDWR | O_CREAT, 0644)) < 0)
+        {
+            return NULL;
+        }
+        struct stat file_status;
+        if (fstat(backing->fd, &file_status) != 0 ||
+            ((size_t)file_status.st_size < size && ftruncate(backing->fd, (off_t)size) != 0))
+        {
+            return NULL;
+        }
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, backing->fd, 0);
+        backing->mapped_size = size;
+    }
+    else
+    {
+#ifdef MAP_HUGETLB
+        if (backing->huge_pages)
+        {
+            size_t huge_size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            memory = mmap(NULL, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            backing->mapped_size = huge_size;
+        }
+#endif
+        if (memory == MAP_FAILED)
+        {
+            memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            backing->mapped_size = size;
+        }
+    }
+
+    if (memory == MAP_FAILED)
+    {
+        return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    if (backing->huge_pages)
+    {
+        madvise(memory, backing->mapped_size, MADV_HUGEPAGE);
+    }
+#endif
+    return (unsigned char *)memory;
+}
+
+unsigned char *resize_memory_array(MemoryBacking *backing, unsigned char *memory, size_t old_size, size_t new_size)
+{
+    if (backing->type == MEMORY_BACKING_HEAP)
+    {
+        unsigned char *resized = (unsigned char *)realloc(memory, new_size);
+        if (resized != NULL)
+        {
+            memset(&resized[old_size], 0, new_size - old_size);
+            backing->mapped_size = new_size;
+        }
+        return resized;
+    }
+
+    if (backing->type == MEMORY_BACKING_FILE)
+    {
+        size_t old_mapping = backing->mapped_size;
+        unsigned char *resized = map_memory_array(backing, new_size);
+        if (resized == NULL)
+        {
+            backing->mapped_size = old_mapping;
+            return NULL;
+        }
+        munmap(memory, old_mapping);
+        return resized;
+    }
+
+    MemoryBacking grown = *backing;
+    unsigned char *resized = map_memory_array(&grown, new_size);
+    if (resized == NULL)
+    {
+        return NULL;
+    }
+    memcpy(resized, memory, old_size);
+    munmap(memory, backing->mapped_size);
+    *backing = grown;
+    return resized;
+}
+
+void unmap_memory_array(MemoryBacking *backing, unsigned char *memory)
+{
+    if (backing->type == MEMORY_BACKING_HEAP)
+    {
+        free(memory);
+        return;
+    }
+
+    munmap(memory, backing->mapped_size);
+    if (backing->fd >= 0)
+    {
+        close(backing->fd);
+        backing->fd = -1;
+    }
+}
+
+uint64_t splitmix64_next(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void random_seed(RandomState *random, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        random->state[i] = splitmix64_next(&seed);
+    }
+}
+
+uint64_t random_next(RandomState *random)
+{
+    uint64_t *s = random->state;
+    uint64_t product = s[1] * 5;
+    uint64_t result = ((product << 7) | (product >> 57)) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+
+void random_split(RandomState *parent, RandomState *child)
+{
+    static const uint64_t jump[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL,
+                                     0x39ABDC4529B1661CULL};
+    uint64_t jumped[4] = {0, 0, 0, 0};
+
+    *child = *parent;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (jump[i] & (1ULL << bit))
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    jumped[j] ^= parent->state[j];
+                }
+            }
+            random_next(parent);
+        }
+    }
+    memcpy(parent->state, jumped, sizeof(jumped));
+}
+
+int journal_open(EventJournal *journal, const char *path, const PhysicalMemory *phys_mem)
+{
+    journal->capacity = JOURNAL_RING_EVENTS;
+    journal->events = (JournalEvent *)malloc(journal->capacity * sizeof(JournalEvent));
+    journal->out = fopen(path, "wb");
+    if (journal->events == NULL || journal->out == NULL)
+    {
+        free(journal->events);
+        if (journal->out != NULL)
+        {
+            fclose(journal->out);
+        }
+        return 0;
+    }
+
+    uint32_t header[4] = {JOURNAL_MAGIC, JOURNAL_VERSION, (uint32_t)phys_mem->page_size,
+                          (uint32_t)phys_mem->number_of_frames};
+    atomic_init(&journal->head, 0);
+    atomic_init(&journal->tail, 0);
+    atomic_init(&journal->running, 1);
+    atomic_init(&journal->failed, fwrite(header, sizeof(header), 1, journal->out) != 1);
+    journal->path = path;
+    journal->recorded = 0;
+    journal->full_waits = 0;
+
+    if (pthread_create(&journal->writer, NULL, journal_writer_thread, journal) != 0)
+    {
+        free(journal->events);
+        fclose(journal->out);
+        return 0;
+    }
+    return 1;
+}
+
+void journal_record(PhysicalMemory *phys_mem, int type, int pid, int page, int frame, int value, int extra)
+{
+    EventJournal *journal = phys_mem->journal;
+    if (journal == NULL)
+    {
+        return;
+    }
+
+    size_t head = atomic_load_explicit(&journal->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&journal->tail, memory_order_acquire) == journal->capacity)
+    {
+        journal->full_waits++;
+        sched_yield();
+    }
+
+    JournalEvent *event = &journal->events[head & (journal->capacity - 1)];
+    event->type = (uint32_t)type;
+    event->pid = pid;
+    event->page = page;
+    event->frame = frame;
+    event->value = value;
+    event->extra = extra;
+    event->time_ns = phys_mem->stats.simulated_time_ns;
+    atomic_store_explicit(&journal->head, head + 1, memory_order_release);
+    journal->recorded++;
+}
+
+void journal_process_exits(PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        journal_record(phys_mem, JOURNAL_PROCESS_EXIT, proc_list->process_ids[i], -1, -1,
+                       proc_list->resident_pages[i], 0);
+    }
+}
+
+void *journal_writer_thread(void *argument)
+{
+    EventJournal *journal = (EventJournal *)argument;
+    size_t tail = atomic_load_explicit(&journal->tail, memory_order_relaxed);
+
+    while (1)
+    {
+        /* Read the stop flag before the head: once it is clear, the head is final. */
+        int stopping = !atomic_load(&journal->running);
+        size_t head = atomic_load_explicit(&journal->head, memory_order_acquire);
+        if (head == tail)
+        {
+            if (stopping)
+            {
+                break;
+            }
+            struct timespec idle = {0, JOURNAL_WRITER_IDLE_NS};
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        size_t start = tail & (journal->capacity - 1);
+        size_t batch = head - tail;
+        if (batch > journal->capacity - start)
+        {
+            batch = journal->capacity - start;
+        }
+        if (fwrite(&journal->events[start], sizeof(JournalEvent), batch, journal->out) != batch)
+        {
+            atomic_store(&journal->failed, 1);
+        }
+        tail += batch;
+        atomic_store_explicit(&journal->tail, tail, memory_order_release);
+    }
+    return NULL;
+}
+
+int journal_close(EventJournal *journal)
+{
+    atomic_store(&journal->running, 0);
+    pthread_join(journal->writer, NULL);
+    int written = !atomic_load(&journal->failed);
+    written &= fclose(journal->out) == 0;
+    free(journal->events);
+    journal->events = NULL;
+    return written;
+}
+
+int pid_map_find(const PidMap *map, int pid)
+{
+    if (map->capacity == 0)
+    {
+        return -1;
+    }
+    unsigned int slot = ((unsigned int)pid * 2654435761u) & (unsigned int)(map->capacity - 1);
+    while (map->slots[slot].row >= 0)
+    {
+        if (map->slots[slot].pid == pid)
+        {
+            return map->slots[slot].row;
+        }
+        slot = (slot + 1) & (unsigned int)(map->capacity - 1);
+    }
+    return -1;
+}
+
+int pid_map_reserve(PidMap *map, int count)
+{
+    if (count * 2 <= map->capacity)
+    {
+        return 1;
+    }
+
+    int capacity = map->capacity > 0 ? map->capacity : PID_MAP_INITIAL_CAPACITY;
+    while (count * 2 > capacity)
+    {
+        capacity *= 2;
+    }
+    PidMapSlot *slots = (PidMapSlot *)malloc(capacity * sizeof(PidMapSlot));
+    if (slots == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < capacity; i++)
+    {
+        slots[i].row = -1;
+    }
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->slots[i].row >= 0)
+        {
+            unsigned int slot = ((unsigned int)map->slots[i].pid * 2654435761u) & (unsigned int)(capacity - 1);
+            while (slots[slot].row >= 0)
+            {
+                slot = (slot + 1) & (unsigned int)(capacity - 1);
+            }
+            slots[slot] = map->slots[i];
+        }
+    }
+    free(map->slots);
+    map->slots = slots;
+    map->capacity = capacity;
+    return 1;
+}
+
+int pid_map_insert(PidMap *map, int pid, int row)
+{
+    if (!pid_map_reserve(map, map->count + 1))
+    {
+        return 0;
+    }
+
+    unsigned int slot = ((unsigned int)pid * 2654435761u) & (unsigned int)(map->capacity - 1);
+    while (map->slots[slot].row >= 0 && map->slots[slot].pid != pid)
+    {
+        slot = (slot + 1) & (unsigned int)(map->capacity - 1);
+    }
+    if (map->slots[slot].row < 0)
+    {
+        map->count++;
+    }
+    map->slots[slot].pid = pid;
+    map->slots[slot].row = row;
+    return 1;
+}
+
+const char *journal_event_error(const JournalEvent *event, int number_of_frames, const JournalProcess *owner)
+{
+    int frame_valid = event->frame >= 0 && event->frame < number_of_frames;
+    switch (event->type)
+    {
+    case JOURNAL_PROCESS_CREATE:
+        return owner != NULL && owner->live ? "creates a process that is already live" : NULL;
+    case JOURNAL_PROCESS_EXIT:
+        return owner == NULL || !owner->live ? "ends a process that is not live" : NULL;
+    case JOURNAL_FRAME_ALLOC:
+        if (event->value < FRAME_ANONYMOUS || event->value > FRAME_BALLOON)
+        {
+            return "allocates a frame with an unknown type";
+        }
+        return frame_valid ? NULL : "refers to a frame outside the journal";
+    case JOURNAL_FRAME_FREE:
+    case JOURNAL_EVICTION:
+    case JOURNAL_FAULT:
+        return frame_valid ? NULL : "refers to a frame outside the journal";
+    case JOURNAL_MIGRATION:
+        return frame_valid && event->value >= 0 && event->value < number_of_frames
+                   ? NULL
+                   : "migrates between frames outside the journal";
+    case JOURNAL_TIER_ADDED:
+        return event->value > number_of_frames && event->value < PTE_INDEX_LIMIT ? NULL
+                                                                                 : "has an invalid frame count";
+    default:
+        return "has an unknown type";
+    }
+}
+
+int replay_journal(const char *path, long long index)
+{
+    static const char *state_names[] = {"free", "anonymous", "page cache", "balloon"};
+    FILE *in = fopen(path, "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "Failed to open the event journal '%s'.\n", path);
+        return 0;
+    }
+
+    uint32_t header[4];
+    if (fread(header, sizeof(header), 1, in) != 1 || header[0] != JOURNAL_MAGIC || header[1] != JOURNAL_VERSION)
+    {
+        fprintf(stderr, "'%s' is not an event journal.\n", path);
+        fclose(in);
+        return 0;
+    }
+    if (header[3] == 0 || header[3] >= (uint32_t)PTE_INDEX_LIMIT)
+    {
+        fprintf(stderr, "'%s' has an invalid frame count (%u).\n", path, header[3]);
+        fclose(in);
+        return 0;
+    }
+
+    int number_of_frames = (int)header[3];
+    FrameInfo *frames = (FrameInfo *)calloc(number_of_frames, sizeof(FrameInfo));
+    JournalEvent *block = (JournalEvent *)malloc(JOURNAL_REPLAY_BLOCK * sizeof(JournalEvent));
+    JournalProcess *processes = NULL;
+    PidMap pid_map = {NULL, 0, 0};
+    int process_count = 0, process_capacity = 0, live_processes = 0;
+    long long applied = 0, total = 0, major_faults = 0, minor_faults = 0, evictions = 0, migrations = 0;
+    long long time_ns = 0;
+    int ok = frames != NULL && block != NULL;
+
+    size_t count;
+    while (ok && (count = fread(block, sizeof(JournalEvent), JOURNAL_REPLAY_BLOCK, in)) > 0)
+    {
+        total += (long long)count;
+        for (size_t i = 0; i < count && ok && (index < 0 || applied < index); i++, applied++)
+        {
+            const JournalEvent *event = &block[i];
+            int owner = event->pid >= 0 ? pid_map_find(&pid_map, event->pid) : -1;
+            const char *error = journal_event_error(event, number_of_frames, owner >= 0 ? &processes[owner] : NULL);
+            if (error != NULL)
+            {
+                fprintf(stderr, "Event %lld (type %u, pid %d, frame %d, value %d) %s.\n", applied, event->type,
+                        event->pid, event->frame, event->value, error);
+                ok = 0;
+                break;
+            }
+            time_ns = event->time_ns;
+
+            switch (event->type)
+            {
+            case JOURNAL_PROCESS_CREATE:
+                if (process_count == process_capacity)
+                {
+                    process_capacity = process_capacity > 0 ? process_capacity * 2 : INITIAL_PROCESS_LIST_CAPACITY;
+                    JournalProcess *grown =
+                        (JournalProcess *)realloc(processes, process_capacity * sizeof(JournalProcess));
+                    if (grown == NULL)
+                    {
+                        ok = 0;
+                        break;
+                    }
+                    processes = grown;
+                }
+                processes[process_count].pid = event->pid;
+                processes[process_count].resident = 0;
+                processes[process_count].live = 1;
+                processes[process_count].faults = 0;
+                if (!pid_map_insert(&pid_map, event->pid, process_count))
+                {
+                    ok = 0;
+                    break;
+                }
+                process_count++;
+                live_processes++;
+                break;
+            case JOURNAL_PROCESS_EXIT:
+                processes[owner].live = 0;
+                live_processes--;
+                break;
+            case JOURNAL_FRAME_ALLOC:
+                if (frames[event->frame].type == FRAME_ANONYMOUS && frames[event->frame].owner >= 0)
+                {
+                    processes[frames[event->frame].owner].resident--;
+                }
+                frames[event->frame].type = event->value;
+                frames[event->frame].owner = event->value == FRAME_ANONYMOUS ? owner : -1;
+                frames[event->frame].page = event->page;
+                frames[event->frame].file_id = event->extra;
+                if (event->value == FRAME_ANONYMOUS && owner >= 0)
+                {
+                    processes[owner].resident++;
+                }
+                break;
+            case JOURNAL_FRAME_FREE:
+                if (frames[event->frame].type == FRAME_ANONYMOUS && frames[event->frame].owner >= 0)
+                {
+                    processes[frames[event->frame].owner].resident--;
+                }
+                frames[event->frame].type = FRAME_FREE;
+                frames[event->frame].owner = -1;
+                break;
+            case JOURNAL_FAULT:
+                if (event->value)
+                {
+                    major_faults++;
+                }
+                else
+                {
+                    minor_faults++;
+                }
+                if (owner >= 0)
+                {
+                    processes[owner].faults++;
+                }
+                break;
+            case JOURNAL_EVICTION:
+                evictions++;
+                break;
+            case JOURNAL_MIGRATION:
+                if (frames[event->value].type == FRAME_ANONYMOUS && frames[event->value].owner >= 0)
+                {
+                    processes[frames[event->value].owner].resident--;
+                }
+                frames[event->value] = frames[event->frame];
+                frames[event->frame].type = FRAME_FREE;
+                frames[event->frame].owner = -1;
+                migrations++;
+                break;
+            case JOURNAL_TIER_ADDED:
+            {
+                FrameInfo *grown = (FrameInfo *)realloc(frames, event->value * sizeof(FrameInfo));
+                if (grown == NULL)
+                {
+                    ok = 0;
+                    break;
+                }
+                frames = grown;
+                memset(&frames[number_of_frames], 0, (size_t)(event->value - number_of_frames) * sizeof(FrameInfo));
+                number_of_frames = event->value;
+                break;
+            }
+            }
+        }
+    }
+    if (ok && (ferror(in) || ftell(in) != (long)(sizeof(header) + total * sizeof(JournalEvent))))
+    {
+        fprintf(stderr, "'%s' ends with a truncated event after %lld events.\n", path, total);
+        ok = 0;
+    }
+
+    if (ok)
+    {
+        printf("=== Journal Replay ===\n");
+        printf("Journal: %s\n", path);
+        printf("Page Size: %u bytes\n", header[2]);
+        printf("State after event %lld of %lld (simulated time %lld ns)\n", applied, total, time_ns);
+        printf("Live Processes: %d\n", live_processes);
+        printf("Faults: %lld major, %lld minor\n", major_faults, minor_faults);
+        printf("Evictions: %lld\n", evictions);
+        printf("Migrations: %lld\n", migrations);
+
+        printf("\nProcess\tResident\tFaults\n");
+        for (int p = 0; p < process_count; p++)
+        {
+            printf("%d\t%d\t\t%lld%s\n", processes[p].pid, processes[p].resident, processes[p].faults,
+                   processes[p].live ? "" : "\t(exited)");
+        }
+
+        printf("\nFrame Map (%d frames):\n", number_of_frames);
+        int ranges = 0;
+        for (int first = 0; first < number_of_frames; ranges++)
+        {
+            int last = first;
+            while (last + 1 < number_of_frames && frames[last + 1].type == frames[first].type &&
+                   frames[last + 1].owner == frames[first].owner &&
+                   (frames[first].type != FRAME_PAGE_CACHE || frames[last + 1].file_id == frames[first].file_id))
+            {
+                last++;
+            }
+            if (ranges < FRAME_MAP_MAX_RANGES)
+            {
+                char label[32];
+                snprintf(label, sizeof(label), first == last ? "frame %d" : "frames %d-%d", first, last);
+                printf("  %-24s%s", label, state_names[frames[first].type]);
+                if (frames[first].type == FRAME_ANONYMOUS && frames[first].owner >= 0)
+                {
+                    printf("  pid %d", processes[frames[first].owner].pid);
+                }
+                else if (frames[first].type == FRAME_PAGE_CACHE)
+                {
+                    printf("  file %d", frames[first].file_id);
+                }
+                printf("\n");
+            }
+            first = last + 1;
+        }
+        if (ranges > FRAME_MAP_MAX_RANGES)
+        {
+            printf("  ... %d more ranges\n", ranges - FRAME_MAP_MAX_RANGES);
+        }
+    }
+    else if (frames == NULL || block == NULL)
+    {
+        fprintf(stderr, "Failed to allocate memory for the journal replay.\n");
+    }
+
+    free(frames);
+    free(block);
+    free(processes);
+    free(pid_map.slots);
+    fclose(in);
+    return ok;
+}
+
+void initialize_physical_memory(PhysicalMemory *phys_mem, int total_size, int page_size,
+                                const MemoryBacking *backing)
+{
+    MemoryBacking heap = {MEMORY_BACKING_HEAP, NULL, 0, -1, 0};
+    phys_mem->backing = backing != NULL ? *backing : heap;
+    unsigned char *memory = map_memory_array(&phys_mem->backing, (size_t)total_size);
+    if (memory == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate physical memory.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int frames = (int)pages_for_size((uint64_t)total_size, log2_exact((uint64_t)page_size));
+    if ((long long)frames * SWAP_SIZE_MULTIPLIER >= PTE_INDEX_LIMIT)
+    {
+        fprintf(stderr, "Error: Too many frames for the page table entry format.\n");
+        exit(EXIT_FAILURE);
+    }
+    attach_physical_memory(phys_mem, memory, total_size, page_size, frames * SWAP_SIZE_MULTIPLIER);
+}
+
+void attach_physical_memory(PhysicalMemory *phys_mem, unsigned char *memory, int total_size, int page_size,
+                            int swap_slots)
+{
+    phys_mem->total_size = total_size;
+    phys_mem->page_size = page_size;
+    phys_mem->page_shift = log2_exact((uint64_t)page_size);
+    phys_mem->page_mask = page_size - 1;
+    select_translate_kernels(phys_mem);
+    phys_mem->memory = memory;
+
+    phys_mem->number_of_frames = total_size >> phys_mem->page_shift;
+    phys_mem->free_frames = (int *)malloc(phys_mem->number_of_frames * sizeof(int));
+    if (phys_mem->free_frames == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate free frames list.\n");
+        unmap_memory_array(&phys_mem->backing, phys_mem->memory);
+        exit(EXIT_FAILURE);
+    }
+
+    phys_mem->frames = (FrameInfo *)calloc(phys_mem->number_of_frames, sizeof(FrameInfo));
+    phys_mem->swap.number_of_slots = swap_slots;
+    phys_mem->swap.data = (unsigned char *)malloc((size_t)phys_mem->swap.number_of_slots * page_size);
+    phys_mem->swap.free_slots = (int *)malloc(phys_mem->swap.number_of_slots * sizeof(int));
+    phys_mem->page_cache_bucket_count = phys_mem->number_of_frames;
+    phys_mem->page_cache_buckets = (int *)malloc(phys_mem->page_cache_bucket_count * sizeof(int));
+    phys_mem->file_store.buckets = (FilePage **)calloc(FILE_STORE_BUCKETS, sizeof(FilePage *));
+    if (phys_mem->frames == NULL || phys_mem->swap.data == NULL || phys_mem->swap.free_slots == NULL ||
+        phys_mem->page_cache_buckets == NULL || phys_mem->file_store.buckets == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate frame, swap and page cache metadata.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < phys_mem->number_of_frames; i++)
+    {
+        phys_mem->frames[i].swap_slot = -1;
+    }
+
+    for (int i = 0; i < phys_mem->swap.number_of_slots; i++)
+    {
+        phys_mem->swap.free_slots[i] = phys_mem->swap.number_of_slots - 1 - i;
+    }
+    phys_mem->swap.free_slot_count = phys_mem->swap.number_of_slots;
+
+    for (int i = 0; i < phys_mem->page_cache_bucket_count; i++)
+    {
+        phys_mem->page_cache_buckets[i] = -1;
+    }
+    phys_mem->page_cache_pages = 0;
+    phys_mem->file_store.page_count = 0;
+    initialize_object_pool(&phys_mem->file_store.pages, sizeof(FilePage) + page_size, FILE_PAGE_POOL_BLOCK_OBJECTS);
+    phys_mem->clock_hand = 0;
+    memset(&phys_mem->stats, 0, sizeof(MemoryStats));
+    random_seed(&phys_mem->random, 0);
+    initialize_prefetcher(&phys_mem->prefetcher);
+
+    phys_mem->writeback.background_ratio = WRITEBACK_DEFAULT_BACKGROUND_RATIO;
+    phys_mem->writeback.dirty_ratio = WRITEBACK_DEFAULT_DIRTY_RATIO;
+    phys_mem->writeback.batch_pages = WRITEBACK_DEFAULT_BATCH_PAGES;
+    phys_mem->writeback.interval_ns = WRITEBACK_DEFAULT_INTERVAL_NS;
+    phys_mem->writeback.last_flush_ns = 0;
+    phys_mem->writeback.dirty_pages = 0;
+    phys_mem->writeback.cursor = 0;
+
+    initialize_scheduler(&phys_mem->scheduler);
+
+    phys_mem->sampling.reference_interval = 0;
+    phys_mem->sampling.interval_ns = 0;
+    strcpy(phys_mem->sampling.path, "timeseries.bin");
+
+    initialize_cache_hierarchy(&phys_mem->caches, page_size);
+    if (!initialize_tlb(&phys_mem->tlb, TLB_DEFAULT_ENTRIES, TLB_DEFAULT_ASSOCIATIVITY))
+    {
+        fprintf(stderr, "Error: Unable to allocate the TLB.\n");
+        exit(EXIT_FAILURE);
+    }
+    initialize_page_walker(&phys_mem->walker);
+    phys_mem->guest_mode = 0;
+    phys_mem->journal = NULL;
+
+    TierControl *tiering = &phys_mem->tiering;
+    memset(tiering, 0, sizeof(TierControl));
+    tiering->tier_count = 1;
+    tiering->tiers[TIER_DRAM].number_of_frames = phys_mem->number_of_frames;
+    tiering->tiers[TIER_DRAM].latency_ns = COST_MEMORY_ACCESS_NS;
+    tiering->tiers[TIER_SLOW].latency_ns = TIER_DEFAULT_SLOW_LATENCY_NS;
+    tiering->promotion_rate = TIER_DEFAULT_PROMOTION_RATE;
+    tiering->hotness_threshold = TIER_DEFAULT_HOTNESS_THRESHOLD;
+    tiering->sample_interval = TIER_DEFAULT_SAMPLE_INTERVAL;
+
+    phys_mem->color_allocator.policy = COLOR_POLICY_NONE;
+    phys_mem->color_allocator.free_counts = NULL;
+    phys_mem->color_allocator.partition_overflows = 0;
+    if (!rebuild_color_bins(phys_mem))
+    {
+        fprintf(stderr, "Error: Unable to allocate page color bins.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void initialize_process_list(ProcessList *proc_list)
+{
+    memset(proc_list, 0, sizeof(ProcessList));
+    proc_list->capacity = INITIAL_PROCESS_LIST_CAPACITY;
+    proc_list->processes = (Process *)malloc(proc_list->capacity * sizeof(Process));
+    proc_list->allocator = (ProcessAllocator *)calloc(1, sizeof(ProcessAllocator));
+    if (proc_list->processes == NULL || proc_list->allocator == NULL ||
+        !resize_int_column(&proc_list->process_ids, proc_list->capacity) ||
+        !resize_int_column(&proc_list->resident_pages, proc_list->capacity) ||
+        !resize_int_column(&proc_list->weights, proc_list->capacity) ||
+        !resize_counter_column(&proc_list->vruntimes, proc_list->capacity) ||
+        !resize_counter_column(&proc_list->quanta, proc_list->capacity) ||
+        !resize_counter_column(&proc_list->scheduled_references, proc_list->capacity) ||
+        !resize_counter_column(&proc_list->cpu_time_ns, proc_list->capacity) ||
+        !pid_map_reserve(&proc_list->pid_index, proc_list->capacity))
+    {
+        fprintf(stderr, "Error: Unable to allocate process list.\n");
+        exit(EXIT_FAILURE);
+    }
+    initialize_object_pool(&proc_list->allocator->vma_nodes, sizeof(VmArea), VMA_POOL_BLOCK_OBJECTS);
+    initialize_object_pool(&proc_list->allocator->page_tables.span_nodes, sizeof(PageTableSpan),
+                           PAGE_TABLE_SPAN_POOL_BLOCK_OBJECTS);
+}
+
+int reserve_process_slot(ProcessList *proc_list)
+{
+    if (proc_list->count < proc_list->capacity)
+    {
+        return 1;
+    }
+
+    int capacity = proc_list->capacity * 2;
+    Process *temp = (Process *)realloc(proc_list->processes, capacity * sizeof(Process));
+    if (temp != NULL)
+    {
+        proc_list->processes = temp;
+    }
+    if (temp == NULL || !resize_int_column(&proc_list->process_ids, capacity) ||
+        !resize_int_column(&proc_list->resident_pages, capacity) || !resize_int_column(&proc_list->weights, capacity) ||
+        !resize_counter_column(&proc_list->vruntimes, capacity) ||
+        !resize_counter_column(&proc_list->quanta, capacity) ||
+        !resize_counter_column(&proc_list->scheduled_references, capacity) ||
+        !resize_counter_column(&proc_list->cpu_time_ns, capacity) || !pid_map_reserve(&proc_list->pid_index, capacity))
+    {
+        return 0;
+    }
+    proc_list->capacity = capacity;
+    return 1;
+}
+
+int resize_int_column(int **column, int capacity)
+{
+    int *resized = (int *)realloc(*column, capacity * sizeof(int));
+    if (resized == NULL)
+    {
+        return 0;
+    }
+    *column = resized;
+    return 1;
+}
+
+int resize_counter_column(long long **column, int capacity)
+{
+    long long *resized = (long long *)realloc(*column, capacity * sizeof(long long));
+    if (resized == NULL)
+    {
+        return 0;
+    }
+    *column = resized;
+    return 1;
+}
+
+Process *add_process(ProcessList *proc_list, const Process *process, int resident_pages, int weight)
+{
+    int row = proc_list->count++;
+    proc_list->processes[row] = *process;
+    proc_list->process_ids[row] = process->process_id;
+    proc_list->resident_pages[row] = resident_pages;
+    proc_list->weights[row] = weight;
+    proc_list->vruntimes[row] = 0;
+    proc_list->quanta[row] = 0;
+    proc_list->scheduled_references[row] = 0;
+    proc_list->cpu_time_ns[row] = 0;
+    /* reserve_process_slot sized the index for the whole list, so the insert cannot fail */
+    pid_map_insert(&proc_list->pid_index, process->process_id, row);
+    return &proc_list->processes[row];
+}
+
+int page_table_size_class(size_t entries)
+{
+    int size_class = 0;
+    while (((size_t)1 << size_class) < entries)
+    {
+        size_class++;
+    }
+    return size_class;
+}
+
+void push_page_table_span(PageTableArena *arena, PageTableEntry *entries, size_t count)
+{
+    while (count > 0)
+    {
+        int size_class = page_table_size_class(count + 1) - 1;
+        PageTableSpan *span = (PageTableSpan *)pool_alloc(&arena->span_nodes);
+        if (span == NULL)
+        {
+            return;
+        }
+        span->entries = entries;
+        span->next = arena->free_spans[size_class];
+        arena->free_spans[size_class] = span;
+        arena->free_entries += 1LL << size_class;
+        entries += (size_t)1 << size_class;
+        count -= (size_t)1 << size_class;
+    }
+}
+
+PageTableEntry *allocate_page_table(PageTableArena *arena, int entries)
+{
+    int size_class = page_table_size_class((size_t)entries);
+    size_t capacity = (size_t)1 << size_class;
+    for (int source = size_class; source < PAGE_TABLE_SIZE_CLASSES; source++)
+    {
+        PageTableSpan *span = arena->free_spans[source];
+        if (span != NULL)
+        {
+            PageTableEntry *table = span->entries;
+            arena->free_spans[source] = span->next;
+            arena->free_entries -= 1LL << source;
+            pool_free(&arena->span_nodes, span);
+            push_page_table_span(arena, table + capacity, ((size_t)1 << source) - capacity);
+            return table;
+        }
+    }
+
+    PageTableBlock *block = arena->head;
+    if (block == NULL || block->capacity - block->used < capacity)
+    {
+        size_t block_capacity = capacity > PAGE_TABLE_BLOCK_ENTRIES ? capacity : PAGE_TABLE_BLOCK_ENTRIES;
+        block = (PageTableBlock *)malloc(sizeof(PageTableBlock) + block_capacity * sizeof(PageTableEntry));
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->capacity = block_capacity;
+        block->used = 0;
+        if (arena->head != NULL && block_capacity > PAGE_TABLE_BLOCK_ENTRIES)
+        {
+            block->next = arena->head->next;
+            arena->head->next = block;
+        }
+        else
+        {
+            if (arena->head != NULL)
+            {
+                push_page_table_span(arena, &arena->head->entries[arena->head->used],
+                                     arena->head->capacity - arena->head->used);
+                arena->head->used = arena->head->capacity;
+            }
+            block->next = arena->head;
+            arena->head = block;
+        }
+        arena->reserved_entries += (long long)block_capacity;
+    }
+
+    PageTableEntry *table = &block->entries[block->used];
+    block->used += capacity;
+    return table;
+}
+
+PageTableEntry *grow_page_table(PageTableArena *arena, PageTableEntry *table, int old_entries, int new_entries)
+{
+    size_t old_capacity = (size_t)1 << page_table_size_class((size_t)old_entries);
+    size_t new_capacity = (size_t)1 << page_table_size_class((size_t)new_entries);
+    if (new_capacity == old_capacity)
+    {
+        return table;
+    }
+
+    PageTableBlock *block = arena->head;
+    if (block != NULL && table + old_capacity == &block->entries[block->used] &&
+        block->capacity - block->used >= new_capacity - old_capacity)
+    {
+        block->used += new_capacity - old_capacity;
+        return table;
+    }
+
+    PageTableEntry *grown = allocate_page_table(arena, new_entries);
+    if (grown == NULL)
+    {
+        return NULL;
+    }
+    memcpy(grown, table, (size_t)old_entries * sizeof(PageTableEntry));
+    release_page_table(arena, table, old_entries);
+    return grown;
+}
+
+void release_page_table(PageTableArena *arena, PageTableEntry *table, int entries)
+{
+    size_t capacity = (size_t)1 << page_table_size_class((size_t)entries);
+    PageTableBlock *block = arena->head;
+    if (block != NULL && table + capacity == &block->entries[block->used])
+    {
+        block->used -= capacity;
+        return;
+    }
+    push_page_table_span(arena, table, capacity);
+}
+
+void free_page_table_arena(PageTableArena *arena)
+{
+    PageTableBlock *block = arena->head;
+    while (block != NULL)
+    {
+        PageTableBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    memset(arena->free_spans, 0, sizeof(arena->free_spans));
+    free_object_pool(&arena->span_nodes);
+}
+
+void initialize_object_pool(ObjectPool *pool, size_t object_size, int objects_per_block)
+{
+    pool->object_size = (object_size + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT;
+    pool->objects_per_block = objects_per_block;
+    pool->blocks = NULL;
+    pool->free_list = NULL;
+    pool->next_object = NULL;
+    pool->objects_left = 0;
+    pool->live_objects = 0;
+}
+
+void *pool_alloc(ObjectPool *pool)
+{
+    void *object = pool->free_list;
+    if (object != NULL)
+    {
+        pool->free_list = *(void **)object;
+    }
+    else
+    {
+        if (pool->objects_left == 0)
+        {
+            PoolBlock *block =
+                (PoolBlock *)malloc(POOL_ALIGNMENT + (size_t)pool->objects_per_block * pool->object_size);
+            if (block == NULL)
+            {
+                return NULL;
+            }
+            block->next = pool->blocks;
+            pool->blocks = block;
+            pool->next_object = (unsigned char *)block + POOL_ALIGNMENT;
+            pool->objects_left = pool->objects_per_block;
+        }
+        object = pool->next_object;
+        pool->next_object += pool->object_size;
+        pool->objects_left--;
+    }
+
+    pool->live_objects++;
+    return object;
+}
+
+void pool_free(ObjectPool *pool, void *object)
+{
+    *(void **)object = pool->free_list;
+    pool->free_list = object;
+    pool->live_objects--;
+}
+
+void free_object_pool(ObjectPool *pool)
+{
+    PoolBlock *block = pool->blocks;
+    while (block != NULL)
+    {
+        PoolBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    initialize_object_pool(pool, pool->object_size, pool->objects_per_block);
+}
+
+void push_free_frame(PhysicalMemory *phys_mem, int frame)
+{
+    if (frame_tier(phys_mem, frame) == TIER_SLOW)
+    {
+        MemoryTier *tier = &phys_mem->tiering.tiers[TIER_SLOW];
+        tier->free_frames[tier->free_count++] = frame;
+        return;
+    }
+
+    int color = frame_color(phys_mem, frame);
+    ColorAllocator *allocator = &phys_mem->color_allocator;
+    phys_mem->free_frames[color * allocator->bin_capacity + allocator->free_counts[color]++] = frame;
+    phys_mem->free_frame_count++;
+}
+
+int frame_tier(const PhysicalMemory *phys_mem, int frame)
+{
+    return phys_mem->tiering.tier_count > 1 && frame >= phys_mem->tiering.tiers[TIER_SLOW].first_frame ? TIER_SLOW
+                                                                                                        : TIER_DRAM;
+}
+
+int frame_color(const PhysicalMemory *phys_mem, int frame)
+{
+    return frame % phys_mem->color_allocator.colors;
+}
+
+int rebuild_color_bins(PhysicalMemory *phys_mem)
+{
+    ColorAllocator *allocator = &phys_mem->color_allocator;
+    int dram_frames = phys_mem->tiering.tiers[TIER_DRAM].number_of_frames;
+    int colors = phys_mem->caches.colors;
+    if (colors > dram_frames)
+    {
+        colors = dram_frames;
+    }
+
+    int *free_counts = (int *)calloc(colors, sizeof(int));
+    if (free_counts == NULL)
+    {
+        return 0;
+    }
+
+    free(allocator->free_counts);
+    allocator->free_counts = free_counts;
+    allocator->colors = colors;
+    allocator->bin_capacity = dram_frames / colors;
+    allocator->cursor = 0;
+
+    phys_mem->free_frame_count = 0;
+    for (int i = 0; i < dram_frames; i++)
+    {
+        if (phys_mem->frames[i].type == FRAME_FREE)
+        {
+            int color = frame_color(phys_mem, i);
+            phys_mem->free_frames[color * allocator->bin_capacity + free_counts[color]++] = i;
+            phys_mem->free_frame_count++;
+        }
+    }
+    return 1;
+}
+
+int select_frame_color(PhysicalMemory *phys_mem, Process *process)
+{
+    ColorAllocator *allocator = &phys_mem->color_allocator;
+    int first = 0;
+    int count = allocator->colors;
+    int *cursor = &allocator->cursor;
+
+    if (process != NULL && allocator->policy != COLOR_POLICY_NONE)
+    {
+        cursor = &process->color_cursor;
+        if (allocator->policy == COLOR_POLICY_PARTITION && process->color_count > 0)
+        {
+            first = process->color_first % allocator->colors;
+            count = process->color_count < allocator->colors ? process->color_count : allocator->colors;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        int color = (first + (*cursor + i) % count) % allocator->colors;
+        if (allocator->free_counts[color] > 0)
+        {
+            *cursor = (*cursor + i + 1) % count;
+            return color;
+        }
+    }
+
+    for (int color = 0; color < allocator->colors; color++)
+    {
+        if (allocator->free_counts[color] > 0)
+        {
+            allocator->partition_overflows++;
+            return color;
+        }
+    }
+    return -1;
+}
+
+int allocate_frames(PhysicalMemory *phys_mem, Process *process, int required_frames, int *allocated_frames)
+{
+    ColorAllocator *allocator = &phys_mem->color_allocator;
+    if (phys_mem->free_frame_count < required_frames)
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < required_frames; i++)
+    {
+        int color = select_frame_color(phys_mem, process);
+        allocated_frames[i] = phys_mem->free_frames[color * allocator->bin_capacity + --allocator->free_counts[color]];
+        phys_mem->free_frame_count--;
+    }
+
+    return 1;
+}
+
+void release_frames(PhysicalMemory *phys_mem, const int *frames, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        FrameInfo *info = &phys_mem->frames[frames[i]];
+        if (info->dirty)
+        {
+            mark_frame_clean(phys_mem, frames[i]);
+        }
+        if (info->type == FRAME_ANONYMOUS && info->swap_slot >= 0)
+        {
+            release_swap_slot(&phys_mem->swap, info->swap_slot);
+        }
+        info->type = FRAME_FREE;
+        info->swap_slot = -1;
+        push_free_frame(phys_mem, frames[i]);
+        journal_record(phys_mem, JOURNAL_FRAME_FREE, -1, -1, frames[i], 0, 0);
+    }
+}
+
+void create_process(PhysicalMemory *phys_mem, ProcessList *proc_list, int max_process_size)
+{
+    int pid, size;
+
+    printf("\n=== Create New Process ===\n");
+
+    while (1)
+    {
+        printf("Enter Process ID (integer): ");
+        if (scanf("%d", &pid) != 1)
+        {
+            printf("Invalid input. Please enter a valid integer.\n");
+            clear_input_buffer();
+            continue;
+        }
+
+        if (find_process(proc_list, pid) != NULL)
+        {
+            printf("Error: Process ID must be unique. Please enter a different ID.\n");
+            continue;
+        }
+        break;
+    }
+
+    while (1)
+    {
+        printf("Enter Process Size in bytes (power of 2, max %d): ", max_process_size);
+        if (scanf("%d", &size) != 1)
+        {
+            printf("Invalid input. Please enter a valid integer.\n");
+            clear_input_buffer();
+            continue;
+        }
+
+        if (!is_power_of_two(size))
+        {
+            printf("Error: Process size must be a power of 2.\n");
+            continue;
+        }
+
+        if (size > max_process_size)
+        {
+            printf("Error: Process size exceeds the maximum allowed size of %d bytes.\n", max_process_size);
+            continue;
+        }
+
+        break;
+    }
+
+    Process new_process;
+    new_process.color_first = 0;
+    new_process.color_count = 0;
+    new_process.color_cursor = 0;
+    if (phys_mem->color_allocator.policy == COLOR_POLICY_PARTITION)
+    {
+        printf("Colors 0-%d are available for this process's partition.\n", phys_mem->color_allocator.colors - 1);
+        while (!prompt_color_partition(phys_mem, &new_process.color_first, &new_process.color_count))
+            ;
+    }
+
+    int pages_needed = (int)pages_for_size((uint64_t)size, phys_mem->page_shift);
+
+    if (!reserve_process_slot(proc_list))
+    {
+        printf("Error: Unable to expand the process list.\n");
+        return;
+    }
+
+    ProcessAllocator *allocator = proc_list->allocator;
+    PageTableEntry *page_table = allocate_page_table(&allocator->page_tables, pages_needed);
+    if (page_table == NULL)
+    {
+        printf("Error: Unable to allocate the process page table.\n");
+        return;
+    }
+
+    if (phys_mem->free_frame_count < pages_needed)
+    {
+        reclaim_frames(phys_mem, proc_list, pages_needed - phys_mem->free_frame_count);
+    }
+
+    if (phys_mem->free_frame_count < pages_needed)
+    {
+        printf("Error: Insufficient physical memory to allocate the process.\n");
+        release_page_table(&allocator->page_tables, page_table, pages_needed);
+        return;
+    }
+
+    VmArea *image = vma_create(&allocator->vma_nodes, 0, pages_needed * phys_mem->page_size,
+                               VMA_PROT_READ | VMA_PROT_WRITE | VMA_PROT_EXEC, 0, 0, 0);
+    if (image == NULL)
+    {
+        printf("Error: Unable to allocate the process memory map.\n");
+        release_page_table(&allocator->page_tables, page_table, pages_needed);
+        return;
+    }
+
+    for (int i = 0; i < pages_needed; i++)
+    {
+        int frame;
+        if (!allocate_frames(phys_mem, &new_process, 1, &frame))
+        {
+            printf("Error: Insufficient physical memory to allocate the process.\n");
+            for (int k = 0; k < i; k++)
+            {
+                int allocated = PTE_FRAME(page_table[k]);
+                release_frames(phys_mem, &allocated, 1);
+            }
+            pool_free(&allocator->vma_nodes, image);
+            release_page_table(&allocator->page_tables, page_table, pages_needed);
+            return;
+        }
+        page_table[i] = PTE_MAKE_PRESENT(frame, image->prot) | PTE_ACCESSED;
+
+        unsigned char *frame_data = &phys_mem->memory[frame * phys_mem->page_size];
+        int length = size - i * phys_mem->page_size < phys_mem->page_size ? size - i * phys_mem->page_size
+                                                                          : phys_mem->page_size;
+        for (int j = 0; j < length; j += (int)sizeof(uint64_t))
+        {
+            uint64_t bytes = random_next(&phys_mem->random);
+            size_t chunk = length - j < (int)sizeof(uint64_t) ? (size_t)(length - j) : sizeof(uint64_t);
+            memcpy(&frame_data[j], &bytes, chunk);
+        }
+    }
+
+    new_process.process_id = pid;
+    new_process.process_size = size;
+    new_process.number_of_pages = pages_needed;
+    new_process.page_table = page_table;
+    new_process.pte_directory = NULL;
+    new_process.pte_chunks = 0;
+    new_process.pte_chunk_capacity = 0;
+    new_process.allocator = allocator;
+    new_process.vma_root = image;
+    new_process.vma_count = 1;
+    new_process.heap_start = image->end;
+    new_process.brk = image->end;
+    new_process.mmap_base = page_align_up(phys_mem, (long long)image->end + max_process_size);
+    if (new_process.mmap_base < 0 || new_process.mmap_base >= address_space_limit(phys_mem))
+    {
+        new_process.mmap_base = image->end;
+    }
+    new_process.page_faults = 0;
+    new_process.last_fault_page = -1;
+    new_process.stride = 0;
+    new_process.stride_confidence = 0;
+    new_process.readahead_window = 0;
+    new_process.readahead_end = -1;
+    new_process.readahead_marker = -1;
+
+    journal_record(phys_mem, JOURNAL_PROCESS_CREATE, pid, -1, -1, size, pages_needed);
+    for (int i = 0; i < pages_needed; i++)
+    {
+        int frame = PTE_FRAME(page_table[i]);
+        FrameInfo *info = &phys_mem->frames[frame];
+        journal_record(phys_mem, JOURNAL_FRAME_ALLOC, pid, i, frame, FRAME_ANONYMOUS, -1);
+        info->type = FRAME_ANONYMOUS;
+        info->owner = proc_list->count;
+        info->page = i;
+        info->referenced = 0;
+        info->pinned = 0;
+        info->prefetched = 0;
+        info->swap_slot = -1;
+    }
+
+    add_process(proc_list, &new_process, pages_needed, SCHED_NICE_0_WEIGHT);
+
+    printf("Process created successfully!\n");
+    printf("Process ID: %d\n", pid);
+    printf("Process Size: %d bytes\n", size);
+    printf("Number of Pages: %d\n", pages_needed);
+}
+
+void view_physical_memory(const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    printf("\n=== Physical Memory Status ===\n");
+    printf("Total Physical Memory: %d bytes\n", phys_mem->total_size);
+    printf("Page Size: %d bytes\n", phys_mem->page_size);
+    printf("Total Number of Frames: %d\n", phys_mem->number_of_frames);
+    printf("Free Frames: %d (%.2f%%)\n",
+           phys_mem->free_frame_count,
+           ((double)phys_mem->free_frame_count / phys_mem->tiering.tiers[TIER_DRAM].number_of_frames) * 100.0);
+    if (phys_mem->tiering.tier_count > 1)
+    {
+        printf("Slow Tier: frames %d-%d, %d free\n", phys_mem->tiering.tiers[TIER_SLOW].first_frame,
+               phys_mem->number_of_frames - 1, phys_mem->tiering.tiers[TIER_SLOW].free_count);
+    }
+
+    view_frame_map_summary(phys_mem, proc_list);
+}
+
+void summarize_free_runs(const PhysicalMemory *phys_mem, int frame_count, FreeRunSummary *summary)
+{
+    int run = 0;
+    summary->free_frames = 0;
+    summary->free_ranges = 0;
+    summary->largest_free = 0;
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        if (phys_mem->frames[frame].type != FRAME_FREE)
+        {
+            run = 0;
+            continue;
+        }
+        if (run > 0 && frame_tier(phys_mem, frame) != frame_tier(phys_mem, frame - 1))
+        {
+            run = 0;
+        }
+        if (run++ == 0)
+        {
+            summary->free_ranges++;
+        }
+        summary->free_frames++;
+        if (run > summary->largest_free)
+        {
+            summary->largest_free = run;
+        }
+    }
+}
+
+int free_run_fragmentation_permille(const FreeRunSummary *summary)
+{
+    return summary->free_frames > 0
+               ? (int)((long long)(summary->free_frames - summary->largest_free) * 1000 / summary->free_frames)
+               : 0;
+}
+
+void view_frame_map(const PhysicalMemory *phys_mem)
+{
+    printf("\n=== Frame Map ===\n");
+    fflush(stdout);
+
+    BufferedWriter writer;
+    if (!writer_open(&writer, stdout))
+    {
+        printf("Error: Unable to allocate the output buffer.\n");
+        return;
+    }
+    for (int first = 0, index = 0; first < phys_mem->number_of_frames; index++)
+    {
+        int last = frame_run_end(phys_mem, first);
+        write_frame_run(&writer, DUMP_FORMAT_TEXT, first, last, frame_state(phys_mem, first), index);
+        first = last + 1;
+    }
+    writer_close(&writer);
+}
+
+void view_frame_map_summary(const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    static const char *state_names[] = {"free", "anonymous", "page cache", "balloon"};
+    int cells = phys_mem->number_of_frames < FRAME_MAP_STRIP_WIDTH ? phys_mem->number_of_frames
+                                                                   : FRAME_MAP_STRIP_WIDTH;
+    int cell_frames[FRAME_MAP_STRIP_WIDTH] = {0};
+    int cell_free[FRAME_MAP_STRIP_WIDTH] = {0};
+    int cell_free_runs[FRAME_MAP_STRIP_WIDTH] = {0};
+    FreeRunSummary free_runs = {0};
+    int free_run = 0;
+    int ranges = 0;
+    int run_first = 0;
+
+    printf("\nFrame Map:\n");
+    for (int frame = 0; frame <= phys_mem->number_of_frames; frame++)
+    {
+        int ends_run = frame == phys_mem->number_of_frames;
+        if (!ends_run && frame > run_first)
+        {
+            const FrameInfo *info = &phys_mem->frames[frame];
+            const FrameInfo *first_info = &phys_mem->frames[run_first];
+            ends_run = frame_state(phys_mem, frame) != frame_state(phys_mem, run_first) ||
+                       (info->type == FRAME_ANONYMOUS && info->owner != first_info->owner) ||
+                       (info->type == FRAME_PAGE_CACHE && info->file_id != first_info->file_id);
+        }
+        if (ends_run)
+        {
+            const FrameInfo *first_info = &phys_mem->frames[run_first];
+            int state = frame_state(phys_mem, run_first);
+            int last = frame - 1;
+            if (ranges < FRAME_MAP_MAX_RANGES)
+            {
+                char label[32];
+                char owner[32] = "";
+                snprintf(label, sizeof(label), run_first == last ? "frame %d" : "frames %d-%d", run_first, last);
+                if (first_info->type == FRAME_ANONYMOUS && first_info->owner >= 0 &&
+                    first_info->owner < proc_list->count)
+                {
+                    snprintf(owner, sizeof(owner), "pid %d", proc_list->process_ids[first_info->owner]);
+                }
+                else if (first_info->type == FRAME_PAGE_CACHE)
+                {
+                    snprintf(owner, sizeof(owner), "file %d", first_info->file_id);
+                }
+                printf(owner[0] != '\0' ? "  %-24s%-12s%s%s\n" : "  %-24s%s%s%s\n", label,
+                       state_names[state % FRAME_STATE_SLOW_TIER], owner,
+                       state >= FRAME_STATE_SLOW_TIER ? " (slow tier)" : "");
+            }
+            ranges++;
+            run_first = frame;
+        }
+        if (frame == phys_mem->number_of_frames)
+        {
+            break;
+        }
+
+        int cell = (int)((long long)frame * cells / phys_mem->number_of_frames);
+        cell_frames[cell]++;
+        if (phys_mem->frames[frame].type != FRAME_FREE)
+        {
+            free_run = 0;
+        }
+        else
+        {
+            if (free_run > 0 && frame_tier(phys_mem, frame) != frame_tier(phys_mem, frame - 1))
+            {
+                free_run = 0;
+            }
+            if (free_run++ == 0)
+            {
+                free_runs.free_ranges++;
+            }
+            free_runs.free_frames++;
+            if (free_run > free_runs.largest_free)
+            {
+                free_runs.largest_free = free_run;
+            }
+
+            cell_free[cell]++;
+            if (frame == 0 || phys_mem->frames[frame - 1].type != FRAME_FREE ||
+                (int)((long long)(frame - 1) * cells / phys_mem->number_of_frames) != cell)
+            {
+                cell_free_runs[cell]++;
+            }
+        }
+    }
+    if (ranges > FRAME_MAP_MAX_RANGES)
+    {
+        printf("  ... %d more ranges (use View Full Frame Map for every range)\n", ranges - FRAME_MAP_MAX_RANGES);
+    }
+
+    printf("\nRanges: %d\n", ranges);
+    printf("Free Ranges: %d\n", free_runs.free_ranges);
+    printf("Largest Free Range: %d frames\n", free_runs.largest_free);
+    printf("External Fragmentation: %.1f%%\n", free_run_fragmentation_permille(&free_runs) / 10.0);
+
+    char occupancy[FRAME_MAP_STRIP_WIDTH + 1];
+    char fragmentation[FRAME_MAP_STRIP_WIDTH + 1];
+    int occupancy_levels = (int)strlen(OCCUPANCY_RAMP) - 1;
+    int fragmentation_levels = (int)strlen(FRAGMENTATION_RAMP) - 1;
+    for (int cell = 0; cell < cells; cell++)
+    {
+        int used = cell_frames[cell] - cell_free[cell];
+        occupancy[cell] = OCCUPANCY_RAMP[(used * occupancy_levels + cell_frames[cell] - 1) / cell_frames[cell]];
+        if (cell_free[cell] == 0)
+        {
+            fragmentation[cell] = ' ';
+        }
+        else if (cell_free[cell] == 1)
+        {
+            fragmentation[cell] = FRAGMENTATION_RAMP[0];
+        }
+        else
+        {
+            fragmentation[cell] =
+                FRAGMENTATION_RAMP[(cell_free_runs[cell] - 1) * fragmentation_levels / (cell_free[cell] - 1)];
+        }
+    }
+    occupancy[cells] = '\0';
+    fragmentation[cells] = '\0';
+
+    printf("\nHeat Strip (%d cells, about %d frames each):\n", cells,
+           (phys_mem->number_of_frames + cells - 1) / cells);
+    printf("Occupancy     [%s]  ' ' free .. '@' full\n", occupancy);
+    printf("Fragmentation [%s]  '.' contiguous .. '@' scattered\n", fragmentation);
+}
+
+void view_page_table(const ProcessList *proc_list)
+{
+    if (proc_list->count == 0)
+    {
+        printf("\nNo processes available to display.\n");
+        return;
+    }
+
+    int pid;
+    printf("\n=== View Process Page Table ===\n");
+    printf("Enter Process ID: ");
+    if (scanf("%d", &pid) != 1)
+    {
+        printf("Invalid input. Please enter a valid integer.\n");
+        clear_input_buffer();
+        return;
+    }
+
+    Process *target_process = find_process(proc_list, pid);
+    if (target_process == NULL)
+    {
+        printf("Error: Process with ID %d not found.\n", pid);
+        return;
+    }
+
+    printf("\nPage Table for Process ID %d:\n", pid);
+    printf("Process Size: %d bytes\n", target_process->process_size);
+    printf("Number of Pages: %d\n", target_process->number_of_pages);
+    printf("Resident Pages: %d\n", proc_list->resident_pages[process_index(proc_list, target_process)]);
+    if (target_process->pte_directory != NULL)
+    {
+        printf("Layout: compressed, %d of %d chunks populated\n", target_process->pte_chunks,
+               (target_process->number_of_pages + PTE_CHUNK_ENTRIES - 1) / PTE_CHUNK_ENTRIES);
+    }
+    else
+    {
+        printf("Layout: flat\n");
+    }
+    fflush(stdout);
+
+    BufferedWriter writer;
+    if (!writer_open(&writer, stdout))
+    {
+        printf("Error: Unable to allocate the output buffer.\n");
+        return;
+    }
+    int index = 0;
+    for (int first = next_mapped_page(target_process, 0); first < target_process->number_of_pages;
+         first = next_mapped_page(target_process, first))
+    {
+        int last = page_run_end(target_process, first);
+        write_page_run(&writer, DUMP_FORMAT_TEXT, pid, first, last, pte_get(target_process, first), index++);
+        first = last + 1;
+    }
+    writer_close(&writer);
+}
+
+int writer_open(BufferedWriter *writer, FILE *out)
+{
+    writer->out = out;
+    writer->used = 0;
+    writer->capacity = WRITER_BUFFER_SIZE;
+    writer->failed = 0;
+    writer->data = (char *)malloc(writer->capacity);
+    return writer->data != NULL;
+}
+
+void writer_bytes(BufferedWriter *writer, const void *bytes, size_t length)
+{
+    if (writer->used + length > writer->capacity)
+    {
+        writer_flush(writer);
+        if (length > writer->capacity)
+        {
+            writer->failed |= fwrite(bytes, 1, length, writer->out) != length;
+            return;
+        }
+    }
+    memcpy(&writer->data[writer->used], bytes, length);
+    writer->used += length;
+}
+
+void writer_string(BufferedWriter *writer, const char *text)
+{
+    writer_bytes(writer, text, strlen(text));
+}
+
+void writer_int(BufferedWriter *writer, long long value)
+{
+    char digits[24];
+    int length = sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do
+    {
+        digits[--length] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+    {
+        digits[--length] = '-';
+    }
+    writer_bytes(writer, &digits[length], sizeof(digits) - length);
+}
+
+void writer_u32(BufferedWriter *writer, uint32_t value)
+{
+    writer_bytes(writer, &value, sizeof(value));
+}
+
+void writer_flush(BufferedWriter *writer)
+{
+    if (writer->used > 0)
+    {
+        writer->failed |= fwrite(writer->data, 1, writer->used, writer->out) != writer->used;
+        writer->used = 0;
+    }
+}
+
+int writer_close(BufferedWriter *writer)
+{
+    writer_flush(writer);
+    writer->failed |= fflush(writer->out) != 0;
+    free(writer->data);
+    writer->data = NULL;
+    return !writer->failed;
+}
+
+int frame_state(const PhysicalMemory *phys_mem, int frame)
+{
+    return phys_mem->frames[frame].type + (frame_tier(phys_mem, frame) == TIER_SLOW ? FRAME_STATE_SLOW_TIER : 0);
+}
+
+int frame_run_end(const PhysicalMemory *phys_mem, int first)
+{
+    int state = frame_state(phys_mem, first);
+    int last = first;
+    while (last + 1 < phys_mem->number_of_frames && frame_state(phys_mem, last + 1) == state)
+    {
+        last++;
+    }
+    return last;
+}
+
+int next_mapped_page(const Process *process, int page)
+{
+    while (page < process->number_of_pages)
+    {
+        if (process->pte_directory != NULL && process->pte_directory[page / PTE_CHUNK_ENTRIES] == 0)
+        {
+            page = (page / PTE_CHUNK_ENTRIES + 1) * PTE_CHUNK_ENTRIES;
+            continue;
+        }
+        if (pte_get(process, page) != PTE_NOT_PRESENT)
+        {
+            return page;
+        }
+        page++;
+    }
+    return process->number_of_pages;
+}
+
+int page_run_end(const Process *process, int first)
+{
+    PageTableEntry expected = pte_get(process, first);
+    int last = first;
+    while (last + 1 < process->number_of_pages)
+    {
+        expected += 1u << PTE_INDEX_SHIFT;
+        if (pte_get(process, last + 1) != expected)
+        {
+            break;
+        }
+        last++;
+    }
+    return last;
+}
+
+void write_frame_run(BufferedWriter *writer, int format, int first, int last, int state, int index)
+{
+    static const char *state_names[] = {"free", "anonymous", "page cache", "balloon"};
+    const char *name = state_names[state % FRAME_STATE_SLOW_TIER];
+    const char *tier = state >= FRAME_STATE_SLOW_TIER ? "slow" : "dram";
+
+    switch (format)
+    {
+    case DUMP_FORMAT_TEXT:
+        writer_string(writer, first == last ? "frame " : "frames ");
+        writer_int(writer, first);
+        if (first != last)
+        {
+            writer_string(writer, "-");
+            writer_int(writer, last);
+        }
+        writer_string(writer, " ");
+        writer_string(writer, name);
+        writer_string(writer, state >= FRAME_STATE_SLOW_TIER ? " (slow tier)\n" : "\n");
+        break;
+    case DUMP_FORMAT_JSON:
+        writer_string(writer, index > 0 ? ",{\"first\":" : "{\"first\":");
+        writer_int(writer, first);
+        writer_string(writer, ",\"last\":");
+        writer_int(writer, last);
+        writer_string(writer, ",\"state\":\"");
+        writer_string(writer, name);
+        writer_string(writer, "\",\"tier\":\"");
+        writer_string(writer, tier);
+        writer_string(writer, "\"}");
+        break;
+    case DUMP_FORMAT_CSV:
+        writer_string(writer, "frames,,");
+        writer_int(writer, first);
+        writer_string(writer, ",");
+        writer_int(writer, last);
+        writer_string(writer, ",,");
+        writer_string(writer, name);
+        writer_string(writer, ",");
+        writer_string(writer, tier);
+        writer_string(writer, "\n");
+        break;
+    default:
+        writer_u32(writer, (uint32_t)first);
+        writer_u32(writer, (uint32_t)last);
+        writer_u32(writer, (uint32_t)state);
+    }
+}
+
+void write_page_run(BufferedWriter *writer, int format, int pid, int first, int last, PageTableEntry entry,
+                    int index)
+{
+    int start = PTE_FRAME(entry);
+    int end = start + (last - first);
+    char flags[8];
+    format_protection(PTE_PROT(entry), flags);
+    flags[3] = ' ';
+    flags[4] = (entry & PTE_ACCESSED) ? 'A' : '-';
+    flags[5] = (entry & PTE_DIRTY) ? 'D' : '-';
+    flags[6] = '\0';
+
+    switch (format)
+    {
+    case DUMP_FORMAT_TEXT:
+        writer_string(writer, first == last ? "page " : "pages ");
+        writer_int(writer, first);
+        if (first != last)
+        {
+            writer_string(writer, "-");
+            writer_int(writer, last);
+        }
+        if (PTE_IS_SWAPPED(entry))
+        {
+            writer_string(writer, first == last ? " -> swap slot " : " -> swap slots ");
+        }
+        else
+        {
+            writer_string(writer, first == last ? " -> frame " : " -> frames ");
+        }
+        writer_int(writer, start);
+        if (first != last)
+        {
+            writer_string(writer, "-");
+            writer_int(writer, end);
+        }
+        if (PTE_IS_PRESENT(entry))
+        {
+            writer_string(writer, " ");
+            writer_string(writer, flags);
+        }
+        writer_string(writer, "\n");
+        break;
+    case DUMP_FORMAT_JSON:
+        writer_string(writer, index > 0 ? ",{\"first\":" : "{\"first\":");
+        writer_int(writer, first);
+        writer_string(writer, ",\"last\":");
+        writer_int(writer, last);
+        if (PTE_IS_SWAPPED(entry))
+        {
+            writer_string(writer, ",\"swap_slot\":");
+            writer_int(writer, start);
+        }
+        else
+        {
+            writer_string(writer, ",\"frame\":");
+            writer_int(writer, start);
+            writer_string(writer, ",\"flags\":\"");
+            writer_string(writer, flags);
+            writer_string(writer, "\"");
+        }
+        writer_string(writer, "}");
+        break;
+    case DUMP_FORMAT_CSV:
+        writer_string(writer, "pages,");
+        writer_int(writer, pid);
+        writer_string(writer, ",");
+        writer_int(writer, first);
+        writer_string(writer, ",");
+        writer_int(writer, last);
+        writer_string(writer, ",");
+        writer_int(writer, start);
+        writer_string(writer, ",");
+        writer_string(writer, PTE_IS_SWAPPED(entry) ? "swapped" : flags);
+        writer_string(writer, ",\n");
+        break;
+    default:
+        writer_u32(writer, (uint32_t)first);
+        writer_u32(writer, (uint32_t)last);
+        writer_u32(writer, entry);
+    }
+}
+
+int dump_memory_state(const PhysicalMemory *phys_mem, const ProcessList *proc_list, int format, FILE *out)
+{
+    BufferedWriter writer;
+    if (!writer_open(&writer, out))
+    {
+        return 0;
+    }
+
+    int runs = 0;
+    if (format == DUMP_FORMAT_BINARY)
+    {
+        for (int first = 0; first < phys_mem->number_of_frames; runs++)
+        {
+            first = frame_run_end(phys_mem, first) + 1;
+        }
+        writer_u32(&writer, DUMP_MAGIC);
+        writer_u32(&writer, DUMP_VERSION);
+        writer_u32(&writer, (uint32_t)phys_mem->page_size);
+        writer_u32(&writer, (uint32_t)phys_mem->number_of_frames);
+        writer_u32(&writer, (uint32_t)runs);
+    }
+    else if (format == DUMP_FORMAT_JSON)
+    {
+        writer_string(&writer, "{\"page_size\":");
+        writer_int(&writer, phys_mem->page_size);
+        writer_string(&writer, ",\"number_of_frames\":");
+        writer_int(&writer, phys_mem->number_of_frames);
+        writer_string(&writer, ",\"frames\":[");
+    }
+    else if (format == DUMP_FORMAT_CSV)
+    {
+        writer_string(&writer, "record,pid,first,last,start,state,tier\n");
+    }
+    else
+    {
+        writer_string(&writer, "page_size ");
+        writer_int(&writer, phys_mem->page_size);
+        writer_string(&writer, "\n");
+    }
+
+    for (int first = 0, index = 0; first < phys_mem->number_of_frames; index++)
+    {
+        int last = frame_run_end(phys_mem, first);
+        write_frame_run(&writer, format, first, last, frame_state(phys_mem, first), index);
+        first = last + 1;
+    }
+
+    if (format == DUMP_FORMAT_BINARY)
+    {
+        writer_u32(&writer, (uint32_t)proc_list->count);
+    }
+    else if (format == DUMP_FORMAT_JSON)
+    {
+        writer_string(&writer, "],\"processes\":[");
+    }
+
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        const Process *process = &proc_list->processes[i];
+        if (format == DUMP_FORMAT_BINARY)
+        {
+            runs = 0;
+            for (int first = next_mapped_page(process, 0); first < process->number_of_pages; runs++)
+            {
+                first = next_mapped_page(process, page_run_end(process, first) + 1);
+            }
+            writer_u32(&writer, (uint32_t)process->process_id);
+            writer_u32(&writer, (uint32_t)process->number_of_pages);
+            writer_u32(&writer, (uint32_t)runs);
+        }
+        else if (format == DUMP_FORMAT_JSON)
+        {
+            writer_string(&writer, i > 0 ? ",{\"pid\":" : "{\"pid\":");
+            writer_int(&writer, process->process_id);
+            writer_string(&writer, ",\"number_of_pages\":");
+            writer_int(&writer, process->number_of_pages);
+            writer_string(&writer, ",\"pages\":[");
+        }
+        else if (format == DUMP_FORMAT_TEXT)
+        {
+            writer_string(&writer, "process ");
+            writer_int(&writer, process->process_id);
+            writer_string(&writer, "\n");
+        }
+
+        int index = 0;
+        for (int first = next_mapped_page(process, 0); first < process->number_of_pages;
+             first = next_mapped_page(process, first))
+        {
+            int last = page_run_end(process, first);
+            write_page_run(&writer, format, process->process_id, first, last, pte_get(process, first), index++);
+            first = last + 1;
+        }
+
+        if (format == DUMP_FORMAT_JSON)
+        {
+            writer_string(&writer, "]}");
+        }
+    }
+
+    if (format == DUMP_FORMAT_JSON)
+    {
+        writer_string(&writer, "]}\n");
+    }
+    return writer_close(&writer);
+}
+
+void dump_memory_menu(const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    static const char *format_names[] = {"text", "json", "csv", "binary"};
+    char format_name[INPUT_BUFFER_SIZE];
+    char path[INPUT_BUFFER_SIZE];
+
+    printf("\n=== Dump Memory State ===\n");
+    printf("Enter format (text/json/csv/binary): ");
+    if (scanf("%99s", format_name) != 1)
+    {
+        clear_input_buffer();
+        return;
+    }
+    int format = -1;
+    for (int i = 0; i < (int)(sizeof(format_names) / sizeof(format_names[0])); i++)
+    {
+        if (strcmp(format_name, format_names[i]) == 0)
+        {
+            format = i;
+        }
+    }
+    if (format < 0)
+    {
+        printf("Error: Unknown format '%s'.\n", format_name);
+        return;
+    }
+
+    printf("Enter output file (- for standard output): ");
+    if (scanf("%99s", path) != 1)
+    {
+        clear_input_buffer();
+        return;
+    }
+
+    FILE *out = stdout;
+    if (strcmp(path, "-") != 0 && (out = fopen(path, format == DUMP_FORMAT_BINARY ? "wb" : "w")) == NULL)
+    {
+        printf("Error: Unable to open '%s' for writing.\n", path);
+        return;
+    }
+    fflush(stdout);
+
+    clock_t started = clock();
+    int written = dump_memory_state(phys_mem, proc_list, format, out);
+    double seconds = (double)(clock() - started) / CLOCKS_PER_SEC;
+    if (out != stdout && fclose(out) != 0)
+    {
+        written = 0;
+    }
+
+    if (!written)
+    {
+        printf("Error: Failed to write the memory state.\n");
+        return;
+    }
+    if (out != stdout)
+    {
+        printf("Memory state written to %s in %.3f s.\n", path, seconds);
+    }
+}
+
+Process *find_process(const ProcessList *proc_list, int pid)
+{
+    int row = pid_map_find(&proc_list->pid_index, pid);
+    return row >= 0 ? &proc_list->processes[row] : NULL;
+}
+
+int page_align_up(const PhysicalMemory *phys_mem, long long address)
+{
+    if (address < 0)
+    {
+        return -1;
+    }
+
+    uint64_t aligned;
+    if (!align_up((uint64_t)address, phys_mem->page_shift, &aligned) || aligned > INT_MAX)
+    {
+        return -1;
+    }
+    return (int)aligned;
+}
+
+int address_space_limit(const PhysicalMemory *phys_mem)
+{
+    return INT_MAX & ~phys_mem->page_mask;
+}
+
+int ensure_page_table_span(Process *process, int pages)
+{
+    if (pages <= process->number_of_pages)
+    {
+        return 1;
+    }
+
+    if (process->pte_directory != NULL || pages >= PTE_COMPRESS_MIN_PAGES)
+    {
+        return compress_page_table(process, pages);
+    }
+
+    PageTableEntry *table =
+        grow_page_table(&process->allocator->page_tables, process->page_table, process->number_of_pages, pages);
+    if (table == NULL)
+    {
+        return 0;
+    }
+
+    for (int i = process->number_of_pages; i < pages; i++)
+    {
+        table[i] = PTE_NOT_PRESENT;
+    }
+    process->page_table = table;
+    process->number_of_pages = pages;
+    return 1;
+}
+
+PageTableEntry pte_get(const Process *process, int page)
+{
+    if (process->pte_directory == NULL)
+    {
+        return process->page_table[page];
+    }
+
+    PageTableEntry chunk = process->pte_directory[page / PTE_CHUNK_ENTRIES];
+    if (chunk == 0)
+    {
+        return PTE_NOT_PRESENT;
+    }
+    return process->page_table[(chunk - 1) * PTE_CHUNK_ENTRIES + page % PTE_CHUNK_ENTRIES];
+}
+
+SPECIALIZE_INLINE PageTableEntry pte_get_layout(const Process *process, int page, int layout)
+{
+    if (layout == PAGE_TABLE_FLAT)
+    {
+        return process->page_table[page];
+    }
+    if (layout == PAGE_TABLE_COMPRESSED)
+    {
+        PageTableEntry chunk = process->pte_directory[page >> PTE_CHUNK_SHIFT];
+        return chunk != 0 ? process->page_table[((chunk - 1) << PTE_CHUNK_SHIFT) | (page & (PTE_CHUNK_ENTRIES - 1))]
+                          : PTE_NOT_PRESENT;
+    }
+    return pte_get(process, page);
+}
+
+int pte_set(Process *process, int page, PageTableEntry entry)
+{
+    if (process->pte_directory == NULL)
+    {
+        process->page_table[page] = entry;
+        return 1;
+    }
+
+    PageTableEntry *chunk = &process->pte_directory[page / PTE_CHUNK_ENTRIES];
+    if (*chunk == 0)
+    {
+        if (entry == PTE_NOT_PRESENT)
+        {
+            return 1;
+        }
+        if (process->pte_chunks == process->pte_chunk_capacity)
+        {
+            int capacity = process->pte_chunk_capacity > 0 ? process->pte_chunk_capacity * 2 : 1;
+            PageTableEntry *chunks =
+                grow_page_table(&process->allocator->page_tables, process->page_table,
+                                process->pte_chunk_capacity * PTE_CHUNK_ENTRIES, capacity * PTE_CHUNK_ENTRIES);
+            if (chunks == NULL)
+            {
+                return 0;
+            }
+            process->page_table = chunks;
+            process->pte_chunk_capacity = capacity;
+        }
+        *chunk = (PageTableEntry)++process->pte_chunks;
+        memset(&process->page_table[(*chunk - 1) * PTE_CHUNK_ENTRIES], 0, PTE_CHUNK_ENTRIES * sizeof(PageTableEntry));
+    }
+    process->page_table[(*chunk - 1) * PTE_CHUNK_ENTRIES + page % PTE_CHUNK_ENTRIES] = entry;
+    return 1;
+}
+
+int compress_page_table(Process *process, int pages)
+{
+    PageTableArena *arena = &process->allocator->page_tables;
+    int old_slots = (process->number_of_pages + PTE_CHUNK_ENTRIES - 1) / PTE_CHUNK_ENTRIES;
+    int new_slots = (pages + PTE_CHUNK_ENTRIES - 1) / PTE_CHUNK_ENTRIES;
+
+    if (process->pte_directory != NULL)
+    {
+        PageTableEntry *directory = grow_page_table(arena, process->pte_directory, old_slots, new_slots);
+        if (directory == NULL)
+        {
+            return 0;
+        }
+        memset(&directory[old_slots], 0, (size_t)(new_slots - old_slots) * sizeof(PageTableEntry));
+        process->pte_directory = directory;
+        process->number_of_pages = pages;
+        return 1;
+    }
+
+    const PageTableEntry *flat = process->page_table;
+    int populated = 0;
+    for (int slot = 0; slot < old_slots; slot++)
+    {
+        for (int page = slot * PTE_CHUNK_ENTRIES;
+             page < (slot + 1) * PTE_CHUNK_ENTRIES && page < process->number_of_pages; page++)
+        {
+            if (flat[page] != PTE_NOT_PRESENT)
+            {
+                populated++;
+                break;
+            }
+        }
+    }
+
+    PageTableEntry *directory = allocate_page_table(arena, new_slots);
+    PageTableEntry *chunks = directory != NULL ? allocate_page_table(arena, populated * PTE_CHUNK_ENTRIES) : NULL;
+    if (chunks == NULL)
+    {
+        if (directory != NULL)
+        {
+            release_page_table(arena, directory, new_slots);
+        }
+        return 0;
+    }
+
+    memset(directory, 0, (size_t)new_slots * sizeof(PageTableEntry));
+    memset(chunks, 0, (size_t)populated * PTE_CHUNK_ENTRIES * sizeof(PageTableEntry));
+    int chunk = 0;
+    for (int slot = 0; slot < old_slots; slot++)
+    {
+        int first = slot * PTE_CHUNK_ENTRIES;
+        int last = first + PTE_CHUNK_ENTRIES < process->number_of_pages ? first + PTE_CHUNK_ENTRIES
+                                                                         : process->number_of_pages;
+        int empty = 1;
+        for (int page = first; page < last && empty; page++)
+        {
+            empty = flat[page] == PTE_NOT_PRESENT;
+        }
+        if (!empty)
+        {
+            memcpy(&chunks[chunk * PTE_CHUNK_ENTRIES], &flat[first], (size_t)(last - first) * sizeof(PageTableEntry));
+            directory[slot] = (PageTableEntry)++chunk;
+        }
+    }
+
+    release_page_table(arena, process->page_table, process->number_of_pages);
+    process->page_table = chunks;
+    process->pte_directory = directory;
+    process->pte_chunks = populated;
+    process->pte_chunk_capacity = populated;
+    process->number_of_pages = pages;
+    return 1;
+}
+
+void release_empty_pte_chunks(Process *process, int start_page, int end_page)
+{
+    if (process->pte_directory == NULL || start_page >= end_page)
+    {
+        return;
+    }
+
+    PageTableEntry *directory = process->pte_directory;
+    int slots = (process->number_of_pages + PTE_CHUNK_ENTRIES - 1) / PTE_CHUNK_ENTRIES;
+    for (int slot = start_page / PTE_CHUNK_ENTRIES; slot <= (end_page - 1) / PTE_CHUNK_ENTRIES; slot++)
+    {
+        PageTableEntry chunk = directory[slot];
+        if (chunk == 0)
+        {
+            continue;
+        }
+        PageTableEntry *entries = &process->page_table[(chunk - 1) * PTE_CHUNK_ENTRIES];
+        int empty = 1;
+        for (int i = 0; i < PTE_CHUNK_ENTRIES && empty; i++)
+        {
+            empty = entries[i] == PTE_NOT_PRESENT;
+        }
+        if (!empty)
+        {
+            continue;
+        }
+
+        PageTableEntry last = (PageTableEntry)process->pte_chunks;
+        if (chunk != last)
+        {
+            memcpy(entries, &process->page_table[(last - 1) * PTE_CHUNK_ENTRIES],
+                   PTE_CHUNK_ENTRIES * sizeof(PageTableEntry));
+            for (int other = 0; other < slots; other++)
+            {
+                if (directory[other] == last)
+                {
+                    directory[other] = chunk;
+                    break;
+                }
+            }
+        }
+        directory[slot] = 0;
+        process->pte_chunks--;
+    }
+
+    int capacity = process->pte_chunk_capacity / 2;
+    if (capacity > 0 && process->pte_chunks * 4 <= process->pte_chunk_capacity)
+    {
+        PageTableArena *arena = &process->allocator->page_tables;
+        PageTableEntry *chunks = allocate_page_table(arena, capacity * PTE_CHUNK_ENTRIES);
+        if (chunks != NULL)
+        {
+            memcpy(chunks, process->page_table,
+                   (size_t)process->pte_chunks * PTE_CHUNK_ENTRIES * sizeof(PageTableEntry));
+            release_page_table(arena, process->page_table, process->pte_chunk_capacity * PTE_CHUNK_ENTRIES);
+            process->page_table = chunks;
+            process->pte_chunk_capacity = capacity;
+        }
+    }
+}
+
+int pte_protection(const PhysicalMemory *phys_mem, const VmArea *vma, int frame)
+{
+    if (phys_mem->frames[frame].type == FRAME_PAGE_CACHE && !(vma->flags & VMA_FLAG_SHARED))
+    {
+        return vma->prot & ~VMA_PROT_WRITE;
+    }
+    return vma->prot;
+}
+
+int test_and_clear_referenced(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    if (info->type == FRAME_ANONYMOUS)
+    {
+        Process *owner = &proc_list->processes[info->owner];
+        PageTableEntry entry = pte_get(owner, info->page);
+        if (entry & PTE_ACCESSED)
+        {
+            pte_set(owner, info->page, entry & ~PTE_ACCESSED);
+            return 1;
+        }
+        return 0;
+    }
+
+    int referenced = info->referenced;
+    info->referenced = 0;
+    return referenced;
+}
+
+int vma_height(const VmArea *node)
+{
+    return node == NULL ? 0 : node->height;
+}
+
+void vma_update_height(VmArea *node)
+{
+    int left = vma_height(node->left);
+    int right = vma_height(node->right);
+    node->height = (left > right ? left : right) + 1;
+}
+
+VmArea *vma_rotate_left(VmArea *node)
+{
+    VmArea *pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    vma_update_height(node);
+    vma_update_height(pivot);
+    return pivot;
+}
+
+VmArea *vma_rotate_right(VmArea *node)
+{
+    VmArea *pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    vma_update_height(node);
+    vma_update_height(pivot);
+    return pivot;
+}
+
+VmArea *vma_rebalance(VmArea *node)
+{
+    vma_update_height(node);
+    int balance = vma_height(node->left) - vma_height(node->right);
+
+    if (balance > 1)
+    {
+        if (vma_height(node->left->left) < vma_height(node->left->right))
+        {
+            node->left = vma_rotate_left(node->left);
+        }
+        return vma_rotate_right(node);
+    }
+    if (balance < -1)
+    {
+        if (vma_height(node->right->right) < vma_height(node->right->left))
+        {
+            node->right = vma_rotate_right(node->right);
+        }
+        return vma_rotate_left(node);
+    }
+    return node;
+}
+
+VmArea *vma_tree_insert(VmArea *root, VmArea *vma)
+{
+    if (root == NULL)
+    {
+        vma->left = NULL;
+        vma->right = NULL;
+        vma->height = 1;
+        return vma;
+    }
+
+    if (vma->start < root->start)
+    {
+        root->left = vma_tree_insert(root->left, vma);
+    }
+    else
+    {
+        root->right = vma_tree_insert(root->right, vma);
+    }
+    return vma_rebalance(root);
+}
+
+VmArea *vma_tree_remove(VmArea *root, int start)
+{
+    if (root == NULL)
+    {
+        return NULL;
+    }
+
+    if (start < root->start)
+    {
+        root->left = vma_tree_remove(root->left, start);
+    }
+    else if (start > root->start)
+    {
+        root->right = vma_tree_remove(root->right, start);
+    }
+    else
+    {
+        if (root->left == NULL)
+        {
+            return root->right;
+        }
+        if (root->right == NULL)
+        {
+            return root->left;
+        }
+
+        VmArea *successor = root->right;
+        while (successor->left != NULL)
+        {
+            successor = successor->left;
+        }
+        successor->right = vma_tree_remove(root->right, successor->start);
+        successor->left = root->left;
+        root = successor;
+    }
+    return vma_rebalance(root);
+}
+
+VmArea *vma_find(VmArea *root, int address)
+{
+    VmArea *node = root;
+    while (node != NULL)
+    {
+        if (address < node->start)
+        {
+            node = node->left;
+        }
+        else if (address >= node->end)
+        {
+            node = node->right;
+        }
+        else
+        {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+VmArea *vma_find_overlap(VmArea *root, int start, int end)
+{
+    VmArea *candidate = NULL;
+    VmArea *node = root;
+    while (node != NULL)
+    {
+        if (node->end > start)
+        {
+            candidate = node;
+            node = node->left;
+        }
+        else
+        {
+            node = node->right;
+        }
+    }
+
+    if (candidate != NULL && candidate->start < end)
+    {
+        return candidate;
+    }
+    return NULL;
+}
+
+VmArea *vma_create(ObjectPool *pool, int start, int end, int prot, int flags, int file_id, int file_offset)
+{
+    VmArea *vma = (VmArea *)pool_alloc(pool);
+    if (vma == NULL)
+    {
+        return NULL;
+    }
+
+    vma->start = start;
+    vma->end = end;
+    vma->prot = prot;
+    vma->flags = flags;
+    vma->file_id = file_id;
+    vma->file_offset = file_offset;
+    vma->height = 1;
+    vma->left = NULL;
+    vma->right = NULL;
+    return vma;
+}
+
+VmArea *vma_split(Process *process, VmArea *vma, int address)
+{
+    VmArea *upper = vma_create(&process->allocator->vma_nodes, address, vma->end, vma->prot, vma->flags,
+                               vma->file_id, vma->file_offset + (address - vma->start));
+    if (upper == NULL)
+    {
+        return NULL;
+    }
+
+    vma->end = address;
+    process->vma_root = vma_tree_insert(process->vma_root, upper);
+    process->vma_count++;
+    return upper;
+}
+
+int process_mmap(PhysicalMemory *phys_mem, Process *process, int address, int length,
+                 int prot, int flags, int file_id, int file_offset)
+{
+    int page_mask = phys_mem->page_mask;
+    int limit = address_space_limit(phys_mem);
+
+    if (length <= 0 || address < 0 || (address & page_mask) != 0)
+    {
+        return -1;
+    }
+
+    int aligned_length = page_align_up(phys_mem, length);
+    if (aligned_length < 0 || aligned_length > limit)
+    {
+        return -1;
+    }
+
+    if (flags & VMA_FLAG_FILE)
+    {
+        if (file_offset < 0 || (file_offset & page_mask) != 0 ||
+            (long long)file_offset + aligned_length > INT_MAX)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        file_id = 0;
+        file_offset = 0;
+    }
+
+    long long start = address;
+    if (address != 0)
+    {
+        if (start + aligned_length > limit ||
+            vma_find_overlap(process->vma_root, address, address + aligned_length) != NULL)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        start = process->mmap_base;
+        while (1)
+        {
+            if (start + aligned_length > limit)
+            {
+                return -1;
+            }
+
+            VmArea *conflict = vma_find_overlap(process->vma_root, (int)start, (int)(start + aligned_length));
+            if (conflict == NULL)
+            {
+                break;
+            }
+            start = conflict->end;
+        }
+    }
+
+    if (!ensure_page_table_span(process, (int)((start + aligned_length) >> phys_mem->page_shift)))
+    {
+        return -1;
+    }
+
+    VmArea *vma = vma_create(&process->allocator->vma_nodes, (int)start, (int)(start + aligned_length), prot,
+                             flags & (VMA_FLAG_FILE | VMA_FLAG_SHARED), file_id, file_offset);
+    if (vma == NULL)
+    {
+        return -1;
+    }
+
+    process->vma_root = vma_tree_insert(process->vma_root, vma);
+    process->vma_count++;
+    return (int)start;
+}
+
+void release_page_range(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int start_page,
+                        int end_page)
+{
+    int *resident_pages = &proc_list->resident_pages[process_index(proc_list, process)];
+    if (end_page > process->number_of_pages)
+    {
+        end_page = process->number_of_pages;
+    }
+
+    for (int page = start_page; page < end_page; page++)
+    {
+        PageTableEntry entry = pte_get(process, page);
+        if (PTE_IS_SWAPPED(entry))
+        {
+            release_swap_slot(&phys_mem->swap, PTE_SWAP_SLOT(entry));
+        }
+        else if (PTE_IS_PRESENT(entry))
+        {
+            int frame = PTE_FRAME(entry);
+            if (phys_mem->frames[frame].type == FRAME_PAGE_CACHE)
+            {
+                phys_mem->frames[frame].map_count--;
+            }
+            else
+            {
+                release_frames(phys_mem, &frame, 1);
+            }
+            (*resident_pages)--;
+        }
+        pte_set(process, page, PTE_NOT_PRESENT);
+    }
+    release_empty_pte_chunks(process, start_page, end_page);
+}
+
+int process_munmap(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address, int length)
+{
+    if (address < 0 || length <= 0 || (address & phys_mem->page_mask) != 0)
+    {
+        return 0;
+    }
+
+    int end = page_align_up(phys_mem, (long long)address + length);
+    if (end < 0)
+    {
+        return 0;
+    }
+
+    VmArea *vma;
+    while ((vma = vma_find_overlap(process->vma_root, address, end)) != NULL)
+    {
+        if (vma->start < address)
+        {
+            if (vma_split(process, vma, address) == NULL)
+            {
+                return 0;
+            }
+            continue;
+        }
+        if (vma->end > end && vma_split(process, vma, end) == NULL)
+        {
+            return 0;
+        }
+
+        release_page_range(phys_mem, proc_list, process, vma->start >> phys_mem->page_shift,
+                           vma->end >> phys_mem->page_shift);
+        process->vma_root = vma_tree_remove(process->vma_root, vma->start);
+        process->vma_count--;
+        pool_free(&process->allocator->vma_nodes, vma);
+    }
+    return 1;
+}
+
+int process_mprotect(PhysicalMemory *phys_mem, Process *process, int address, int length, int prot)
+{
+    if (address < 0 || length <= 0 || (address & phys_mem->page_mask) != 0)
+    {
+        return 0;
+    }
+
+    int end = page_align_up(phys_mem, (long long)address + length);
+    if (end < 0)
+    {
+        return 0;
+    }
+
+    for (int cursor = address; cursor < end;)
+    {
+        VmArea *vma = vma_find(process->vma_root, cursor);
+        if (vma == NULL)
+        {
+            return 0;
+        }
+        cursor = vma->end;
+    }
+
+    for (int cursor = address; cursor < end;)
+    {
+        VmArea *vma = vma_find(process->vma_root, cursor);
+        if (vma->start < cursor)
+        {
+            vma = vma_split(process, vma, cursor);
+            if (vma == NULL)
+            {
+                return 0;
+            }
+        }
+        if (vma->end > end && vma_split(process, vma, end) == NULL)
+        {
+            return 0;
+        }
+        vma->prot = prot;
+        for (int page = vma->start >> phys_mem->page_shift;
+             page < vma->end >> phys_mem->page_shift && page < process->number_of_pages; page++)
+        {
+            PageTableEntry entry = pte_get(process, page);
+            if (PTE_IS_PRESENT(entry))
+            {
+                pte_set(process, page, PTE_WITH_PROT(entry, pte_protection(phys_mem, vma, PTE_FRAME(entry))));
+            }
+        }
+        cursor = vma->end;
+    }
+    return 1;
+}
+
+int process_brk(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int new_brk)
+{
+    if (new_brk < process->heap_start)
+    {
+        return -1;
+    }
+
+    int old_end = page_align_up(phys_mem, process->brk);
+    int new_end = page_align_up(phys_mem, new_brk);
+    if (new_end < 0 || new_end > address_space_limit(phys_mem))
+    {
+        return -1;
+    }
+
+    if (new_end > old_end)
+    {
+        if (vma_find_overlap(process->vma_root, old_end, new_end) != NULL ||
+            !ensure_page_table_span(process, new_end >> phys_mem->page_shift))
+        {
+            return -1;
+        }
+
+        VmArea *heap = old_end > process->heap_start ? vma_find(process->vma_root, old_end - 1) : NULL;
+        if (heap != NULL && (heap->flags & VMA_FLAG_HEAP))
+        {
+            heap->end = new_end;
+        }
+        else
+        {
+            heap = vma_create(&process->allocator->vma_nodes, old_end, new_end, VMA_PROT_READ | VMA_PROT_WRITE,
+                              VMA_FLAG_HEAP, 0, 0);
+            if (heap == NULL)
+            {
+                return -1;
+            }
+            process->vma_root = vma_tree_insert(process->vma_root, heap);
+            process->vma_count++;
+        }
+    }
+    else if (new_end < old_end && !process_munmap(phys_mem, proc_list, process, new_end, old_end - new_end))
+    {
+        return -1;
+    }
+
+    process->brk = new_brk;
+    return new_brk;
+}
+
+int process_index(const ProcessList *proc_list, const Process *process)
+{
+    return (int)(process - proc_list->processes);
+}
+
+int allocate_swap_slot(SwapSpace *swap)
+{
+    if (swap->free_slot_count == 0)
+    {
+        return -1;
+    }
+    return swap->free_slots[--swap->free_slot_count];
+}
+
+void release_swap_slot(SwapSpace *swap, int slot)
+{
+    swap->free_slots[swap->free_slot_count++] = slot;
+}
+
+unsigned int file_page_hash(int file_id, int file_page)
+{
+    return (unsigned int)file_id * 2654435761u ^ (unsigned int)file_page * 40503u;
+}
+
+int page_cache_bucket(const PhysicalMemory *phys_mem, int file_id, int file_page)
+{
+    return (int)(file_page_hash(file_id, file_page) % (unsigned int)phys_mem->page_cache_bucket_count);
+}
+
+int page_cache_lookup(const PhysicalMemory *phys_mem, int file_id, int file_page)
+{
+    int frame = phys_mem->page_cache_buckets[page_cache_bucket(phys_mem, file_id, file_page)];
+    while (frame >= 0)
+    {
+        const FrameInfo *info = &phys_mem->frames[frame];
+        if (info->file_id == file_id && info->page == file_page)
+        {
+            return frame;
+        }
+        frame = info->cache_next;
+    }
+    return -1;
+}
+
+void page_cache_insert(PhysicalMemory *phys_mem, int frame, int file_id, int file_page)
+{
+    int bucket = page_cache_bucket(phys_mem, file_id, file_page);
+    FrameInfo *info = &phys_mem->frames[frame];
+    journal_record(phys_mem, JOURNAL_FRAME_ALLOC, -1, file_page, frame, FRAME_PAGE_CACHE, file_id);
+    info->type = FRAME_PAGE_CACHE;
+    info->owner = -1;
+    info->file_id = file_id;
+    info->page = file_page;
+    info->map_count = 0;
+    info->referenced = 0;
+    info->dirty = 0;
+    info->pinned = 0;
+    info->prefetched = 0;
+    info->swap_slot = -1;
+    info->cache_next = phys_mem->page_cache_buckets[bucket];
+    phys_mem->page_cache_buckets[bucket] = frame;
+    phys_mem->page_cache_pages++;
+}
+
+void page_cache_remove(PhysicalMemory *phys_mem, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    int *link = &phys_mem->page_cache_buckets[page_cache_bucket(phys_mem, info->file_id, info->page)];
+    while (*link >= 0)
+    {
+        if (*link == frame)
+        {
+            *link = info->cache_next;
+            phys_mem->page_cache_pages--;
+            return;
+        }
+        link = &phys_mem->frames[*link].cache_next;
+    }
+}
+
+int page_cache_get(PhysicalMemory *phys_mem, ProcessList *proc_list, int file_id, int file_page, int window)
+{
+    int frame = page_cache_lookup(phys_mem, file_id, file_page);
+    if (frame >= 0)
+    {
+        phys_mem->stats.page_cache_hits++;
+        return frame;
+    }
+
+    phys_mem->stats.page_cache_misses++;
+    if (!obtain_frame(phys_mem, proc_list, NULL, &frame))
+    {
+        return -1;
+    }
+    read_file_page(phys_mem, frame, file_id, file_page);
+    page_cache_insert(phys_mem, frame, file_id, file_page);
+
+    int pages_read = 1;
+    for (int ahead = 1; ahead < window; ahead++)
+    {
+        int readahead_frame;
+        if (page_cache_lookup(phys_mem, file_id, file_page + ahead) >= 0)
+        {
+            continue;
+        }
+        if (!allocate_frames(phys_mem, NULL, 1, &readahead_frame))
+        {
+            break;
+        }
+        read_file_page(phys_mem, readahead_frame, file_id, file_page + ahead);
+        page_cache_insert(phys_mem, readahead_frame, file_id, file_page + ahead);
+        phys_mem->stats.readahead_pages++;
+        pages_read++;
+    }
+
+    phys_mem->stats.simulated_time_ns += COST_DISK_IO_NS + (long long)pages_read * COST_DISK_PAGE_NS;
+    return frame;
+}
+
+FilePage *file_store_find(const FileStore *store, int file_id, int file_page)
+{
+    FilePage *entry = store->buckets[file_page_hash(file_id, file_page) % FILE_STORE_BUCKETS];
+    while (entry != NULL)
+    {
+        if (entry->file_id == file_id && entry->page == file_page)
+        {
+            return entry;
+        }
+        entry = entry->next;
+    }
+    return NULL;
+}
+
+void read_file_page(PhysicalMemory *phys_mem, int frame, int file_id, int file_page)
+{
+    unsigned char *destination = &phys_mem->memory[frame * phys_mem->page_size];
+    FilePage *stored = file_store_find(&phys_mem->file_store, file_id, file_page);
+    if (stored != NULL)
+    {
+        memcpy(destination, stored->data, phys_mem->page_size);
+        return;
+    }
+
+    unsigned int file_offset = (unsigned int)file_page * (unsigned int)phys_mem->page_size;
+    for (int i = 0; i < phys_mem->page_size; i++)
+    {
+        unsigned int position = file_offset + (unsigned int)i;
+        destination[i] = (unsigned char)((unsigned int)file_id * 131u + position * 7u + (position >> 8));
+    }
+}
+
+FilePage *file_store_insert(PhysicalMemory *phys_mem, int file_id, int file_page)
+{
+    FilePage *stored = file_store_find(&phys_mem->file_store, file_id, file_page);
+    if (stored == NULL)
+    {
+        stored = (FilePage *)pool_alloc(&phys_mem->file_store.pages);
+        if (stored == NULL)
+        {
+            return NULL;
+        }
+        stored->data = (unsigned char *)(stored + 1);
+
+        unsigned int bucket = file_page_hash(file_id, file_page) % FILE_STORE_BUCKETS;
+        stored->file_id = file_id;
+        stored->page = file_page;
+        stored->next = phys_mem->file_store.buckets[bucket];
+        phys_mem->file_store.buckets[bucket] = stored;
+        phys_mem->file_store.page_count++;
+    }
+    return stored;
+}
+
+int store_file_page(PhysicalMemory *phys_mem, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    FilePage *stored = file_store_insert(phys_mem, info->file_id, info->page);
+    if (stored == NULL)
+    {
+        return 0;
+    }
+
+    memcpy(stored->data, &phys_mem->memory[frame * phys_mem->page_size], phys_mem->page_size);
+    mark_frame_clean(phys_mem, frame);
+    return 1;
+}
+
+int write_back_page(PhysicalMemory *phys_mem, int frame)
+{
+    if (!store_file_page(phys_mem, frame))
+    {
+        return 0;
+    }
+    charge_write_io(phys_mem, 1, 1, 1);
+    return 1;
+}
+
+int mark_frame_dirty(PhysicalMemory *phys_mem, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    if (info->dirty)
+    {
+        return 0;
+    }
+    info->dirty = 1;
+    phys_mem->writeback.dirty_pages++;
+    return 1;
+}
+
+void mark_frame_clean(PhysicalMemory *phys_mem, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    if (info->dirty)
+    {
+        info->dirty = 0;
+        phys_mem->writeback.dirty_pages--;
+    }
+}
+
+void charge_write_io(PhysicalMemory *phys_mem, int ios, int pages, int synchronous)
+{
+    long long cost = (long long)ios * COST_DISK_IO_NS + (long long)pages * COST_DISK_PAGE_NS;
+    phys_mem->stats.writeback_ios += ios;
+    phys_mem->stats.writeback_pages += pages;
+    phys_mem->stats.writeback_time_ns += cost;
+    if (synchronous)
+    {
+        phys_mem->stats.simulated_time_ns += cost;
+    }
+}
+
+int compare_writeback_items(const void *a, const void *b)
+{
+    const WritebackItem *left = (const WritebackItem *)a;
+    const WritebackItem *right = (const WritebackItem *)b;
+    if (left->space != right->space)
+    {
+        return left->space < right->space ? -1 : 1;
+    }
+    if (left->offset != right->offset)
+    {
+        return left->offset < right->offset ? -1 : 1;
+    }
+    return 0;
+}
+
+int flush_dirty_pages(PhysicalMemory *phys_mem, int max_pages, int synchronous)
+{
+    WritebackControl *writeback = &phys_mem->writeback;
+    if (max_pages > writeback->dirty_pages)
+    {
+        max_pages = writeback->dirty_pages;
+    }
+    if (max_pages <= 0)
+    {
+        return 0;
+    }
+
+    WritebackItem *items = (WritebackItem *)malloc(max_pages * sizeof(WritebackItem));
+    if (items == NULL)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    for (int scanned = 0; scanned < phys_mem->number_of_frames && count < max_pages; scanned++)
+    {
+        int frame = writeback->cursor;
+        writeback->cursor = (writeback->cursor + 1) % phys_mem->number_of_frames;
+
+        FrameInfo *info = &phys_mem->frames[frame];
+        if (!info->dirty || info->pinned)
+        {
+            continue;
+        }
+
+        if (info->type == FRAME_ANONYMOUS)
+        {
+            if (info->swap_slot < 0 && (info->swap_slot = allocate_swap_slot(&phys_mem->swap)) < 0)
+            {
+                continue;
+            }
+            items[count].space = -1;
+            items[count].offset = info->swap_slot;
+        }
+        else
+        {
+            items[count].space = info->file_id;
+            items[count].offset = info->page;
+        }
+        items[count].frame = frame;
+        count++;
+    }
+
+    qsort(items, count, sizeof(WritebackItem), compare_writeback_items);
+
+    int ios = 0, pages = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int frame = items[i].frame;
+        if (items[i].space < 0)
+        {
+            memcpy(&phys_mem->swap.data[(size_t)items[i].offset * phys_mem->page_size],
+                   &phys_mem->memory[frame * phys_mem->page_size], phys_mem->page_size);
+            mark_frame_clean(phys_mem, frame);
+            phys_mem->stats.swap_writebacks++;
+        }
+        else if (!store_file_page(phys_mem, frame))
+        {
+            continue;
+        }
+
+        if (pages == 0 || items[i].space != items[i - 1].space || items[i].offset != items[i - 1].offset + 1)
+        {
+            ios++;
+        }
+        pages++;
+    }
+
+    free(items);
+    charge_write_io(phys_mem, ios, pages, synchronous);
+    if (synchronous)
+    {
+        phys_mem->stats.stall_time_ns += (long long)ios * COST_DISK_IO_NS + (long long)pages * COST_DISK_PAGE_NS;
+    }
+    return pages;
+}
+
+void balance_dirty_pages(PhysicalMemory *phys_mem)
+{
+    WritebackControl *writeback = &phys_mem->writeback;
+    int background_limit = (int)((long long)phys_mem->number_of_frames * writeback->background_ratio / 100);
+    int dirty_limit = (int)((long long)phys_mem->number_of_frames * writeback->dirty_ratio / 100);
+
+    if (writeback->dirty_pages > dirty_limit)
+    {
+        phys_mem->stats.throttle_events++;
+        while (writeback->dirty_pages > background_limit)
+        {
+            if (flush_dirty_pages(phys_mem, writeback->batch_pages, 1) == 0)
+            {
+                break;
+            }
+        }
+        writeback->last_flush_ns = phys_mem->stats.simulated_time_ns;
+    }
+    else if (writeback->dirty_pages > background_limit &&
+             phys_mem->stats.simulated_time_ns - writeback->last_flush_ns >= writeback->interval_ns)
+    {
+        phys_mem->stats.background_flushes++;
+        flush_dirty_pages(phys_mem, writeback->batch_pages, 0);
+        writeback->last_flush_ns = phys_mem->stats.simulated_time_ns;
+    }
+}
+
+int unmap_file_page_in_tree(Process *process, const VmArea *node, int page_shift, int frame,
+                            const FrameInfo *info, int replacement)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+
+    int cleared = unmap_file_page_in_tree(process, node->left, page_shift, frame, info, replacement) +
+                  unmap_file_page_in_tree(process, node->right, page_shift, frame, info, replacement);
+
+    int first_file_page = node->file_offset >> page_shift;
+    int pages = (node->end - node->start) >> page_shift;
+    if ((node->flags & VMA_FLAG_FILE) && node->file_id == info->file_id &&
+        info->page >= first_file_page && info->page < first_file_page + pages)
+    {
+        int page = (node->start >> page_shift) + (info->page - first_file_page);
+        PageTableEntry entry = pte_get(process, page);
+        if (PTE_IS_PRESENT(entry) && PTE_FRAME(entry) == frame)
+        {
+            if (replacement >= 0)
+            {
+                pte_set(process, page, PTE_WITH_FRAME(entry, replacement));
+            }
+            else
+            {
+                pte_set(process, page, PTE_NOT_PRESENT);
+            }
+            cleared++;
+        }
+    }
+    return cleared;
+}
+
+void unmap_page_cache_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    for (int i = 0; i < proc_list->count && info->map_count > 0; i++)
+    {
+        Process *process = &proc_list->processes[i];
+        int cleared = unmap_file_page_in_tree(process, process->vma_root, phys_mem->page_shift, frame, info, -1);
+        info->map_count -= cleared;
+        proc_list->resident_pages[i] -= cleared;
+    }
+}
+
+int evict_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame)
+{
+    FrameInfo *info = &phys_mem->frames[frame];
+    int dirty = info->dirty;
+
+    if (info->prefetched)
+    {
+        info->prefetched = 0;
+        phys_mem->prefetcher.polluted++;
+    }
+
+    if (info->type == FRAME_ANONYMOUS)
+    {
+        int slot = info->swap_slot;
+        if (dirty || slot < 0)
+        {
+            if (slot < 0 && (slot = allocate_swap_slot(&phys_mem->swap)) < 0)
+            {
+                return 0;
+            }
+            memcpy(&phys_mem->swap.data[(size_t)slot * phys_mem->page_size],
+                   &phys_mem->memory[frame * phys_mem->page_size], phys_mem->page_size);
+            phys_mem->stats.swap_outs++;
+            phys_mem->stats.dirty_evictions++;
+            charge_write_io(phys_mem, 1, 1, 1);
+        }
+        else
+        {
+            phys_mem->stats.clean_evictions++;
+        }
+
+        Process *owner = &proc_list->processes[info->owner];
+        pte_set(owner, info->page, PTE_MAKE_SWAP(slot));
+        proc_list->resident_pages[info->owner]--;
+        info->swap_slot = -1;
+        phys_mem->stats.anonymous_evictions++;
+    }
+    else
+    {
+        if (dirty)
+        {
+            if (!write_back_page(phys_mem, frame))
+            {
+                return 0;
+            }
+            phys_mem->stats.dirty_evictions++;
+        }
+        else
+        {
+            phys_mem->stats.clean_evictions++;
+        }
+        unmap_page_cache_frame(phys_mem, proc_list, frame);
+        page_cache_remove(phys_mem, frame);
+        phys_mem->stats.page_cache_evictions++;
+    }
+
+    journal_record(phys_mem, JOURNAL_EVICTION,
+                   info->type == FRAME_ANONYMOUS ? proc_list->process_ids[info->owner] : -1, info->page, frame,
+                   info->type, dirty);
+    release_frames(phys_mem, &frame, 1);
+    return 1;
+}
+
+void migrate_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int source, int destination)
+{
+    FrameInfo *info = &phys_mem->frames[source];
+    FrameInfo *moved = &phys_mem->frames[destination];
+
+    memcpy(&phys_mem->memory[destination * phys_mem->page_size], &phys_mem->memory[source * phys_mem->page_size],
+           phys_mem->page_size);
+    journal_record(phys_mem, JOURNAL_MIGRATION,
+                   info->type == FRAME_ANONYMOUS ? proc_list->process_ids[info->owner] : -1, info->page, source,
+                   destination, frame_tier(phys_mem, destination));
+
+    if (info->type == FRAME_PAGE_CACHE)
+    {
+        for (int i = 0, remapped = 0; i < proc_list->count && remapped < info->map_count; i++)
+        {
+            Process *process = &proc_list->processes[i];
+            remapped +=
+                unmap_file_page_in_tree(process, process->vma_root, phys_mem->page_shift, source, info, destination);
+        }
+        page_cache_remove(phys_mem, source);
+        *moved = *info;
+        int bucket = page_cache_bucket(phys_mem, moved->file_id, moved->page);
+        moved->cache_next = phys_mem->page_cache_buckets[bucket];
+        phys_mem->page_cache_buckets[bucket] = destination;
+        phys_mem->page_cache_pages++;
+    }
+    else
+    {
+        *moved = *info;
+        Process *owner = &proc_list->processes[info->owner];
+        pte_set(owner, info->page, PTE_WITH_FRAME(pte_get(owner, info->page), destination));
+    }
+
+    info->type = FRAME_FREE;
+    info->dirty = 0;
+    info->pinned = 0;
+    info->prefetched = 0;
+    info->swap_slot = -1;
+    info->hotness = 0;
+    push_free_frame(phys_mem, source);
+    phys_mem->stats.simulated_time_ns += COST_MIGRATION_NS;
+}
+
+int reclaim_slow_frame(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    MemoryTier *tier = &phys_mem->tiering.tiers[TIER_SLOW];
+    for (int scanned = 0; scanned < 2 * tier->number_of_frames; scanned++)
+    {
+        int frame = tier->first_frame + tier->clock_hand;
+        tier->clock_hand = (tier->clock_hand + 1) % tier->number_of_frames;
+
+        FrameInfo *info = &phys_mem->frames[frame];
+        if (info->type == FRAME_FREE || info->pinned)
+        {
+            continue;
+        }
+        if (test_and_clear_referenced(phys_mem, proc_list, frame))
+        {
+            continue;
+        }
+        if (evict_frame(phys_mem, proc_list, frame))
+        {
+            phys_mem->tiering.slow_evictions++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int demote_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame)
+{
+    MemoryTier *tier = &phys_mem->tiering.tiers[TIER_SLOW];
+    phys_mem->frames[frame].pinned = 1;
+    int available = tier->free_count > 0 || reclaim_slow_frame(phys_mem, proc_list);
+    phys_mem->frames[frame].pinned = 0;
+    if (!available)
+    {
+        return 0;
+    }
+
+    int destination = tier->free_frames[--tier->free_count];
+    migrate_frame(phys_mem, proc_list, frame, destination);
+    phys_mem->frames[destination].hotness = 0;
+    phys_mem->tiering.demotions++;
+    return 1;
+}
+
+int sample_slow_access(PhysicalMemory *phys_mem, ProcessList *proc_list, int frame)
+{
+    TierControl *tiering = &phys_mem->tiering;
+    if (++tiering->sample_counter % tiering->sample_interval != 0)
+    {
+        return frame;
+    }
+
+    FrameInfo *info = &phys_mem->frames[frame];
+    long long now = phys_mem->stats.simulated_time_ns;
+    tiering->samples++;
+    if (now - info->last_sample_ns > TIER_HOTNESS_WINDOW_NS)
+    {
+        info->hotness = 0;
+    }
+    info->hotness++;
+    info->last_sample_ns = now;
+    if (info->hotness < tiering->hotness_threshold)
+    {
+        return frame;
+    }
+
+    if (now - tiering->rate_window_start_ns >= TIER_RATE_WINDOW_NS)
+    {
+        tiering->rate_window_start_ns = now;
+        tiering->promotions_in_window = 0;
+    }
+    if (tiering->promotions_in_window >= tiering->promotion_rate)
+    {
+        tiering->promotions_throttled++;
+        return frame;
+    }
+
+    int destination;
+    info->pinned = 1;
+    int obtained = obtain_frame(phys_mem, proc_list, NULL, &destination);
+    info->pinned = 0;
+    if (!obtained)
+    {
+        return frame;
+    }
+
+    migrate_frame(phys_mem, proc_list, frame, destination);
+    phys_mem->frames[destination].hotness = 0;
+    tiering->promotions++;
+    tiering->promotions_in_window++;
+    return destination;
+}
+
+int add_slow_tier(PhysicalMemory *phys_mem, int size, int latency_ns)
+{
+    TierControl *tiering = &phys_mem->tiering;
+    int frames = size >> phys_mem->page_shift;
+    if (((long long)phys_mem->number_of_frames + frames) * phys_mem->page_size > INT_MAX ||
+        ((long long)phys_mem->number_of_frames + frames) * SWAP_SIZE_MULTIPLIER >= PTE_INDEX_LIMIT)
+    {
+        return 0;
+    }
+    int total_frames = phys_mem->number_of_frames + frames;
+    int total_slots = total_frames * SWAP_SIZE_MULTIPLIER;
+    int added_slots = total_slots - phys_mem->swap.number_of_slots;
+
+    int *free_frames = (int *)malloc(frames * sizeof(int));
+    int *buckets = (int *)malloc(total_frames * sizeof(int));
+    unsigned char *memory = resize_memory_array(&phys_mem->backing, phys_mem->memory,
+                                                (size_t)phys_mem->number_of_frames * phys_mem->page_size,
+                                                (size_t)total_frames * phys_mem->page_size);
+    if (memory != NULL)
+    {
+        phys_mem->memory = memory;
+    }
+    FrameInfo *frame_info = (FrameInfo *)realloc(phys_mem->frames, total_frames * sizeof(FrameInfo));
+    if (frame_info != NULL)
+    {
+        phys_mem->frames = frame_info;
+    }
+    unsigned char *swap_data =
+        (unsigned char *)realloc(phys_mem->swap.data, (size_t)total_slots * phys_mem->page_size);
+    if (swap_data != NULL)
+    {
+        phys_mem->swap.data = swap_data;
+    }
+    int *free_slots = (int *)realloc(phys_mem->swap.free_slots, total_slots * sizeof(int));
+    if (free_slots != NULL)
+    {
+        phys_mem->swap.free_slots = free_slots;
+    }
+    if (free_frames == NULL || buckets == NULL || memory == NULL || frame_info == NULL || swap_data == NULL ||
+        free_slots == NULL)
+    {
+        free(free_frames);
+        free(buckets);
+        return 0;
+    }
+
+    memset(&phys_mem->frames[phys_mem->number_of_frames], 0, frames * sizeof(FrameInfo));
+
+    SwapSpace *swap = &phys_mem->swap;
+    memmove(&swap->free_slots[added_slots], swap->free_slots, swap->free_slot_count * sizeof(int));
+    for (int i = 0; i < added_slots; i++)
+    {
+        swap->free_slots[i] = total_slots - 1 - i;
+    }
+    swap->free_slot_count += added_slots;
+    swap->number_of_slots = total_slots;
+
+    free(phys_mem->page_cache_buckets);
+    phys_mem->page_cache_buckets = buckets;
+    phys_mem->page_cache_bucket_count = total_frames;
+    for (int i = 0; i < total_frames; i++)
+    {
+        buckets[i] = -1;
+    }
+    for (int i = 0; i < phys_mem->number_of_frames; i++)
+    {
+        FrameInfo *info = &phys_mem->frames[i];
+        if (info->type == FRAME_PAGE_CACHE)
+        {
+            int bucket = page_cache_bucket(phys_mem, info->file_id, info->page);
+            info->cache_next = buckets[bucket];
+            buckets[bucket] = i;
+        }
+    }
+
+    MemoryTier *tier = &tiering->tiers[TIER_SLOW];
+    tier->first_frame = phys_mem->number_of_frames;
+    tier->number_of_frames = frames;
+    tier->latency_ns = latency_ns;
+    tier->free_frames = free_frames;
+    tier->free_count = 0;
+    tier->clock_hand = 0;
+    tier->accesses = 0;
+    for (int i = total_frames - 1; i >= phys_mem->number_of_frames; i--)
+    {
+        phys_mem->frames[i].swap_slot = -1;
+        tier->free_frames[tier->free_count++] = i;
+    }
+
+    phys_mem->number_of_frames = total_frames;
+    tiering->tier_count = MEMORY_TIERS;
+    journal_record(phys_mem, JOURNAL_TIER_ADDED, -1, -1, -1, total_frames, latency_ns);
+    return 1;
+}
+
+int reclaim_frames(PhysicalMemory *phys_mem, ProcessList *proc_list, int target)
+{
+    int reclaimed = 0;
+    int dram_frames = phys_mem->tiering.tiers[TIER_DRAM].number_of_frames;
+    for (int scanned = 0; reclaimed < target && scanned < 2 * dram_frames; scanned++)
+    {
+        int frame = phys_mem->clock_hand;
+        phys_mem->clock_hand = (phys_mem->clock_hand + 1) % dram_frames;
+
+        FrameInfo *info = &phys_mem->frames[frame];
+        if (info->type == FRAME_FREE || info->type == FRAME_BALLOON || info->pinned)
+        {
+            continue;
+        }
+        if (test_and_clear_referenced(phys_mem, proc_list, frame))
+        {
+            continue;
+        }
+        if ((phys_mem->tiering.tier_count > 1 && demote_frame(phys_mem, proc_list, frame)) ||
+            evict_frame(phys_mem, proc_list, frame))
+        {
+            reclaimed++;
+        }
+    }
+    return reclaimed;
+}
+
+int obtain_frame(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int *frame)
+{
+    if (phys_mem->free_frame_count == 0)
+    {
+        reclaim_frames(phys_mem, proc_list, 1);
+    }
+    return allocate_frames(phys_mem, process, 1, frame);
+}
+
+int swap_in_page(PhysicalMemory *phys_mem, int frame, int slot)
+{
+    memcpy(&phys_mem->memory[frame * phys_mem->page_size],
+           &phys_mem->swap.data[(size_t)slot * phys_mem->page_size], phys_mem->page_size);
+    phys_mem->stats.swap_ins++;
+
+    if (phys_mem->swap.free_slot_count * 2 < phys_mem->swap.number_of_slots)
+    {
+        release_swap_slot(&phys_mem->swap, slot);
+        return -1;
+    }
+    return slot;
+}
+
+int install_anonymous_page(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process,
+                           int page, int frame, int swap_slot, int prot)
+{
+    if (!pte_set(process, page, PTE_MAKE_PRESENT(frame, prot) | PTE_ACCESSED))
+    {
+        return 0;
+    }
+
+    FrameInfo *info = &phys_mem->frames[frame];
+    journal_record(phys_mem, JOURNAL_FRAME_ALLOC, process->process_id, page, frame, FRAME_ANONYMOUS, -1);
+    info->type = FRAME_ANONYMOUS;
+    info->owner = process_index(proc_list, process);
+    info->page = page;
+    info->referenced = 0;
+    info->pinned = 0;
+    info->prefetched = 0;
+    info->swap_slot = swap_slot;
+    if (swap_slot < 0)
+    {
+        mark_frame_dirty(phys_mem, frame);
+    }
+    proc_list->resident_pages[process_index(proc_list, process)]++;
+    return 1;
+}
+
+int handle_page_fault(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process,
+                      const VmArea *vma, int page, int access_type)
+{
+    int page_size = phys_mem->page_size;
+    PageTableEntry entry = pte_get(process, page);
+    int frame, slot = -1, major = 0;
+
+    if (vma->flags & VMA_FLAG_FILE && !PTE_IS_SWAPPED(entry))
+    {
+        int file_page = (vma->file_offset + ((page << phys_mem->page_shift) - vma->start)) >> phys_mem->page_shift;
+        long long major_before = phys_mem->stats.page_cache_misses;
+        int window = (phys_mem->prefetcher.flags & PREFETCH_SEQUENTIAL) ? 1 : READAHEAD_PAGES;
+        int cache_frame = PTE_IS_PRESENT(entry) ? PTE_FRAME(entry)
+                                                : page_cache_get(phys_mem, proc_list, vma->file_id, file_page, window);
+        if (cache_frame < 0)
+        {
+            return ACCESS_OUT_OF_MEMORY;
+        }
+
+        major = phys_mem->stats.page_cache_misses > major_before;
+        if (major)
+        {
+            phys_mem->stats.major_faults++;
+        }
+        else
+        {
+            phys_mem->stats.minor_faults++;
+            phys_mem->stats.simulated_time_ns += COST_MINOR_FAULT_NS;
+        }
+        phys_mem->frames[cache_frame].referenced = 1;
+
+        if (access_type == ACCESS_READ || (vma->flags & VMA_FLAG_SHARED))
+        {
+            int mapped = PTE_IS_PRESENT(pte_get(process, page));
+            if (!pte_set(process, page, PTE_MAKE_PRESENT(cache_frame, pte_protection(phys_mem, vma, cache_frame))))
+            {
+                return ACCESS_OUT_OF_MEMORY;
+            }
+            if (!mapped)
+            {
+                proc_list->resident_pages[process_index(proc_list, process)]++;
+                phys_mem->frames[cache_frame].map_count++;
+            }
+            process->page_faults++;
+            journal_record(phys_mem, JOURNAL_FAULT, process->process_id, page, cache_frame, major, access_type);
+            return ACCESS_OK;
+        }
+
+        phys_mem->frames[cache_frame].pinned = 1;
+        int obtained = obtain_frame(phys_mem, proc_list, process, &frame);
+        phys_mem->frames[cache_frame].pinned = 0;
+        if (!obtained)
+        {
+            return ACCESS_OUT_OF_MEMORY;
+        }
+
+        memcpy(&phys_mem->memory[frame * page_size], &phys_mem->memory[cache_frame * page_size], page_size);
+        if (PTE_IS_PRESENT(entry))
+        {
+            phys_mem->frames[cache_frame].map_count--;
+            proc_list->resident_pages[process_index(proc_list, process)]--;
+        }
+    }
+    else
+    {
+        if (!obtain_frame(phys_mem, proc_list, process, &frame))
+        {
+            return ACCESS_OUT_OF_MEMORY;
+        }
+
+        entry = pte_get(process, page);
+        if (PTE_IS_SWAPPED(entry))
+        {
+            slot = swap_in_page(phys_mem, frame, PTE_SWAP_SLOT(entry));
+            major = 1;
+            phys_mem->stats.major_faults++;
+            phys_mem->stats.simulated_time_ns += COST_DISK_IO_NS + COST_DISK_PAGE_NS;
+        }
+        else
+        {
+            memset(&phys_mem->memory[frame * page_size], 0, page_size);
+            phys_mem->stats.minor_faults++;
+            phys_mem->stats.simulated_time_ns += COST_MINOR_FAULT_NS;
+        }
+    }
+
+    if (!install_anonymous_page(phys_mem, proc_list, process, page, frame, slot, vma->prot))
+    {
+        release_frames(phys_mem, &frame, 1);
+        return ACCESS_OUT_OF_MEMORY;
+    }
+    process->page_faults++;
+    journal_record(phys_mem, JOURNAL_FAULT, process->process_id, page, frame, major, access_type);
+    return ACCESS_OK;
+}
+
+int access_memory(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                  int access_type, int *physical_address)
+{
+    AccessKernel kernel =
+        phys_mem->access_kernels[process->pte_directory != NULL ? PAGE_TABLE_COMPRESSED : PAGE_TABLE_FLAT];
+    return kernel(phys_mem, proc_list, process, address, access_type, physical_address);
+}
+
+int access_memory_generic(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int address,
+                          int access_type, int *physical_address)
+{
+    return access_memory_with(phys_mem, proc_list, process, address, access_type, physical_address,
+                              phys_mem->page_shift, PAGE_TABLE_ANY);
+}
+
+SPECIALIZE_INLINE int access_memory_with(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process,
+                                         int address, int access_type, int *physical_address, int shift,
+                                         int layout)
+{
+    int page = (int)((unsigned int)address >> shift);
+    int required = access_type == ACCESS_WRITE ? VMA_PROT_WRITE : VMA_PROT_READ;
+    PageTableEntry entry = address >= 0 && page < process->number_of_pages ? pte_get_layout(process, page, layout)
+                                                                           : PTE_NOT_PRESENT;
+
+    VmArea *vma = NULL;
+    if (!PTE_IS_PRESENT(entry) || !(PTE_PROT(entry) & required))
+    {
+        vma = vma_find(process->vma_root, address);
+        if (vma == NULL)
+        {
+            return ACCESS_SEGFAULT;
+        }
+        if (!(vma->prot & required))
+        {
+            return ACCESS_PROTECTION;
+        }
+    }
+
+    phys_mem->stats.accesses++;
+
+    int owner = process_index(proc_list, process);
+    int frame = PTE_IS_PRESENT(entry) ? PTE_FRAME(entry) : -1;
+    int tlb_hit = phys_mem->guest_mode || tlb_lookup(&phys_mem->tlb, owner, page, frame);
+    if (!tlb_hit)
+    {
+        phys_mem->stats.simulated_time_ns += page_walk(phys_mem, owner, page);
+    }
+
+    if (vma != NULL && (!PTE_IS_PRESENT(entry) ||
+                        (access_type == ACCESS_WRITE && pte_protection(phys_mem, vma, frame) != vma->prot)))
+    {
+        int result = handle_page_fault(phys_mem, proc_list, process, vma, page, access_type);
+        if (result != ACCESS_OK)
+        {
+            return result;
+        }
+        frame = PTE_FRAME(pte_get(process, page));
+        tlb_hit = phys_mem->guest_mode;
+
+        if (phys_mem->prefetcher.flags)
+        {
+            phys_mem->prefetcher.demand_faults++;
+            phys_mem->frames[frame].pinned = 1;
+            prefetch_on_fault(phys_mem, proc_list, process, page);
+            phys_mem->frames[frame].pinned = 0;
+        }
+    }
+    else
+    {
+        if (vma != NULL)
+        {
+            pte_set(process, page, PTE_WITH_PROT(entry, vma->prot));
+        }
+        if (phys_mem->frames[frame].prefetched)
+        {
+            phys_mem->frames[frame].pinned = 1;
+            prefetch_on_hit(phys_mem, proc_list, process, page);
+            phys_mem->frames[frame].pinned = 0;
+        }
+    }
+
+    phys_mem->frames[frame].referenced = 1;
+    if (access_type == ACCESS_WRITE && mark_frame_dirty(phys_mem, frame))
+    {
+        phys_mem->frames[frame].pinned = 1;
+        balance_dirty_pages(phys_mem);
+        phys_mem->frames[frame].pinned = 0;
+    }
+
+    if (phys_mem->tiering.tier_count > 1 && frame_tier(phys_mem, frame) == TIER_SLOW)
+    {
+        int promoted = sample_slow_access(phys_mem, proc_list, frame);
+        tlb_hit = tlb_hit && promoted == frame;
+        frame = promoted;
+    }
+
+    pte_set(process, page, pte_get(process, page) | PTE_ACCESSED | (access_type == ACCESS_WRITE ? PTE_DIRTY : 0));
+    if (!tlb_hit)
+    {
+        tlb_insert(&phys_mem->tlb, owner, page, frame);
+    }
+
+    *physical_address = (frame << shift) | (address & ((1 << shift) - 1));
+    if (!phys_mem->guest_mode)
+    {
+        phys_mem->stats.simulated_time_ns += memory_reference_cost(phys_mem, *physical_address, 0);
+    }
+    return ACCESS_OK;
+}
+
+int translate_batch(const PhysicalMemory *phys_mem, const ProcessList *proc_list, int pid, const int *vaddrs,
+                    int count, int *out_paddrs, uint64_t *fault_mask)
+{
+    const Process *process = find_process(proc_list, pid);
+    if (process == NULL || count < 0)
+    {
+        return -1;
+    }
+
+    memset(fault_mask, 0, ((size_t)count + 63) / 64 * sizeof(uint64_t));
+    TranslateKernel kernel =
+        phys_mem->translate_kernels[process->pte_directory != NULL ? PAGE_TABLE_COMPRESSED : PAGE_TABLE_FLAT];
+    return kernel(process, phys_mem->page_shift, vaddrs, count, out_paddrs, fault_mask);
+}
+
+int translate_range_scalar(const Process *process, int page_shift, const int *vaddrs, int first, int count,
+                           int *out_paddrs, uint64_t *fault_mask)
+{
+    return translate_range_with(process, page_shift, PAGE_TABLE_ANY, vaddrs, first, count, out_paddrs, fault_mask);
+}
+
+SPECIALIZE_INLINE int translate_range_with(const Process *process, int shift, int layout, const int *vaddrs,
+                                           int first, int count, int *out_paddrs, uint64_t *fault_mask)
+{
+    int faults = 0;
+    for (int i = first; i < count; i++)
+    {
+        int page = (int)((unsigned int)vaddrs[i] >> shift);
+        PageTableEntry entry = vaddrs[i] >= 0 && page < process->number_of_pages
+                                   ? pte_get_layout(process, page, layout)
+                                   : PTE_NOT_PRESENT;
+        if ((entry & PTE_READABLE) == PTE_READABLE)
+        {
+            out_paddrs[i] = (PTE_FRAME(entry) << shift) | (vaddrs[i] & ((1 << shift) - 1));
+        }
+        else
+        {
+            out_paddrs[i] = -1;
+            fault_mask[i / 64] |= 1ULL << (i % 64);
+            faults++;
+        }
+    }
+    return faults;
+}
+
+int translate_batch_scalar(const Process *process, int page_shift, const int *vaddrs, int count, int *out_paddrs,
+                           uint64_t *fault_mask)
+{
+    return translate_range_scalar(process, page_shift, vaddrs, 0, count, out_paddrs, fault_mask);
+}
+
+#ifdef SIMD_X86
+__attribute__((target("avx2"))) SPECIALIZE_INLINE int translate_avx2_with(const Process *process, int shift,
+                                                                          int layout, const int *vaddrs, int count,
+                                                                          int *out_paddrs, uint64_t *fault_mask)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i not_negative = _mm256_set1_epi32(-1);
+    const __m256i pages = _mm256_set1_epi32(process->number_of_pages);
+    const __m256i offset_mask = _mm256_set1_epi32((1 << shift) - 1);
+    const __m256i chunk_mask = _mm256_set1_epi32(PTE_CHUNK_ENTRIES - 1);
+    const __m256i readable = _mm256_set1_epi32((int)PTE_READABLE);
+    const int *table = (const int *)process->page_table;
+    int compressed = layout == PAGE_TABLE_ANY ? process->pte_directory != NULL : layout == PAGE_TABLE_COMPRESSED;
+    int faults = 0, i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i address = _mm256_loadu_si256((const __m256i *)&vaddrs[i]);
+        __m256i page = _mm256_srli_epi32(address, shift);
+        __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(address, not_negative), _mm256_cmpgt_epi32(pages, page));
+        __m256i entry;
+        if (!compressed)
+        {
+            entry = _mm256_mask_i32gather_epi32(zero, table, page, valid, 4);
+        }
+        else
+        {
+            __m256i chunk = _mm256_mask_i32gather_epi32(zero, (const int *)process->pte_directory,
+                                                        _mm256_srli_epi32(page, PTE_CHUNK_SHIFT), valid, 4);
+            __m256i populated = _mm256_andnot_si256(_mm256_cmpeq_epi32(chunk, zero), valid);
+            __m256i index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(chunk, _mm256_set1_epi32(1)),
+                                                               PTE_CHUNK_SHIFT),
+                                             _mm256_and_si256(page, chunk_mask));
+            entry = _mm256_mask_i32gather_epi32(zero, table, index, populated, 4);
+        }
+
+        __m256i translated = _mm256_cmpeq_epi32(_mm256_and_si256(entry, readable), readable);
+        __m256i physical = _mm256_or_si256(_mm256_slli_epi32(_mm256_srli_epi32(entry, PTE_INDEX_SHIFT), shift),
+                                           _mm256_and_si256(address, offset_mask));
+        physical = _mm256_blendv_epi8(not_negative, physical, translated);
+        _mm256_storeu_si256((__m256i *)&out_paddrs[i], physical);
+
+        unsigned int missed = ~(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(translated)) & 0xFFu;
+        fault_mask[i / 64] |= (uint64_t)missed << (i % 64);
+        faults += __builtin_popcount(missed);
+    }
+    return faults + translate_range_with(process, shift, layout, vaddrs, i, count, out_paddrs, fault_mask);
+}
+
+__attribute__((target("avx2"))) int translate_batch_avx2(const Process *process, int page_shift, const int *vaddrs,
+                                                          int count, int *out_paddrs, uint64_t *fault_mask)
+{
+    return translate_avx2_with(process, page_shift, PAGE_TABLE_ANY, vaddrs, count, out_paddrs, fault_mask);
+}
+
+__attribute__((target("avx512f"))) SPECIALIZE_INLINE int translate_avx512_with(const Process *process, int shift,
+                                                                               int layout, const int *vaddrs,
+                                                                               int count, int *out_paddrs,
+                                                                               uint64_t *fault_mask)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i not_negative = _mm512_set1_epi32(-1);
+    const __m512i pages = _mm512_set1_epi32(process->number_of_pages);
+    const __m512i offset_mask = _mm512_set1_epi32((1 << shift) - 1);
+    const __m512i chunk_mask = _mm512_set1_epi32(PTE_CHUNK_ENTRIES - 1);
+    const __m512i readable = _mm512_set1_epi32((int)PTE_READABLE);
+    const int *table = (const int *)process->page_table;
+    int compressed = layout == PAGE_TABLE_ANY ? process->pte_directory != NULL : layout == PAGE_TABLE_COMPRESSED;
+    int faults = 0, i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512i address = _mm512_loadu_si512(&vaddrs[i]);
+        __m512i page = _mm512_srli_epi32(address, shift);
+        __mmask16 valid = _mm512_cmpgt_epi32_mask(address, not_negative) & _mm512_cmpgt_epi32_mask(pages, page);
+        __m512i entry;
+        if (!compressed)
+        {
+            entry = _mm512_mask_i32gather_epi32(zero, valid, page, table, 4);
+        }
+        else
+        {
+            __m512i chunk = _mm512_mask_i32gather_epi32(zero, valid, _mm512_srli_epi32(page, PTE_CHUNK_SHIFT),
+                                                        (const int *)process->pte_directory, 4);
+            __mmask16 populated = valid & _mm512_cmpneq_epi32_mask(chunk, zero);
+            __m512i index = _mm512_add_epi32(_mm512_slli_epi32(_mm512_sub_epi32(chunk, _mm512_set1_epi32(1)),
+                                                               PTE_CHUNK_SHIFT),
+                                             _mm512_and_si512(page, chunk_mask));
+            entry = _mm512_mask_i32gather_epi32(zero, populated, index, table, 4);
+        }
+
+        __mmask16 translated = _mm512_cmpeq_epi32_mask(_mm512_and_si512(entry, readable), readable);
+        __m512i physical = _mm512_or_si512(_mm512_slli_epi32(_mm512_srli_epi32(entry, PTE_INDEX_SHIFT), shift),
+                                           _mm512_and_si512(address, offset_mask));
+        _mm512_storeu_si512(&out_paddrs[i], _mm512_mask_mov_epi32(not_negative, translated, physical));
+
+        unsigned int missed = ~(unsigned int)translated & 0xFFFFu;
+        fault_mask[i / 64] |= (uint64_t)missed << (i % 64);
+        faults += __builtin_popcount(missed);
+    }
+    return faults + translate_range_with(process, shift, layout, vaddrs, i, count, out_paddrs, fault_mask);
+}
+
+__attribute__((target("avx512f"))) int translate_batch_avx512(const Process *process, int page_shift,
+                                                               const int *vaddrs, int count, int *out_paddrs,
+                                                               uint64_t *fault_mask)
+{
+    return translate_avx512_with(process, page_shift, PAGE_TABLE_ANY, vaddrs, count, out_paddrs, fault_mask);
+}
+#endif
+
+DEFINE_TRANSLATE_KERNEL(translate_4k_flat, 12, PAGE_TABLE_FLAT)
+DEFINE_TRANSLATE_KERNEL(translate_4k_compressed, 12, PAGE_TABLE_COMPRESSED)
+DEFINE_TRANSLATE_KERNEL(translate_16k_flat, 14, PAGE_TABLE_FLAT)
+DEFINE_TRANSLATE_KERNEL(translate_16k_compressed, 14, PAGE_TABLE_COMPRESSED)
+DEFINE_TRANSLATE_KERNEL(translate_64k_flat, 16, PAGE_TABLE_FLAT)
+DEFINE_TRANSLATE_KERNEL(translate_64k_compressed, 16, PAGE_TABLE_COMPRESSED)
+DEFINE_TRANSLATE_KERNEL(translate_2m_flat, 21, PAGE_TABLE_FLAT)
+DEFINE_TRANSLATE_KERNEL(translate_2m_compressed, 21, PAGE_TABLE_COMPRESSED)
+
+#ifdef SIMD_X86
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_4k_flat, avx2, "avx2", 12, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_4k_compressed, avx2, "avx2", 12, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_16k_flat, avx2, "avx2", 14, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_16k_compressed, avx2, "avx2", 14, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_64k_flat, avx2, "avx2", 16, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_64k_compressed, avx2, "avx2", 16, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_2m_flat, avx2, "avx2", 21, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx2_2m_compressed, avx2, "avx2", 21, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_4k_flat, avx512, "avx512f", 12, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_4k_compressed, avx512, "avx512f", 12, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_16k_flat, avx512, "avx512f", 14, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_16k_compressed, avx512, "avx512f", 14, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_64k_flat, avx512, "avx512f", 16, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_64k_compressed, avx512, "avx512f", 16, PAGE_TABLE_COMPRESSED)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_2m_flat, avx512, "avx512f", 21, PAGE_TABLE_FLAT)
+DEFINE_VECTOR_TRANSLATE_KERNEL(translate_avx512_2m_compressed, avx512, "avx512f", 21, PAGE_TABLE_COMPRESSED)
+#endif
+
+DEFINE_ACCESS_KERNEL(access_4k_flat, 12, PAGE_TABLE_FLAT)
+DEFINE_ACCESS_KERNEL(access_4k_compressed, 12, PAGE_TABLE_COMPRESSED)
+DEFINE_ACCESS_KERNEL(access_16k_flat, 14, PAGE_TABLE_FLAT)
+DEFINE_ACCESS_KERNEL(access_16k_compressed, 14, PAGE_TABLE_COMPRESSED)
+DEFINE_ACCESS_KERNEL(access_64k_flat, 16, PAGE_TABLE_FLAT)
+DEFINE_ACCESS_KERNEL(access_64k_compressed, 16, PAGE_TABLE_COMPRESSED)
+DEFINE_ACCESS_KERNEL(access_2m_flat, 21, PAGE_TABLE_FLAT)
+DEFINE_ACCESS_KERNEL(access_2m_compressed, 21, PAGE_TABLE_COMPRESSED)
+
+#ifdef SIMD_X86
+#define TRANSLATE_KERNEL_SET(size, shift, label)                                                            \
+    {                                                                                                       \
+        shift,                                                                                              \
+        {{translate_##size##_flat, translate_##size##_compressed},                                          \
+         {translate_avx2_##size##_flat, translate_avx2_##size##_compressed},                                \
+         {translate_avx512_##size##_flat, translate_avx512_##size##_compressed}},                           \
+        {access_##size##_flat, access_##size##_compressed},                                                 \
+        {"scalar " label, "AVX2 " label, "AVX-512 " label},                                                 \
+    }
+#else
+#define TRANSLATE_KERNEL_SET(size, shift, label)                                                            \
+    {                                                                                                       \
+        shift,                                                                                              \
+        {{translate_##size##_flat, translate_##size##_compressed},                                          \
+         {translate_##size##_flat, translate_##size##_compressed},                                          \
+         {translate_##size##_flat, translate_##size##_compressed}},                                         \
+        {access_##size##_flat, access_##size##_compressed},                                                 \
+        {"scalar " label, "scalar " label, "scalar " label},                                                \
+    }
+#endif
+
+void select_translate_kernels(PhysicalMemory *phys_mem)
+{
+    static const TranslateKernelSet specialized[] = {
+        TRANSLATE_KERNEL_SET(4k, 12, "4K"),
+        TRANSLATE_KERNEL_SET(16k, 14, "16K"),
+        TRANSLATE_KERNEL_SET(64k, 16, "64K"),
+        TRANSLATE_KERNEL_SET(2m, 21, "2M"),
+    };
+#ifdef SIMD_X86
+    static const TranslateKernelSet generic = {
+        0,
+        {{translate_batch_scalar, translate_batch_scalar},
+         {translate_batch_avx2, translate_batch_avx2},
+         {translate_batch_avx512, translate_batch_avx512}},
+        {access_memory_generic, access_memory_generic},
+        {"scalar", "AVX2", "AVX-512"},
+    };
+#else
+    static const TranslateKernelSet generic = {
+        0,
+        {{translate_batch_scalar, translate_batch_scalar},
+         {translate_batch_scalar, translate_batch_scalar},
+         {translate_batch_scalar, translate_batch_scalar}},
+        {access_memory_generic, access_memory_generic},
+        {"scalar", "scalar", "scalar"},
+    };
+#endif
+
+    int isa = TRANSLATE_ISA_SCALAR;
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        isa = TRANSLATE_ISA_AVX512;
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        isa = TRANSLATE_ISA_AVX2;
+    }
+#endif
+
+    const TranslateKernelSet *set = &generic;
+    for (int i = 0; i < (int)(sizeof(specialized) / sizeof(specialized[0])); i++)
+    {
+        if (specialized[i].page_shift == phys_mem->page_shift)
+        {
+            set = &specialized[i];
+            break;
+        }
+    }
+    for (int layout = 0; layout < PAGE_TABLE_LAYOUTS; layout++)
+    {
+        phys_mem->translate_kernels[layout] = set->kernels[isa][layout];
+        phys_mem->access_kernels[layout] = set->access_kernels[layout];
+    }
+    phys_mem->translate_kernel_name = set->names[isa];
+}
+
+void translate_batch_menu(const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    printf("\n=== Translate Address Batch ===\n");
+    Process *process = prompt_for_process(proc_list);
+    int start, stride, count;
+    if (process == NULL || !read_int("Enter first virtual address: ", &start) ||
+        !read_int("Enter stride in bytes: ", &stride) || !read_int("Enter number of addresses: ", &count))
+    {
+        return;
+    }
+    if (count < 1 || count > TRANSLATE_BATCH_MAX)
+    {
+        printf("Error: Number of addresses must be between 1 and %d.\n", TRANSLATE_BATCH_MAX);
+        return;
+    }
+
+    int *vaddrs = (int *)malloc(count * sizeof(int));
+    int *paddrs = (int *)malloc(count * sizeof(int));
+    uint64_t *fault_mask = (uint64_t *)malloc(((size_t)count + 63) / 64 * sizeof(uint64_t));
+    if (vaddrs == NULL || paddrs == NULL || fault_mask == NULL)
+    {
+        printf("Error: Unable to allocate the address batch.\n");
+        free(vaddrs);
+        free(paddrs);
+        free(fault_mask);
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        vaddrs[i] = (int)((long long)start + (long long)i * stride);
+    }
+
+    clock_t started = clock();
+    int faults = translate_batch(phys_mem, proc_list, process->process_id, vaddrs, count, paddrs, fault_mask);
+    double seconds = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+    printf("Virtual\t\tPhysical\n");
+    for (int i = 0; i < count && i < TRANSLATE_BATCH_SHOWN; i++)
+    {
+        if (fault_mask[i / 64] & (1ULL << (i % 64)))
+        {
+            printf("0x%08x\tfault\n", vaddrs[i]);
+        }
+        else
+        {
+            printf("0x%08x\t0x%08x\n", vaddrs[i], paddrs[i]);
+        }
+    }
+    if (count > TRANSLATE_BATCH_SHOWN)
+    {
+        printf("... %d more addresses\n", count - TRANSLATE_BATCH_SHOWN);
+    }
+    printf("Translated: %d, Faults: %d (%s kernel, %.3f ms)\n", count - faults, faults,
+           phys_mem->translate_kernel_name, seconds * 1e3);
+
+    free(vaddrs);
+    free(paddrs);
+    free(fault_mask);
+}
+
+void initialize_prefetcher(Prefetcher *prefetcher)
+{
+    prefetcher->flags = 0;
+    prefetcher->max_window = PREFETCH_DEFAULT_MAX_WINDOW;
+    prefetcher->issued = 0;
+    prefetcher->useful = 0;
+    prefetcher->polluted = 0;
+    prefetcher->demand_faults = 0;
+    prefetcher->io_time_ns = 0;
+
+    prefetcher->markov_table = (MarkovEntry *)malloc(MARKOV_TABLE_SIZE * sizeof(MarkovEntry));
+    if (prefetcher->markov_table == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate the prefetcher correlation table.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < MARKOV_TABLE_SIZE; i++)
+    {
+        prefetcher->markov_table[i].owner = -1;
+        prefetcher->markov_table[i].page = -1;
+        for (int j = 0; j < MARKOV_SUCCESSORS; j++)
+        {
+            prefetcher->markov_table[i].successors[j] = -1;
+        }
+    }
+}
+
+int prefetch_page(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int page)
+{
+    if (page < 0 || page >= process->number_of_pages || PTE_IS_PRESENT(pte_get(process, page)))
+    {
+        return 0;
+    }
+
+    VmArea *vma = vma_find(process->vma_root, page << phys_mem->page_shift);
+    PageTableEntry entry = pte_get(process, page);
+    if (vma == NULL || !(vma->prot & VMA_PROT_READ) ||
+        (!(vma->flags & VMA_FLAG_FILE) && !PTE_IS_SWAPPED(entry)))
+    {
+        return 0;
+    }
+
+    long long time_before = phys_mem->stats.simulated_time_ns;
+    int frame;
+
+    if (PTE_IS_SWAPPED(entry))
+    {
+        if (!obtain_frame(phys_mem, proc_list, process, &frame))
+        {
+            return 0;
+        }
+        int slot = swap_in_page(phys_mem, frame, PTE_SWAP_SLOT(entry));
+        phys_mem->stats.simulated_time_ns += COST_DISK_IO_NS + COST_DISK_PAGE_NS;
+        if (!install_anonymous_page(phys_mem, proc_list, process, page, frame, slot, vma->prot))
+        {
+            release_frames(phys_mem, &frame, 1);
+            phys_mem->stats.simulated_time_ns = time_before;
+            return 0;
+        }
+    }
+    else
+    {
+        int file_page = (vma->file_offset + ((page << phys_mem->page_shift) - vma->start)) >> phys_mem->page_shift;
+        frame = page_cache_get(phys_mem, proc_list, vma->file_id, file_page, 1);
+        if (frame < 0)
+        {
+            return 0;
+        }
+        if (!pte_set(process, page, PTE_MAKE_PRESENT(frame, pte_protection(phys_mem, vma, frame))))
+        {
+            phys_mem->stats.simulated_time_ns = time_before;
+            return 0;
+        }
+        proc_list->resident_pages[process_index(proc_list, process)]++;
+        phys_mem->frames[frame].map_count++;
+        phys_mem->frames[frame].referenced = 1;
+    }
+
+    phys_mem->frames[frame].prefetched = 1;
+    phys_mem->prefetcher.issued++;
+    phys_mem->prefetcher.io_time_ns += phys_mem->stats.simulated_time_ns - time_before;
+    phys_mem->stats.simulated_time_ns = time_before;
+    return 1;
+}
+
+void prefetch_range(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int start, int count)
+{
+    for (int page = start; page < start + count && page < process->number_of_pages; page++)
+    {
+        prefetch_page(phys_mem, proc_list, process, page);
+    }
+}
+
+int markov_slot(int owner, int page)
+{
+    unsigned int hash = (unsigned int)owner * 2246822519u ^ (unsigned int)page * 2654435761u;
+    return (int)(hash % MARKOV_TABLE_SIZE);
+}
+
+void prefetch_on_fault(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int page)
+{
+    Prefetcher *prefetcher = &phys_mem->prefetcher;
+    int owner = process_index(proc_list, process);
+    int previous = process->last_fault_page;
+    int delta = previous >= 0 ? page - previous : 0;
+    process->last_fault_page = page;
+
+    if (prefetcher->flags & PREFETCH_SEQUENTIAL)
+    {
+        if (delta == 1 || page == process->readahead_end)
+        {
+            int window = process->readahead_window == 0 ? PREFETCH_INITIAL_WINDOW : process->readahead_window * 2;
+            process->readahead_window = window < prefetcher->max_window ? window : prefetcher->max_window;
+            process->readahead_end = page + 1 + process->readahead_window;
+            process->readahead_marker = page + 1 + process->readahead_window / 2;
+            prefetch_range(phys_mem, proc_list, process, page + 1, process->readahead_window);
+        }
+        else
+        {
+            process->readahead_window = 0;
+            process->readahead_end = -1;
+            process->readahead_marker = -1;
+        }
+    }
+
+    if (prefetcher->flags & PREFETCH_STRIDE)
+    {
+        if (delta != 0 && delta == process->stride)
+        {
+            process->stride_confidence++;
+        }
+        else
+        {
+            process->stride = delta;
+            process->stride_confidence = 0;
+        }
+
+        if (process->stride_confidence >= PREFETCH_STRIDE_CONFIDENCE && (delta > 1 || delta < -1))
+        {
+            for (int i = 1; i <= PREFETCH_STRIDE_DEGREE; i++)
+            {
+                prefetch_page(phys_mem, proc_list, process, page + i * delta);
+            }
+        }
+    }
+
+    if (prefetcher->flags & PREFETCH_MARKOV)
+    {
+        if (previous >= 0)
+        {
+            MarkovEntry *history = &prefetcher->markov_table[markov_slot(owner, previous)];
+            if (history->owner != owner || history->page != previous)
+            {
+                history->owner = owner;
+                history->page = previous;
+                for (int i = 0; i < MARKOV_SUCCESSORS; i++)
+                {
+                    history->successors[i] = -1;
+                }
+            }
+            if (history->successors[0] != page)
+            {
+                for (int i = MARKOV_SUCCESSORS - 1; i > 0; i--)
+                {
+                    history->successors[i] = history->successors[i - 1];
+                }
+                history->successors[0] = page;
+            }
+        }
+
+        const MarkovEntry *prediction = &prefetcher->markov_table[markov_slot(owner, page)];
+        if (prediction->owner == owner && prediction->page == page)
+        {
+            for (int i = 0; i < MARKOV_SUCCESSORS && prediction->successors[i] >= 0; i++)
+            {
+                prefetch_page(phys_mem, proc_list, process, prediction->successors[i]);
+            }
+        }
+    }
+}
+
+void prefetch_on_hit(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int page)
+{
+    Prefetcher *prefetcher = &phys_mem->prefetcher;
+    phys_mem->frames[PTE_FRAME(pte_get(process, page))].prefetched = 0;
+    prefetcher->useful++;
+
+    if ((prefetcher->flags & PREFETCH_SEQUENTIAL) && page == process->readahead_marker)
+    {
+        int window = process->readahead_window * 2;
+        int start = process->readahead_end;
+        process->readahead_window = window < prefetcher->max_window ? window : prefetcher->max_window;
+        process->readahead_end = start + process->readahead_window;
+        process->readahead_marker = start;
+        prefetch_range(phys_mem, proc_list, process, start, process->readahead_window);
+    }
+}
+
+int parse_trace_line(const char *line, int *pid, int *access_type, int *address)
+{
+    char type[INPUT_BUFFER_SIZE];
+    while (*line == ' ' || *line == '\t')
+    {
+        line++;
+    }
+    if (*line == '\0' || *line == '\n' || *line == '\r' || *line == '#')
+    {
+        return 0;
+    }
+
+    if (sscanf(line, "%d %99s %i", pid, type, address) != 3 ||
+        (strcmp(type, "r") != 0 && strcmp(type, "R") != 0 && strcmp(type, "w") != 0 && strcmp(type, "W") != 0))
+    {
+        return -1;
+    }
+    *access_type = (type[0] == 'w' || type[0] == 'W') ? ACCESS_WRITE : ACCESS_READ;
+    return 1;
+}
+
+void replay_reference(PhysicalMemory *phys_mem, ProcessList *proc_list, int pid, int access_type,
+                      int address, ReplayResult *result)
+{
+    Process *process = find_process(proc_list, pid);
+    if (process == NULL)
+    {
+        result->unknown_processes++;
+        return;
+    }
+    replay_process_reference(phys_mem, proc_list, process, access_type, address, result);
+}
+
+void replay_process_reference(PhysicalMemory *phys_mem, ProcessList *proc_list, Process *process, int access_type,
+                              int address, ReplayResult *result)
+{
+    int faults_before = process->page_faults;
+    int physical_address;
+    result->references++;
+
+    switch (access_memory(phys_mem, proc_list, process, address, access_type, &physical_address))
+    {
+    case ACCESS_OK:
+        if (access_type == ACCESS_WRITE)
+        {
+            phys_mem->memory[physical_address] = (unsigned char)address;
+        }
+        result->faults += process->page_faults - faults_before;
+        break;
+    case ACCESS_SEGFAULT:
+        result->segfaults++;
+        break;
+    case ACCESS_PROTECTION:
+        result->protection_faults++;
+        break;
+    case ACCESS_OUT_OF_MEMORY:
+        result->out_of_memory++;
+        break;
+    }
+}
+
+void replay_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, ReplayResult *result,
+                  TimeSeries *series)
+{
+    char line[TRACE_LINE_SIZE];
+    long long time_before = phys_mem->stats.simulated_time_ns;
+    memset(result, 0, sizeof(ReplayResult));
+    if (series != NULL)
+    {
+        timeseries_sample(series, phys_mem, proc_list, 0);
+    }
+
+    while (fgets(line, sizeof(line), trace) != NULL)
+    {
+        int pid, access_type, address;
+        int parsed = parse_trace_line(line, &pid, &access_type, &address);
+        if (parsed < 0)
+        {
+            result->malformed_lines++;
+        }
+        else if (parsed > 0)
+        {
+            replay_reference(phys_mem, proc_list, pid, access_type, address, result);
+            if (series != NULL && (result->references >= series->next_reference ||
+                                   phys_mem->stats.simulated_time_ns >= series->next_time_ns))
+            {
+                timeseries_sample(series, phys_mem, proc_list, result->references);
+            }
+        }
+    }
+
+    if (series != NULL && series->last_references != result->references)
+    {
+        timeseries_sample(series, phys_mem, proc_list, result->references);
+    }
+    result->simulated_time_ns = phys_mem->stats.simulated_time_ns - time_before;
+}
+
+void schedule_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, ReplayResult *result,
+                    TimeSeries *series)
+{
+    Scheduler *scheduler = &phys_mem->scheduler;
+    char line[TRACE_LINE_SIZE];
+    long long time_before = phys_mem->stats.simulated_time_ns;
+    memset(result, 0, sizeof(ReplayResult));
+
+    ReferenceStream *streams = (ReferenceStream *)calloc(proc_list->count > 0 ? proc_list->count : 1,
+                                                         sizeof(ReferenceStream));
+    if (streams == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate the reference streams.\n");
+        return;
+    }
+
+    while (fgets(line, sizeof(line), trace) != NULL)
+    {
+        int pid, access_type, address;
+        int parsed = parse_trace_line(line, &pid, &access_type, &address);
+        Process *process = parsed > 0 ? find_process(proc_list, pid) : NULL;
+        if (parsed < 0)
+        {
+            result->malformed_lines++;
+        }
+        else if (parsed > 0 && process == NULL)
+        {
+            result->unknown_processes++;
+        }
+        else if (parsed > 0)
+        {
+            ReferenceStream *stream = &streams[process_index(proc_list, process)];
+            if (stream->count == stream->capacity)
+            {
+                int capacity = stream->capacity > 0 ? stream->capacity * 2 : INITIAL_STREAM_CAPACITY;
+                TraceReference *grown =
+                    (TraceReference *)realloc(stream->references, capacity * sizeof(TraceReference));
+                if (grown == NULL)
+                {
+                    fprintf(stderr, "Error: Unable to buffer the trace; replaying what was read.\n");
+                    break;
+                }
+                stream->references = grown;
+                stream->capacity = capacity;
+            }
+            stream->references[stream->count].access_type = access_type;
+            stream->references[stream->count++].address = address;
+        }
+    }
+
+    long long min_vruntime = LLONG_MAX;
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        if (streams[i].count > 0 && proc_list->vruntimes[i] < min_vruntime)
+        {
+            min_vruntime = proc_list->vruntimes[i];
+        }
+    }
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        if (streams[i].count > 0)
+        {
+            proc_list->vruntimes[i] -= min_vruntime;
+        }
+    }
+
+    if (series != NULL)
+    {
+        timeseries_sample(series, phys_mem, proc_list, 0);
+    }
+
+    /* Nothing is running when a replay starts, so the first dispatch is not charged to the last run's process */
+    scheduler->current = -1;
+    int slice, next;
+    while ((next = pick_next_process(scheduler, proc_list, streams, &slice)) >= 0)
+    {
+        Process *process = &proc_list->processes[next];
+        ReferenceStream *stream = &streams[next];
+        context_switch(phys_mem, next);
+
+        long long started_ns = phys_mem->stats.simulated_time_ns;
+        int ran = 0;
+        for (; ran < slice && stream->next < stream->count; ran++)
+        {
+            const TraceReference *reference = &stream->references[stream->next++];
+            replay_process_reference(phys_mem, proc_list, process, reference->access_type, reference->address,
+                                     result);
+            if (series != NULL && (result->references >= series->next_reference ||
+                                   phys_mem->stats.simulated_time_ns >= series->next_time_ns))
+            {
+                timeseries_sample(series, phys_mem, proc_list, result->references);
+            }
+        }
+
+        proc_list->quanta[next]++;
+        proc_list->scheduled_references[next] += ran;
+        proc_list->cpu_time_ns[next] += phys_mem->stats.simulated_time_ns - started_ns;
+        proc_list->vruntimes[next] += (long long)ran * SCHED_NICE_0_WEIGHT / proc_list->weights[next];
+    }
+
+    if (series != NULL && series->last_references != result->references)
+    {
+        timeseries_sample(series, phys_mem, proc_list, result->references);
+    }
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        free(streams[i].references);
+    }
+    free(streams);
+    result->simulated_time_ns = phys_mem->stats.simulated_time_ns - time_before;
+}
+
+void initialize_scheduler(Scheduler *scheduler)
+{
+    scheduler->policy = SCHED_NONE;
+    scheduler->quantum = SCHED_DEFAULT_QUANTUM;
+    scheduler->target_latency = SCHED_DEFAULT_LATENCY;
+    scheduler->min_granularity = SCHED_DEFAULT_MIN_GRANULARITY;
+    scheduler->context_switch_ns = SCHED_DEFAULT_SWITCH_NS;
+    scheduler->tlb_mode = SCHED_TLB_ASID;
+    scheduler->asid_count = SCHED_DEFAULT_ASIDS;
+    for (int i = 0; i < SCHED_MAX_ASIDS; i++)
+    {
+        scheduler->asid_owners[i] = -1;
+        scheduler->asid_last_used[i] = 0;
+    }
+    scheduler->asid_clock = 0;
+    scheduler->current = -1;
+    scheduler->context_switches = 0;
+    scheduler->tlb_flushes = 0;
+    scheduler->asid_recycles = 0;
+    scheduler->switch_time_ns = 0;
+}
+
+int pick_next_process(const Scheduler *scheduler, const ProcessList *proc_list, const ReferenceStream *streams,
+                      int *slice)
+{
+    int next = -1;
+    if (scheduler->policy == SCHED_ROUND_ROBIN)
+    {
+        for (int offset = 1; offset <= proc_list->count && next < 0; offset++)
+        {
+            int candidate = (scheduler->current + offset) % proc_list->count;
+            if (candidate >= 0 && streams[candidate].next < streams[candidate].count)
+            {
+                next = candidate;
+            }
+        }
+        *slice = scheduler->quantum;
+        return next;
+    }
+
+    long long total_weight = 0;
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        if (streams[i].next < streams[i].count)
+        {
+            total_weight += proc_list->weights[i];
+            if (next < 0 || proc_list->vruntimes[i] < proc_list->vruntimes[next])
+            {
+                next = i;
+            }
+        }
+    }
+    if (next >= 0)
+    {
+        *slice = (int)((long long)scheduler->target_latency * proc_list->weights[next] / total_weight);
+        if (*slice < scheduler->min_granularity)
+        {
+            *slice = scheduler->min_granularity;
+        }
+    }
+    return next;
+}
+
+void context_switch(PhysicalMemory *phys_mem, int next)
+{
+    Scheduler *scheduler = &phys_mem->scheduler;
+    if (scheduler->current == next)
+    {
+        return;
+    }
+
+    scheduler->context_switches++;
+    scheduler->switch_time_ns += scheduler->context_switch_ns;
+    phys_mem->stats.simulated_time_ns += scheduler->context_switch_ns;
+    scheduler->current = next;
+
+    if (scheduler->tlb_mode == SCHED_TLB_FLUSH)
+    {
+        flush_translations(phys_mem, -1);
+        scheduler->tlb_flushes++;
+        return;
+    }
+
+    int asid = 0;
+    for (int i = 0; i < scheduler->asid_count; i++)
+    {
+        if (scheduler->asid_owners[i] == next)
+        {
+            asid = i;
+            break;
+        }
+        if (scheduler->asid_owners[asid] >= 0 &&
+            (scheduler->asid_owners[i] < 0 || scheduler->asid_last_used[i] < scheduler->asid_last_used[asid]))
+        {
+            asid = i;
+        }
+    }
+    if (scheduler->asid_owners[asid] != next)
+    {
+        if (scheduler->asid_owners[asid] >= 0)
+        {
+            flush_translations(phys_mem, scheduler->asid_owners[asid]);
+            scheduler->asid_recycles++;
+        }
+        scheduler->asid_owners[asid] = next;
+    }
+    scheduler->asid_last_used[asid] = ++scheduler->asid_clock;
+}
+
+void flush_translations(PhysicalMemory *phys_mem, int owner)
+{
+    Tlb *tlb = &phys_mem->tlb;
+    for (int i = 0; i < tlb->number_of_entries; i++)
+    {
+        if (owner < 0 || tlb->entries[i].owner == owner)
+        {
+            tlb->entries[i].owner = -1;
+            tlb->entries[i].page = -1;
+            tlb->entries[i].frame = -1;
+        }
+    }
+    for (int level = 0; level < WALK_LEVELS - 1; level++)
+    {
+        PagingStructureCache *cache = &phys_mem->walker.levels[level];
+        for (int i = 0; i < cache->number_of_entries; i++)
+        {
+            if (owner < 0 || cache->entries[i].owner == owner)
+            {
+                cache->entries[i].owner = -1;
+                cache->entries[i].prefix = -1;
+            }
+        }
+    }
+}
+
+void view_scheduler_statistics(const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    const Scheduler *scheduler = &phys_mem->scheduler;
+    printf("\n=== Scheduler Statistics ===\n");
+    printf("Context Switches: %lld\n", scheduler->context_switches);
+    printf("Context Switch Time: %.3f ms\n", scheduler->switch_time_ns / 1e6);
+    printf("Full TLB Flushes: %lld\n", scheduler->tlb_flushes);
+    printf("ASID Recycles: %lld\n", scheduler->asid_recycles);
+    printf("TLB Hit Rate: %.2f%%\n", phys_mem->tlb.hits + phys_mem->tlb.misses > 0
+                                         ? (double)phys_mem->tlb.hits / (phys_mem->tlb.hits + phys_mem->tlb.misses) *
+                                               100.0
+                                         : 0.0);
+
+    printf("\nPID\tWeight\tQuanta\tRefs\tCPU Time (ms)\tVruntime\n");
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        printf("%d\t%d\t%lld\t%lld\t%.3f\t\t%lld\n", proc_list->process_ids[i], proc_list->weights[i],
+               proc_list->quanta[i], proc_list->scheduled_references[i], proc_list->cpu_time_ns[i] / 1e6,
+               proc_list->vruntimes[i]);
+    }
+}
+
+void configure_scheduler_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    static const char *policy_names[] = {"off", "round-robin", "fair"};
+    static const char *tlb_mode_names[] = {"flush", "ASID"};
+    Scheduler *scheduler = &phys_mem->scheduler;
+    int choice, value;
+    while (1)
+    {
+        printf("\n+------------------------------------------+\n");
+        printf("|          CPU SCHEDULER (REPLAY)          |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Policy                  [%11s] |\n", policy_names[scheduler->policy]);
+        printf("| 2. Round-Robin Quantum (refs)   [%6d] |\n", scheduler->quantum);
+        printf("| 3. Fair Target Latency (refs)   [%6d] |\n", scheduler->target_latency);
+        printf("| 4. Fair Min Granularity (refs)  [%6d] |\n", scheduler->min_granularity);
+        printf("| 5. Context Switch Cost (ns)     [%6d] |\n", scheduler->context_switch_ns);
+        printf("| 6. TLB on Switch                [%6s] |\n", tlb_mode_names[scheduler->tlb_mode]);
+        printf("| 7. Hardware ASIDs               [%6d] |\n", scheduler->asid_count);
+        printf("| 8. Set Process Weight                    |\n");
+        printf("| 9. View Scheduler Statistics             |\n");
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
+        {
+            printf("Invalid input. Please enter a valid option.\n");
+            clear_input_buffer();
+            continue;
+        }
+
+        switch (choice)
+        {
+        case 0:
+            return;
+        case 1:
+            if (!read_int("Enter policy (0 = off, 1 = round-robin, 2 = fair): ", &value))
+            {
+                break;
+            }
+            if (value < SCHED_NONE || value > SCHED_FAIR)
+            {
+                printf("Error: Unknown policy.\n");
+                break;
+            }
+            scheduler->policy = value;
+            break;
+        case 2:
+        case 3:
+        case 4:
+            if (!read_int("Enter length in references: ", &value))
+            {
+                break;
+            }
+            if (value < 1)
+            {
+                printf("Error: Length must be at least 1 reference.\n");
+                break;
+            }
+            if (choice == 2)
+            {
+                scheduler->quantum = value;
+            }
+            else if (choice == 3)
+            {
+                scheduler->target_latency = value;
+            }
+            else
+            {
+                scheduler->min_granularity = value;
+            }
+            break;
+        case 5:
+            if (!read_int("Enter context switch cost in nanoseconds: ", &value))
+            {
+                break;
+            }
+            if (value < 0)
+            {
+                printf("Error: Cost cannot be negative.\n");
+                break;
+            }
+            scheduler->context_switch_ns = value;
+            break;
+        case 6:
+            if (!read_int("Enter TLB handling (0 = flush on switch, 1 = ASID tagging): ", &value))
+            {
+                break;
+            }
+            if (value != SCHED_TLB_FLUSH && value != SCHED_TLB_ASID)
+            {
+                printf("Error: Unknown TLB handling.\n");
+                break;
+            }
+            scheduler->tlb_mode = value;
+            break;
+        case 7:
+            if (!read_int("Enter number of hardware ASIDs: ", &value))
+            {
+                break;
+            }
+            if (value < 1 || value > SCHED_MAX_ASIDS)
+            {
+                printf("Error: ASID count must be between 1 and %d.\n", SCHED_MAX_ASIDS);
+                break;
+            }
+            for (int i = value; i < scheduler->asid_count; i++)
+            {
+                if (scheduler->asid_owners[i] >= 0)
+                {
+                    flush_translations(phys_mem, scheduler->asid_owners[i]);
+                    scheduler->asid_owners[i] = -1;
+                }
+            }
+            scheduler->asid_count = value;
+            break;
+        case 8:
+        {
+            Process *process = prompt_for_process(proc_list);
+            if (process == NULL || !read_int("Enter weight (1024 = default): ", &value))
+            {
+                break;
+            }
+            if (value < 1)
+            {
+                printf("Error: Weight must be positive.\n");
+                break;
+            }
+            proc_list->weights[process_index(proc_list, process)] = value;
+            break;
+        }
+        case 9:
+            view_scheduler_statistics(phys_mem, proc_list);
+            break;
+        default:
+            printf("Invalid option. Please select a valid option from the menu.\n");
+        }
+    }
+}
+
+int external_fragmentation_permille(const PhysicalMemory *phys_mem)
+{
+    FreeRunSummary free_runs;
+    summarize_free_runs(phys_mem, phys_mem->tiering.tiers[TIER_DRAM].number_of_frames, &free_runs);
+    return free_run_fragmentation_permille(&free_runs);
+}
+
+int timeseries_init(TimeSeries *series, const SamplingControl *sampling, const ProcessList *proc_list)
+{
+    series->process_count = proc_list->count;
+    series->column_count = TIMESERIES_FIXED_COLUMNS + proc_list->count;
+    series->samples = 0;
+    series->capacity = TIMESERIES_INITIAL_SAMPLES;
+    series->failed = 0;
+    series->reference_interval = sampling->reference_interval;
+    series->interval_ns = sampling->interval_ns;
+    series->next_reference = sampling->reference_interval > 0 ? 0 : LLONG_MAX;
+    series->next_time_ns = sampling->interval_ns > 0 ? 0 : LLONG_MAX;
+    series->last_references = -1;
+    series->last_faults = 0;
+    series->last_evictions = 0;
+    series->scan_credit = 0;
+    series->fragmentation_permille = 0;
+
+    series->columns = (long long **)calloc(series->column_count, sizeof(long long *));
+    if (series->columns == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < series->column_count; i++)
+    {
+        series->columns[i] = (long long *)malloc(series->capacity * sizeof(long long));
+        if (series->columns[i] == NULL)
+        {
+            timeseries_free(series);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void timeseries_sample(TimeSeries *series, const PhysicalMemory *phys_mem, const ProcessList *proc_list,
+                       long long references)
+{
+    long long now = phys_mem->stats.simulated_time_ns;
+    if (series->reference_interval > 0)
+    {
+        series->next_reference = references + series->reference_interval;
+    }
+    if (series->interval_ns > 0)
+    {
+        series->next_time_ns = now + series->interval_ns;
+    }
+    if (series->failed)
+    {
+        return;
+    }
+
+    if (series->samples == series->capacity)
+    {
+        int capacity = series->capacity * 2;
+        for (int i = 0; i < series->column_count; i++)
+        {
+            long long *column = (long long *)realloc(series->columns[i], capacity * sizeof(long long));
+            if (column == NULL)
+            {
+                series->failed = 1;
+                return;
+            }
+            series->columns[i] = column;
+        }
+        series->capacity = capacity;
+    }
+
+    long long faults = phys_mem->stats.minor_faults + phys_mem->stats.major_faults;
+    long long evictions = phys_mem->stats.anonymous_evictions + phys_mem->stats.page_cache_evictions;
+    int dram_frames = phys_mem->tiering.tiers[TIER_DRAM].number_of_frames;
+    long long elapsed = series->last_references < 0 ? 0 : references - series->last_references;
+    series->scan_credit += elapsed * TIMESERIES_SCAN_FRAMES_PER_REFERENCE;
+    if (series->samples == 0 || series->scan_credit >= dram_frames)
+    {
+        series->fragmentation_permille = external_fragmentation_permille(phys_mem);
+        series->scan_credit = series->samples == 0 ? 0 : series->scan_credit - dram_frames;
+    }
+
+    int row = series->samples++;
+    series->columns[0][row] = now;
+    series->columns[1][row] = references;
+    series->columns[2][row] = phys_mem->free_frame_count + phys_mem->tiering.tiers[TIER_SLOW].free_count;
+    series->columns[3][row] = row > 0 ? faults - series->last_faults : 0;
+    series->columns[4][row] = row > 0 ? evictions - series->last_evictions : 0;
+    series->columns[5][row] = phys_mem->swap.number_of_slots - phys_mem->swap.free_slot_count;
+    series->columns[6][row] = series->fragmentation_permille;
+    for (int i = 0; i < series->process_count && i < proc_list->count; i++)
+    {
+        series->columns[TIMESERIES_FIXED_COLUMNS + i][row] = proc_list->resident_pages[i];
+    }
+
+    series->last_references = references;
+    series->last_faults = faults;
+    series->last_evictions = evictions;
+}
+
+int timeseries_write(const TimeSeries *series, const ProcessList *proc_list, const char *path)
+{
+    static const char *fixed_names[TIMESERIES_FIXED_COLUMNS] = {
+        "time_ns", "references", "free_frames", "faults", "evictions", "swap_slots_used", "fragmentation_permille"};
+    FILE *out = fopen(path, "wb");
+    if (out == NULL)
+    {
+        return 0;
+    }
+
+    BufferedWriter writer;
+    if (!writer_open(&writer, out))
+    {
+        fclose(out);
+        return 0;
+    }
+    writer_u32(&writer, TIMESERIES_MAGIC);
+    writer_u32(&writer, TIMESERIES_VERSION);
+    writer_u32(&writer, (uint32_t)series->column_count);
+    writer_u32(&writer, (uint32_t)series->samples);
+    for (int i = 0; i < series->column_count; i++)
+    {
+        char name[TIMESERIES_NAME_SIZE];
+        if (i < TIMESERIES_FIXED_COLUMNS)
+        {
+            snprintf(name, sizeof(name), "%s", fixed_names[i]);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "rss_pid_%d", proc_list->process_ids[i - TIMESERIES_FIXED_COLUMNS]);
+        }
+        writer_u32(&writer, (uint32_t)strlen(name));
+        writer_string(&writer, name);
+    }
+    for (int i = 0; i < series->column_count; i++)
+    {
+        writer_bytes(&writer, series->columns[i], (size_t)series->samples * sizeof(long long));
+    }
+
+    int written = writer_close(&writer);
+    return fclose(out) == 0 && written;
+}
+
+void print_timeseries_summary(const TimeSeries *series)
+{
+    static const char *peak_names[] = {"Faults per Sample", "Evictions per Sample", "Swap Slots Used",
+                                       "Fragmentation (permille)"};
+    if (series->samples == 0)
+    {
+        return;
+    }
+
+    int lowest = 0;
+    for (int row = 1; row < series->samples; row++)
+    {
+        if (series->columns[2][row] < series->columns[2][lowest])
+        {
+            lowest = row;
+        }
+    }
+    printf("Samples: %d x %d columns\n", series->samples, series->column_count);
+    printf("Lowest Free Frames: %lld at %.3f ms\n", series->columns[2][lowest], series->columns[0][lowest] / 1e6);
+    for (int column = 3; column < TIMESERIES_FIXED_COLUMNS; column++)
+    {
+        int peak = 0;
+        for (int row = 1; row < series->samples; row++)
+        {
+            if (series->columns[column][row] > series->columns[column][peak])
+            {
+                peak = row;
+            }
+        }
+        printf("Peak %s: %lld at %.3f ms\n", peak_names[column - 3], series->columns[column][peak],
+               series->columns[0][peak] / 1e6);
+    }
+}
+
+void timeseries_free(TimeSeries *series)
+{
+    for (int i = 0; i < series->column_count && series->columns != NULL; i++)
+    {
+        free(series->columns[i]);
+    }
+    free(series->columns);
+    series->columns = NULL;
+}
+
+void print_replay_result(const ReplayResult *result)
+{
+    printf("References Replayed: %lld\n", result->references);
+    printf("Page Faults: %lld (%.2f%%)\n", result->faults,
+           result->references > 0 ? (double)result->faults / result->references * 100.0 : 0.0);
+    printf("Segmentation Faults: %lld\n", result->segfaults);
+    printf("Protection Faults: %lld\n", result->protection_faults);
+    printf("Out of Memory: %lld\n", result->out_of_memory);
+    printf("Unknown Process IDs: %lld\n", result->unknown_processes);
+    printf("Malformed Lines: %lld\n", result->malformed_lines);
+    printf("Simulated Time: %.3f ms\n", result->simulated_time_ns / 1e6);
+}
+
+void replay_trace_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    char path[INPUT_BUFFER_SIZE];
+
+    printf("\n=== Replay Reference Trace ===\n");
+    printf("Trace format: one \"<pid> <r|w> <address>\" per line, '#' starts a comment.\n");
+    printf("Enter trace file path: ");
+    if (scanf("%99s", path) != 1)
+    {
+        clear_input_buffer();
+        return;
+    }
+
+    FILE *trace = fopen(path, "r");
+    if (trace == NULL)
+    {
+        printf("Error: Unable to open trace file \"%s\".\n", path);
+        return;
+    }
+
+    TimeSeries series;
+    int sampling = phys_mem->sampling.reference_interval > 0 || phys_mem->sampling.interval_ns > 0;
+    if (sampling && !timeseries_init(&series, &phys_mem->sampling, proc_list))
+    {
+        printf("Error: Unable to allocate the time series; replaying without sampling.\n");
+        sampling = 0;
+    }
+
+    ReplayResult result;
+    if (phys_mem->scheduler.policy != SCHED_NONE)
+    {
+        schedule_trace(phys_mem, proc_list, trace, &result, sampling ? &series : NULL);
+    }
+    else
+    {
+        replay_trace(phys_mem, proc_list, trace, &result, sampling ? &series : NULL);
+    }
+    fclose(trace);
+
+    printf("\nReplay complete.\n");
+    print_replay_result(&result);
+
+    if (sampling)
+    {
+        printf("\n=== Time Series ===\n");
+        if (series.failed)
+        {
+            printf("Error: Ran out of memory for samples; the series stops at sample %d.\n", series.samples);
+        }
+        print_timeseries_summary(&series);
+        if (timeseries_write(&series, proc_list, phys_mem->sampling.path))
+        {
+            printf("Time series written to %s.\n", phys_mem->sampling.path);
+        }
+        else
+        {
+            printf("Error: Unable to write the time series to %s.\n", phys_mem->sampling.path);
+        }
+        timeseries_free(&series);
+    }
+}
+
+int load_trace_references(const ProcessList *proc_list, FILE *trace, ShardReference **references,
+                          long long *count, long long *process_references, ReplayResult *result)
+{
+    char line[TRACE_LINE_SIZE];
+    long long capacity = 0;
+    *references = NULL;
+    *count = 0;
+
+    while (fgets(line, sizeof(line), trace) != NULL)
+    {
+        int pid, access_type, address;
+        int parsed = parse_trace_line(line, &pid, &access_type, &address);
+        Process *process = parsed > 0 ? find_process(proc_list, pid) : NULL;
+        if (parsed < 0)
+        {
+            result->malformed_lines++;
+        }
+        else if (parsed > 0 && process == NULL)
+        {
+            result->unknown_processes++;
+        }
+        else if (parsed > 0)
+        {
+            if (*count == capacity)
+            {
+                capacity = capacity > 0 ? capacity * 2 : INITIAL_STREAM_CAPACITY;
+                ShardReference *grown =
+                    (ShardReference *)realloc(*references, (size_t)capacity * sizeof(ShardReference));
+                if (grown == NULL)
+                {
+                    free(*references);
+                    *references = NULL;
+                    return 0;
+                }
+                *references = grown;
+            }
+            int index = process_index(proc_list, process);
+            (*references)[*count].process = index;
+            (*references)[*count].access_type = access_type;
+            (*references)[(*count)++].address = address;
+            process_references[index]++;
+        }
+    }
+    return 1;
+}
+
+int assign_replay_shards(const ProcessList *proc_list, const long long *process_references, int workers,
+                         int *owners, long long *loads)
+{
+    int active = 0;
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        owners[i] = -1;
+        active += process_references[i] > 0;
+    }
+
+    int shard_count = workers < active ? workers : active;
+    for (int shard = 0; shard < shard_count; shard++)
+    {
+        loads[shard] = 0;
+    }
+
+    for (int assigned = 0; assigned < active; assigned++)
+    {
+        int next = -1;
+        for (int i = 0; i < proc_list->count; i++)
+        {
+            if (owners[i] < 0 && process_references[i] > 0 &&
+                (next < 0 || process_references[i] > process_references[next] ||
+                 (process_references[i] == process_references[next] &&
+                  proc_list->process_ids[i] < proc_list->process_ids[next])))
+            {
+                next = i;
+            }
+        }
+
+        int lightest = 0;
+        for (int shard = 1; shard < shard_count; shard++)
+        {
+            if (loads[shard] < loads[lightest])
+            {
+                lightest = shard;
+            }
+        }
+        owners[next] = lightest;
+        loads[lightest] += process_references[next];
+    }
+    return shard_count;
+}
+
+const char *replay_copy_limitation(const PhysicalMemory *phys_mem)
+{
+    if (phys_mem->tiering.tier_count > 1)
+    {
+        return "Replay workers model DRAM only and cannot hold pages of the slow memory tier.";
+    }
+    if (phys_mem->scheduler.policy != SCHED_NONE)
+    {
+        return "Replay workers follow trace order; turn the CPU scheduler policy off first.";
+    }
+    return NULL;
+}
+
+int vma_tree_maps_file(const VmArea *node, int file_id)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+    return ((node->flags & VMA_FLAG_FILE) && node->file_id == file_id) || vma_tree_maps_file(node->left, file_id) ||
+           vma_tree_maps_file(node->right, file_id);
+}
+
+int processes_map_file(const ProcessList *proc_list, int file_id)
+{
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        if (vma_tree_maps_file(proc_list->processes[i].vma_root, file_id))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int find_cross_worker_file(const VmArea *node, const ProcessList *proc_list, const int *owners, int owner)
+{
+    if (node == NULL)
+    {
+        return -1;
+    }
+
+    if ((node->flags & VMA_FLAG_FILE) && (node->flags & VMA_FLAG_SHARED))
+    {
+        for (int i = 0; i < proc_list->count; i++)
+        {
+            if (owners[i] >= 0 && owners[i] != owner &&
+                vma_tree_maps_file(proc_list->processes[i].vma_root, node->file_id))
+            {
+                return node->file_id;
+            }
+        }
+    }
+    int file_id = find_cross_worker_file(node->left, proc_list, owners, owner);
+    return file_id >= 0 ? file_id : find_cross_worker_file(node->right, proc_list, owners, owner);
+}
+
+int copy_memory_config(PhysicalMemory *memory, const PhysicalMemory *phys_mem)
+{
+    memory->prefetcher.flags = phys_mem->prefetcher.flags;
+    memory->prefetcher.max_window = phys_mem->prefetcher.max_window;
+    memory->writeback.background_ratio = phys_mem->writeback.background_ratio;
+    memory->writeback.dirty_ratio = phys_mem->writeback.dirty_ratio;
+    memory->writeback.batch_pages = phys_mem->writeback.batch_pages;
+    memory->writeback.interval_ns = phys_mem->writeback.interval_ns;
+    memory->color_allocator.policy = phys_mem->color_allocator.policy;
+
+    memory->caches.enabled = phys_mem->caches.enabled;
+    memory->caches.inclusion_policy = phys_mem->caches.inclusion_policy;
+    for (int i = 0; i < CACHE_LEVELS; i++)
+    {
+        const CacheLevel *level = &phys_mem->caches.levels[i];
+        CacheLevel replacement;
+        if (!initialize_cache_level(&replacement, level->size, level->associativity, level->latency_ns))
+        {
+            return 0;
+        }
+        free_cache_level(&memory->caches.levels[i]);
+        memory->caches.levels[i] = replacement;
+    }
+
+    Tlb tlb;
+    if (!update_cache_colors(&memory->caches, memory->page_size) ||
+        !initialize_tlb(&tlb, phys_mem->tlb.number_of_entries, phys_mem->tlb.associativity))
+    {
+        return 0;
+    }
+    free(memory->tlb.entries);
+    memory->tlb = tlb;
+
+    memory->walker.enabled = phys_mem->walker.enabled;
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
+    {
+        PagingStructureCache cache;
+        if (!initialize_paging_structure_cache(&cache, phys_mem->walker.levels[i].number_of_entries))
+        {
+            return 0;
+        }
+        free(memory->walker.levels[i].entries);
+        memory->walker.levels[i] = cache;
+    }
+    return 1;
+}
+
+int initialize_replay_pool(ReplayPool *pool, int number_of_frames, int page_size)
+{
+    pool->number_of_frames = number_of_frames;
+    pool->spare_count = 0;
+    pool->memory = (unsigned char *)calloc((size_t)number_of_frames * page_size, sizeof(unsigned char));
+    pool->spare_frames = (int *)malloc((number_of_frames > 0 ? number_of_frames : 1) * sizeof(int));
+    if (pool->memory == NULL || pool->spare_frames == NULL)
+    {
+        free_replay_pool(pool);
+        return 0;
+    }
+    return 1;
+}
+
+void free_replay_pool(ReplayPool *pool)
+{
+    free(pool->memory);
+    free(pool->spare_frames);
+    pool->memory = NULL;
+    pool->spare_frames = NULL;
+}
+
+int initialize_replay_shard(ReplayShard *shard, const PhysicalMemory *phys_mem, RandomState *streams,
+                            ReplayPool *pool, int first_frame, int quota, int swap_slots)
+{
+    MemoryBacking heap = {MEMORY_BACKING_HEAP, NULL, 0, -1, 0};
+    PhysicalMemory *memory = &shard->memory;
+
+    memory->backing = heap;
+    attach_physical_memory(memory, pool->memory, pool->number_of_frames * phys_mem->page_size, phys_mem->page_size,
+                           swap_slots);
+    random_split(streams, &memory->random);
+    initialize_process_list(&shard->processes);
+    shard->pool = pool;
+    shard->references = NULL;
+
+    for (int frame = 0; frame < pool->number_of_frames; frame++)
+    {
+        if (frame < first_frame || frame >= first_frame + quota)
+        {
+            memory->frames[frame].type = FRAME_BALLOON;
+        }
+    }
+    if (!copy_memory_config(memory, phys_mem) || !rebuild_color_bins(memory))
+    {
+        free_replay_shard(shard);
+        return 0;
+    }
+    shard->quota = quota;
+    shard->quota_target = quota;
+
+    shard->reference_count = 0;
+    shard->next_reference = 0;
+    shard->epoch_end = 0;
+    shard->frames_received = 0;
+    shard->frames_donated = 0;
+    shard->epoch_references = 0;
+    shard->epoch_faults = 0;
+    memset(&shard->result, 0, sizeof(ReplayResult));
+    return 1;
+}
+
+int copy_vma_tree(ObjectPool *pool, const VmArea *node, VmArea **root)
+{
+    if (node == NULL)
+    {
+        return 1;
+    }
+
+    VmArea *copy = vma_create(pool, node->start, node->end, node->prot, node->flags, node->file_id,
+                              node->file_offset);
+    if (copy == NULL)
+    {
+        return 0;
+    }
+    *root = vma_tree_insert(*root, copy);
+    return copy_vma_tree(pool, node->left, root) && copy_vma_tree(pool, node->right, root);
+}
+
+int copy_process_to_shard(ReplayShard *shard, const PhysicalMemory *phys_mem, const ProcessList *proc_list,
+                          const Process *source)
+{
+    PhysicalMemory *memory = &shard->memory;
+    ProcessList *processes = &shard->processes;
+    int image_pages = (int)pages_for_size((uint64_t)source->process_size, phys_mem->page_shift);
+    if (!reserve_process_slot(processes))
+    {
+        return 0;
+    }
+
+    PageTableEntry *page_table = allocate_page_table(&processes->allocator->page_tables, image_pages);
+    if (page_table == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < image_pages; i++)
+    {
+        page_table[i] = PTE_NOT_PRESENT;
+    }
+
+    Process copy = *source;
+    copy.number_of_pages = image_pages;
+    copy.page_table = page_table;
+    copy.pte_directory = NULL;
+    copy.pte_chunks = 0;
+    copy.pte_chunk_capacity = 0;
+    copy.allocator = processes->allocator;
+    copy.vma_root = NULL;
+    copy.page_faults = 0;
+    copy.last_fault_page = -1;
+    copy.stride = 0;
+    copy.stride_confidence = 0;
+    copy.readahead_window = 0;
+    copy.readahead_end = -1;
+    copy.readahead_marker = -1;
+    copy.color_cursor = 0;
+    if (!copy_vma_tree(&processes->allocator->vma_nodes, source->vma_root, &copy.vma_root) ||
+        !ensure_page_table_span(&copy, source->number_of_pages))
+    {
+        return 0;
+    }
+
+    Process *process = add_process(processes, &copy, 0, proc_list->weights[process_index(proc_list, source)]);
+
+    int page_size = phys_mem->page_size;
+    for (int page = 0; page < source->number_of_pages; page++)
+    {
+        PageTableEntry entry = pte_get(source, page);
+        const unsigned char *data = NULL;
+        if (PTE_IS_SWAPPED(entry))
+        {
+            data = &phys_mem->swap.data[(size_t)PTE_SWAP_SLOT(entry) * page_size];
+        }
+        else if (PTE_IS_PRESENT(entry) && phys_mem->frames[PTE_FRAME(entry)].type == FRAME_ANONYMOUS)
+        {
+            data = &phys_mem->memory[(size_t)PTE_FRAME(entry) * page_size];
+        }
+        if (data == NULL)
+        {
+            continue;
+        }
+
+        int frame, slot;
+        if (PTE_IS_SWAPPED(entry) || !allocate_frames(memory, process, 1, &frame))
+        {
+            if ((slot = allocate_swap_slot(&memory->swap)) < 0)
+            {
+                return 0;
+            }
+            memcpy(&memory->swap.data[(size_t)slot * page_size], data, page_size);
+            if (!pte_set(process, page, PTE_MAKE_SWAP(slot)))
+            {
+                return 0;
+            }
+            continue;
+        }
+
+        const FrameInfo *info = &phys_mem->frames[PTE_FRAME(entry)];
+        slot = -1;
+        if (!info->dirty && info->swap_slot >= 0 && (slot = allocate_swap_slot(&memory->swap)) >= 0)
+        {
+            memcpy(&memory->swap.data[(size_t)slot * page_size],
+                   &phys_mem->swap.data[(size_t)info->swap_slot * page_size], page_size);
+        }
+        memcpy(&memory->memory[(size_t)frame * page_size], data, page_size);
+        if (!install_anonymous_page(memory, processes, process, page, frame, slot, PTE_PROT(entry)))
+        {
+            return 0;
+        }
+        pte_set(process, page, PTE_WITH_FRAME(entry, frame));
+        memory->frames[frame].referenced = info->referenced;
+        if (!info->dirty)
+        {
+            mark_frame_clean(memory, frame);
+        }
+    }
+    return 1;
+}
+
+int copy_files_to_shard(ReplayShard *shard, const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    PhysicalMemory *memory = &shard->memory;
+    ProcessList *processes = &shard->processes;
+    int page_size = phys_mem->page_size;
+
+    for (int bucket = 0; bucket < FILE_STORE_BUCKETS; bucket++)
+    {
+        for (const FilePage *page = phys_mem->file_store.buckets[bucket]; page != NULL; page = page->next)
+        {
+            if (!processes_map_file(processes, page->file_id))
+            {
+                continue;
+            }
+            FilePage *stored = file_store_insert(memory, page->file_id, page->page);
+            if (stored == NULL)
+            {
+                return 0;
+            }
+            memcpy(stored->data, page->data, page_size);
+        }
+    }
+
+    for (int frame = 0; frame < phys_mem->number_of_frames; frame++)
+    {
+        const FrameInfo *info = &phys_mem->frames[frame];
+        if (info->type != FRAME_PAGE_CACHE || !processes_map_file(processes, info->file_id))
+        {
+            continue;
+        }
+
+        const unsigned char *data = &phys_mem->memory[(size_t)frame * page_size];
+        int copy;
+        if (allocate_frames(memory, NULL, 1, &copy))
+        {
+            memcpy(&memory->memory[(size_t)copy * page_size], data, page_size);
+            page_cache_insert(memory, copy, info->file_id, info->page);
+            memory->frames[copy].referenced = info->referenced;
+            if (info->dirty)
+            {
+                mark_frame_dirty(memory, copy);
+            }
+        }
+        else if (info->dirty)
+        {
+            FilePage *stored = file_store_insert(memory, info->file_id, info->page);
+            if (stored == NULL)
+            {
+                return 0;
+            }
+            memcpy(stored->data, data, page_size);
+        }
+    }
+
+    for (int i = 0; i < processes->count; i++)
+    {
+        Process *process = &processes->processes[i];
+        const Process *source = find_process(proc_list, process->process_id);
+        for (int page = 0; page < source->number_of_pages; page++)
+        {
+            PageTableEntry entry = pte_get(source, page);
+            const FrameInfo *info = PTE_IS_PRESENT(entry) ? &phys_mem->frames[PTE_FRAME(entry)] : NULL;
+            int frame = info != NULL && info->type == FRAME_PAGE_CACHE
+                            ? page_cache_lookup(memory, info->file_id, info->page)
+                            : -1;
+            if (frame >= 0)
+            {
+                if (!pte_set(process, page, PTE_WITH_FRAME(entry, frame)))
+                {
+                    return 0;
+                }
+                memory->frames[frame].map_count++;
+                processes->resident_pages[i]++;
+            }
+        }
+    }
+    return 1;
+}
+
+int count_anonymous_pages(const PhysicalMemory *phys_mem, const Process *process)
+{
+    int pages = 0;
+    for (int page = 0; page < process->number_of_pages; page++)
+    {
+        PageTableEntry entry = pte_get(process, page);
+        if (PTE_IS_SWAPPED(entry) ||
+            (PTE_IS_PRESENT(entry) && phys_mem->frames[PTE_FRAME(entry)].type == FRAME_ANONYMOUS))
+        {
+            pages++;
+        }
+    }
+    return pages;
+}
+
+void resize_shard_quota(ReplayShard *shard)
+{
+    PhysicalMemory *memory = &shard->memory;
+    while (shard->quota > shard->quota_target)
+    {
+        int frame;
+        if (!obtain_frame(memory, &shard->processes, NULL, &frame))
+        {
+            break;
+        }
+
+        FrameInfo *info = &memory->frames[frame];
+        journal_record(memory, JOURNAL_FRAME_ALLOC, -1, -1, frame, FRAME_BALLOON, -1);
+        info->type = FRAME_BALLOON;
+        info->referenced = 0;
+        info->prefetched = 0;
+        info->swap_slot = -1;
+        shard->pool->spare_frames[shard->pool->spare_count++] = frame;
+        shard->quota--;
+        shard->frames_donated++;
+    }
+
+    while (shard->quota < shard->quota_target && shard->pool->spare_count > 0)
+    {
+        release_frames(memory, &shard->pool->spare_frames[--shard->pool->spare_count], 1);
+        shard->quota++;
+        shard->frames_received++;
+    }
+}
+
+void replay_shard_range(ReplayShard *shard, const ShardReference *references, long long start, long long end,
+                        ReplayResult *result)
+{
+    for (long long i = start; i < end; i++)
+    {
+        const ShardReference *reference = &references[i];
+        replay_process_reference(&shard->memory, &shard->processes, &shard->processes.processes[reference->process],
+                                 reference->access_type, reference->address, result);
+    }
+}
+
+void *replay_shard_epoch(void *argument)
+{
+    ReplayShard *shard = (ReplayShard *)argument;
+    long long references_before = shard->result.references;
+    long long faults_before = shard->result.faults;
+    replay_shard_range(shard, shard->references, shard->next_reference, shard->epoch_end, &shard->result);
+    shard->next_reference = shard->epoch_end;
+    shard->epoch_references = shard->result.references - references_before;
+    shard->epoch_faults = shard->result.faults - faults_before;
+    return NULL;
+}
+
+int shard_faults_more(const ReplayShard *shard, const ReplayShard *other)
+{
+    if (shard->epoch_references == 0)
+    {
+        return 0;
+    }
+    if (other->epoch_references == 0)
+    {
+        return shard->epoch_faults > 0;
+    }
+    return shard->epoch_faults * other->epoch_references > other->epoch_faults * shard->epoch_references;
+}
+
+void rebalance_shard_quotas(ReplayShard *shards, int shard_count, int pool_frames, int min_quota)
+{
+    int order[PARALLEL_MAX_WORKERS];
+    int available = pool_frames;
+    for (int i = 0; i < shard_count; i++)
+    {
+        shards[i].quota_target = shards[i].quota;
+        available -= shards[i].quota;
+        order[i] = i;
+    }
+
+    for (int i = 1; i < shard_count; i++)
+    {
+        int current = order[i];
+        int j = i;
+        while (j > 0 && shard_faults_more(&shards[current], &shards[order[j - 1]]))
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = current;
+    }
+
+    for (int k = 0; k < shard_count / 2; k++)
+    {
+        ReplayShard *needy = &shards[order[k]];
+        ReplayShard *donor = &shards[order[shard_count - 1 - k]];
+        int finished = donor->next_reference == donor->reference_count;
+        if (!finished && !shard_faults_more(needy, donor))
+        {
+            continue;
+        }
+
+        int step = finished ? donor->quota : donor->quota / PARALLEL_REBALANCE_DIVISOR + 1;
+        if (step > donor->quota - min_quota)
+        {
+            step = donor->quota - min_quota;
+        }
+        donor->quota_target = donor->quota - (step > 0 ? step : 0);
+    }
+
+    for (int k = 0; k < (shard_count + 1) / 2 && available > 0; k++)
+    {
+        ReplayShard *shard = &shards[order[k]];
+        if (shard->next_reference == shard->reference_count || shard->epoch_faults == 0 ||
+            shard->quota_target < shard->quota)
+        {
+            continue;
+        }
+
+        int grant = shard->quota / PARALLEL_REBALANCE_DIVISOR + 1;
+        if (grant > available)
+        {
+            grant = available;
+        }
+        if (grant > shard->memory.number_of_frames - shard->quota)
+        {
+            grant = shard->memory.number_of_frames - shard->quota;
+        }
+        shard->quota_target = shard->quota + grant;
+        available -= grant;
+    }
+}
+
+void parallel_replay_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, int workers,
+                           ReplayResult *result)
+{
+    int pool_frames = phys_mem->tiering.tiers[TIER_DRAM].number_of_frames;
+    const char *limitation = replay_copy_limitation(phys_mem);
+    memset(result, 0, sizeof(ReplayResult));
+    if (limitation != NULL)
+    {
+        printf("Error: %s\n", limitation);
+        return;
+    }
+    int most_workers = pool_frames / (2 * PARALLEL_MIN_QUOTA);
+    if (workers > most_workers)
+    {
+        workers = most_workers > 0 ? most_workers : 1;
+        printf("Limiting the replay to %d workers so that each keeps %d frames and can trade as many.\n", workers,
+               PARALLEL_MIN_QUOTA);
+    }
+
+    int processes = proc_list->count > 0 ? proc_list->count : 1;
+    long long *process_references = (long long *)calloc(processes, sizeof(long long));
+    int *owners = (int *)malloc(processes * sizeof(int));
+    int *slots = (int *)malloc(processes * sizeof(int));
+    ShardReference *references = NULL;
+    long long count = 0;
+    if (process_references == NULL || owners == NULL || slots == NULL ||
+        !load_trace_references(proc_list, trace, &references, &count, process_references, result))
+    {
+        printf("Error: Unable to buffer the trace.\n");
+        free(process_references);
+        free(owners);
+        free(slots);
+        return;
+    }
+
+    long long loads[PARALLEL_MAX_WORKERS];
+    int shard_count = assign_replay_shards(proc_list, process_references, workers, owners, loads);
+    int shared_file = -1;
+    for (int i = 0; i < proc_list->count && shared_file < 0; i++)
+    {
+        if (owners[i] >= 0)
+        {
+            shared_file = find_cross_worker_file(proc_list->processes[i].vma_root, proc_list, owners, owners[i]);
+        }
+    }
+    if (shared_file >= 0)
+    {
+        printf("Error: File %d is mapped shared by processes on different workers, which would not see each "
+               "other's writes.\n",
+               shared_file);
+        free(references);
+        free(process_references);
+        free(owners);
+        free(slots);
+        return;
+    }
+
+    ReplayShard *shards = (ReplayShard *)calloc(shard_count > 0 ? shard_count : 1, sizeof(ReplayShard));
+    ReplayPool pool;
+    int initialized = 0;
+    int ok = initialize_replay_pool(&pool, pool_frames, phys_mem->page_size) && shards != NULL;
+    /*
+     * Every worker keeps half of an even share, so at least half of the pool can move
+     * between workers however small it is.
+     */
+    int min_quota = shard_count > 0 ? pool_frames / (2 * shard_count) : pool_frames;
+    int spare = pool_frames - shard_count * min_quota;
+    int first_frame = 0;
+    RandomState streams = phys_mem->random;
+    long long anonymous_pages[PARALLEL_MAX_WORKERS] = {0};
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        if (owners[i] >= 0)
+        {
+            anonymous_pages[owners[i]] += count_anonymous_pages(phys_mem, &proc_list->processes[i]);
+        }
+    }
+    for (; ok && initialized < shard_count; initialized++)
+    {
+        /*
+         * Swap is not traded between workers like frames, so every worker gets the host's
+         * whole swap area, or enough for every page it inherits; a worker that runs with a
+         * small quota then swaps as much as the serial replay would rather than running out.
+         */
+        int quota = min_quota + (int)((long long)spare * loads[initialized] / count);
+        long long swap_slots = phys_mem->swap.number_of_slots;
+        if (swap_slots < anonymous_pages[initialized])
+        {
+            swap_slots = anonymous_pages[initialized];
+        }
+        if (swap_slots >= PTE_INDEX_LIMIT ||
+            !initialize_replay_shard(&shards[initialized], phys_mem, &streams, &pool, first_frame, quota,
+                                     (int)swap_slots))
+        {
+            ok = 0;
+            break;
+        }
+        first_frame += quota;
+        shards[initialized].references = (ShardReference *)malloc(loads[initialized] * sizeof(ShardReference));
+        ok = shards[initialized].references != NULL;
+    }
+    while (ok && first_frame < pool_frames)
+    {
+        pool.spare_frames[pool.spare_count++] = first_frame++;
+    }
+    for (int i = 0; ok && i < proc_list->count; i++)
+    {
+        if (owners[i] >= 0)
+        {
+            slots[i] = shards[owners[i]].processes.count;
+            ok = copy_process_to_shard(&shards[owners[i]], phys_mem, proc_list, &proc_list->processes[i]);
+        }
+    }
+    for (int i = 0; ok && i < shard_count; i++)
+    {
+        ok = copy_files_to_shard(&shards[i], phys_mem, proc_list);
+    }
+    for (long long i = 0; ok && i < count; i++)
+    {
+        ReplayShard *shard = &shards[owners[references[i].process]];
+        ShardReference *reference = &shard->references[shard->reference_count++];
+        *reference = references[i];
+        reference->process = slots[references[i].process];
+    }
+    free(references);
+    free(process_references);
+    free(owners);
+    free(slots);
+
+    if (!ok)
+    {
+        printf("Error: Unable to set up the replay workers.\n");
+        for (int i = 0; i < initialized; i++)
+        {
+            free_replay_shard(&shards[i]);
+        }
+        free(shards);
+        free_replay_pool(&pool);
+        return;
+    }
+
+    /*
+     * Threads are started per epoch rather than kept behind a barrier: joining them is
+     * the only synchronization, and an epoch is long enough to hide the thread start-up.
+     */
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    long long epochs = 0;
+    int active = shard_count > 0;
+    while (active)
+    {
+        pthread_t threads[PARALLEL_MAX_WORKERS];
+        int running[PARALLEL_MAX_WORKERS];
+        for (int i = 0; i < shard_count; i++)
+        {
+            ReplayShard *shard = &shards[i];
+            shard->epoch_end = shard->reference_count - shard->next_reference > PARALLEL_EPOCH_REFERENCES
+                                   ? shard->next_reference + PARALLEL_EPOCH_REFERENCES
+                                   : shard->reference_count;
+            running[i] = pthread_create(&threads[i], NULL, replay_shard_epoch, shard) == 0;
+        }
+        for (int i = 0; i < shard_count; i++)
+        {
+            if (running[i])
+            {
+                pthread_join(threads[i], NULL);
+            }
+            else
+            {
+                replay_shard_epoch(&shards[i]);
+            }
+        }
+        epochs++;
+
+        active = 0;
+        for (int i = 0; i < shard_count; i++)
+        {
+            active |= shards[i].next_reference < shards[i].reference_count;
+        }
+        if (active)
+        {
+            /* Donors hand their frames to the pool before any recipient takes one */
+            rebalance_shard_quotas(shards, shard_count, pool_frames, min_quota);
+            for (int i = 0; i < shard_count; i++)
+            {
+                if (shards[i].quota_target < shards[i].quota)
+                {
+                    resize_shard_quota(&shards[i]);
+                }
+            }
+            for (int i = 0; i < shard_count; i++)
+            {
+                if (shards[i].quota_target > shards[i].quota)
+                {
+                    resize_shard_quota(&shards[i]);
+                }
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (finished.tv_nsec - started.tv_nsec) / 1e9;
+
+    for (int i = 0; i < shard_count; i++)
+    {
+        const ReplayResult *shard_result = &shards[i].result;
+        result->references += shard_result->references;
+        result->faults += shard_result->faults;
+        result->segfaults += shard_result->segfaults;
+        result->protection_faults += shard_result->protection_faults;
+        result->out_of_memory += shard_result->out_of_memory;
+        if (shards[i].memory.stats.simulated_time_ns > result->simulated_time_ns)
+        {
+            result->simulated_time_ns = shards[i].memory.stats.simulated_time_ns;
+        }
+    }
+
+    if (shard_count > 0)
+    {
+        view_replay_shards(shards, shard_count);
+        printf("Epochs: %lld of up to %d references per worker\n", epochs, PARALLEL_EPOCH_REFERENCES);
+        printf("Note: Workers trade frames only between epochs, so the fault counts depend on the number of "
+               "workers.\n");
+        printf("Wall Time: %.3f ms (%.2f million references/s)\n", seconds * 1e3,
+               seconds > 0 ? result->references / seconds / 1e6 : 0.0);
+    }
+
+    for (int i = 0; i < shard_count; i++)
+    {
+        free_replay_shard(&shards[i]);
+    }
+    free(shards);
+    free_replay_pool(&pool);
+}
+
+void view_replay_shards(const ReplayShard *shards, int shard_count)
+{
+    printf("\nWorker\tProcs\tRefs\t\tFaults\t\tQuota\tGained\tDonated\tTime (ms)\n");
+    for (int i = 0; i < shard_count; i++)
+    {
+        const ReplayShard *shard = &shards[i];
+        printf("%d\t%d\t%-10lld\t%-10lld\t%d\t%lld\t%lld\t%.3f\n", i, shard->processes.count,
+               shard->result.references, shard->result.faults, shard->quota, shard->frames_received,
+               shard->frames_donated, shard->memory.stats.simulated_time_ns / 1e6);
+    }
+}
+
+void free_replay_shard(ReplayShard *shard)
+{
+    free(shard->references);
+    /* The RAM array belongs to the pool */
+    shard->memory.memory = NULL;
+    free_memory(&shard->memory, &shard->processes);
+}
+
+void parallel_replay_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    char path[INPUT_BUFFER_SIZE];
+    int workers;
+
+    printf("\n=== Parallel Trace Replay ===\n");
+    printf("Workers replay private copies of their processes; the simulator state is left unchanged.\n");
+    printf("Enter trace file path: ");
+    if (scanf("%99s", path) != 1)
+    {
+        clear_input_buffer();
+        return;
+    }
+    printf("Online CPUs: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    if (!read_int("Enter number of worker threads: ", &workers))
+    {
+        return;
+    }
+    if (workers < 1 || workers > PARALLEL_MAX_WORKERS)
+    {
+        printf("Error: Worker threads must be between 1 and %d.\n", PARALLEL_MAX_WORKERS);
+        return;
+    }
+
+    FILE *trace = fopen(path, "r");
+    if (trace == NULL)
+    {
+        printf("Error: Unable to open trace file \"%s\".\n", path);
+        return;
+    }
+
+    ReplayResult result;
+    parallel_replay_trace(phys_mem, proc_list, trace, workers, &result);
+    fclose(trace);
+
+    printf("\nReplay complete.\n");
+    print_replay_result(&result);
+}
+
+int compare_long_long(const void *a, const void *b)
+{
+    long long left = *(const long long *)a;
+    long long right = *(const long long *)b;
+    return left < right ? -1 : left > right;
+}
+
+int capture_residency(const PhysicalMemory *phys_mem, long long **pages)
+{
+    int count = 0;
+    *pages = (long long *)malloc((phys_mem->number_of_frames > 0 ? phys_mem->number_of_frames : 1) *
+                                 sizeof(long long));
+    if (*pages == NULL)
+    {
+        return -1;
+    }
+
+    for (int frame = 0; frame < phys_mem->number_of_frames; frame++)
+    {
+        const FrameInfo *info = &phys_mem->frames[frame];
+        if (info->type == FRAME_ANONYMOUS)
+        {
+            (*pages)[count++] = ((long long)info->owner << 32) | (unsigned int)info->page;
+        }
+        else if (info->type == FRAME_PAGE_CACHE)
+        {
+            (*pages)[count++] = ((long long)(info->file_id | (1 << 30)) << 32) | (unsigned int)info->page;
+        }
+    }
+    qsort(*pages, count, sizeof(long long), compare_long_long);
+    return count;
+}
+
+int residency_divergence(const long long *pages, int count, const long long *other_pages, int other_count)
+{
+    int divergence = 0;
+    int i = 0, j = 0;
+    while (i < count && j < other_count)
+    {
+        if (pages[i] == other_pages[j])
+        {
+            i++;
+            j++;
+        }
+        else
+        {
+            divergence++;
+            if (pages[i] < other_pages[j])
+            {
+                i++;
+            }
+            else
+            {
+                j++;
+            }
+        }
+    }
+    return divergence + (count - i) + (other_count - j);
+}
+
+void *speculate_epoch(void *argument)
+{
+    SpeculativeEpoch *epoch = (SpeculativeEpoch *)argument;
+    ReplayResult warmup;
+    memset(&warmup, 0, sizeof(ReplayResult));
+    ReplayShard *shard = &epoch->worker->shard;
+    replay_shard_range(shard, epoch->references, epoch->warmup_start, epoch->start, &warmup);
+    epoch->start_page_count = capture_residency(&shard->memory, &epoch->start_pages);
+
+    long long time_before = shard->memory.stats.simulated_time_ns;
+    replay_shard_range(shard, epoch->references, epoch->start, epoch->end, &epoch->result);
+    epoch->simulated_time_ns = shard->memory.stats.simulated_time_ns - time_before;
+    epoch->end_page_count = capture_residency(&shard->memory, &epoch->end_pages);
+    return NULL;
+}
+
+int seed_speculative_worker(SpeculativeWorker *worker, const PhysicalMemory *phys_mem, RandomState *streams,
+                            const PhysicalMemory *state, const ProcessList *processes, int process_id)
+{
+    int pool_frames = worker->pool.number_of_frames;
+    if (worker->seeded)
+    {
+        free_replay_shard(&worker->shard);
+        worker->seeded = 0;
+    }
+    if (!initialize_replay_shard(&worker->shard, phys_mem, streams, &worker->pool, 0, pool_frames,
+                                 pool_frames * SWAP_SIZE_MULTIPLIER))
+    {
+        return 0;
+    }
+    worker->seeded = 1;
+
+    const Process *process = process_id >= 0 ? find_process(processes, process_id) : NULL;
+    return (process == NULL || copy_process_to_shard(&worker->shard, state, processes, process)) &&
+           copy_files_to_shard(&worker->shard, state, processes);
+}
+
+void speculative_replay_trace(PhysicalMemory *phys_mem, ProcessList *proc_list, FILE *trace, int epoch_count,
+                              int workers, long long warmup, int tolerance, ReplayResult *result)
+{
+    static const char *status_names[] = {"continued", "accepted", "re-run"};
+    int pool_frames = phys_mem->tiering.tiers[TIER_DRAM].number_of_frames;
+    const char *limitation = replay_copy_limitation(phys_mem);
+    memset(result, 0, sizeof(ReplayResult));
+    if (limitation != NULL)
+    {
+        printf("Error: %s\n", limitation);
+        return;
+    }
+
+    int processes = proc_list->count > 0 ? proc_list->count : 1;
+    long long *process_references = (long long *)calloc(processes, sizeof(long long));
+    ShardReference *references = NULL;
+    long long count = 0;
+    if (process_references == NULL ||
+        !load_trace_references(proc_list, trace, &references, &count, process_references, result))
+    {
+        printf("Error: Unable to buffer the trace.\n");
+        free(process_references);
+        return;
+    }
+
+    int traced = 0;
+    int process_id = -1;
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        if (process_references[i] > 0)
+        {
+            traced++;
+            process_id = proc_list->processes[i].process_id;
+        }
+    }
+    free(process_references);
+    if (traced > 1)
+    {
+        printf("Error: Speculative replay takes single-process traces; this trace references %d processes.\n",
+               traced);
+        free(references);
+        return;
+    }
+    for (long long i = 0; i < count; i++)
+    {
+        references[i].process = 0;
+    }
+    if (epoch_count > count)
+    {
+        epoch_count = count > 0 ? (int)count : 1;
+    }
+    if (workers > epoch_count)
+    {
+        workers = epoch_count;
+    }
+
+    /*
+     * Only one wave of epochs is in flight at a time, so memory grows with the worker
+     * count rather than the epoch count. Each worker's pool is allocated once and its
+     * memory is rebuilt over it whenever the worker takes a new epoch.
+     */
+    SpeculativeEpoch *epochs = (SpeculativeEpoch *)calloc(epoch_count, sizeof(SpeculativeEpoch));
+    SpeculativeWorker *speculators = (SpeculativeWorker *)calloc(workers, sizeof(SpeculativeWorker));
+    int initialized = 0;
+    int ok = epochs != NULL && speculators != NULL;
+    for (; ok && initialized < workers; initialized++)
+    {
+        ok = initialize_replay_pool(&speculators[initialized].pool, pool_frames, phys_mem->page_size);
+    }
+    for (int i = 0; ok && i < epoch_count; i++)
+    {
+        SpeculativeEpoch *epoch = &epochs[i];
+        epoch->references = references;
+        epoch->start = count * i / epoch_count;
+        epoch->end = count * (i + 1) / epoch_count;
+        epoch->warmup_start = epoch->start > warmup ? epoch->start - warmup : 0;
+        epoch->start_page_count = -1;
+        epoch->end_page_count = -1;
+    }
+
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    RandomState streams = phys_mem->random;
+    SpeculativeWorker *source = NULL;
+    long long divergence_estimate = 0;
+    long long rerun_references = 0;
+    pthread_t threads[PARALLEL_MAX_WORKERS];
+    int running[PARALLEL_MAX_WORKERS];
+    for (int first = 0; ok && first < epoch_count; first += workers)
+    {
+        /*
+         * The worker holding the reconciled state runs the first epoch of the wave as it
+         * stands; the others are reset to copies of that state, or of the host state in
+         * the first wave, before they warm up.
+         */
+        int wave = epoch_count - first < workers ? epoch_count - first : workers;
+        int holder = source != NULL ? (int)(source - speculators) : 0;
+        for (int k = 0; ok && k < wave; k++)
+        {
+            SpeculativeEpoch *epoch = &epochs[first + k];
+            epoch->worker = &speculators[(holder + k) % workers];
+            if (k == 0 && source != NULL)
+            {
+                epoch->warmup_start = epoch->start;
+                continue;
+            }
+            ok = source != NULL ? seed_speculative_worker(epoch->worker, phys_mem, &streams, &source->shard.memory,
+                                                          &source->shard.processes, process_id)
+                                : seed_speculative_worker(epoch->worker, phys_mem, &streams, phys_mem, proc_list,
+                                                          process_id);
+        }
+        if (!ok)
+        {
+            break;
+        }
+
+        for (int k = 0; k < wave; k++)
+        {
+            running[k] = pthread_create(&threads[k], NULL, speculate_epoch, &epochs[first + k]) == 0;
+        }
+        for (int k = 0; k < wave; k++)
+        {
+            if (running[k])
+            {
+                pthread_join(threads[k], NULL);
+            }
+            else
+            {
+                speculate_epoch(&epochs[first + k]);
+            }
+        }
+
+        /*
+         * Reconcile in trace order. source is the worker whose memory holds the
+         * reconciled state at the end of the last epoch; rejected epochs are replayed
+         * there. Residency lists are released once compared.
+         */
+        source = epochs[first].worker;
+        epochs[first].status = SPECULATION_CONTINUED;
+        for (int i = first + 1; i < first + wave; i++)
+        {
+            SpeculativeEpoch *epoch = &epochs[i];
+            SpeculativeEpoch *previous = &epochs[i - 1];
+            epoch->divergence = previous->end_page_count < 0 || epoch->start_page_count < 0
+                                    ? INT_MAX
+                                    : residency_divergence(previous->end_pages, previous->end_page_count,
+                                                           epoch->start_pages, epoch->start_page_count);
+            free(previous->end_pages);
+            previous->end_pages = NULL;
+            if (epoch->divergence <= tolerance)
+            {
+                epoch->status = SPECULATION_ACCEPTED;
+                divergence_estimate += epoch->divergence;
+                source = epoch->worker;
+                continue;
+            }
+
+            epoch->status = SPECULATION_RERUN;
+            memset(&epoch->result, 0, sizeof(ReplayResult));
+            long long time_before = source->shard.memory.stats.simulated_time_ns;
+            replay_shard_range(&source->shard, references, epoch->start, epoch->end, &epoch->result);
+            epoch->simulated_time_ns = source->shard.memory.stats.simulated_time_ns - time_before;
+            free(epoch->end_pages);
+            epoch->end_page_count = capture_residency(&source->shard.memory, &epoch->end_pages);
+            rerun_references += epoch->end - epoch->start;
+        }
+        for (int i = first; i < first + wave; i++)
+        {
+            free(epochs[i].start_pages);
+            epochs[i].start_pages = NULL;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (finished.tv_nsec - started.tv_nsec) / 1e9;
+
+    if (ok)
+    {
+        printf("\nEpoch\tRefs\t\tFaults\t\tDivergence\tResult\n");
+        for (int i = 0; i < epoch_count; i++)
+        {
+            const SpeculativeEpoch *epoch = &epochs[i];
+            result->references += epoch->result.references;
+            result->faults += epoch->result.faults;
+            result->segfaults += epoch->result.segfaults;
+            result->protection_faults += epoch->result.protection_faults;
+            result->out_of_memory += epoch->result.out_of_memory;
+            result->simulated_time_ns += epoch->simulated_time_ns;
+            if (epoch->divergence == INT_MAX)
+            {
+                printf("%d\t%-10lld\t%-10lld\tunknown\t\t%s\n", i, epoch->result.references, epoch->result.faults,
+                       status_names[epoch->status]);
+            }
+            else
+            {
+                printf("%d\t%-10lld\t%-10lld\t%d\t\t%s\n", i, epoch->result.references, epoch->result.faults,
+                       epoch->divergence, status_names[epoch->status]);
+            }
+        }
+        printf("Workers: %d\n", workers);
+        printf("Fault Divergence Estimate: +/-%lld (heuristic; residency only, so not exact at any tolerance)\n",
+               divergence_estimate);
+        printf("Re-run References: %lld (%.2f%%)\n", rerun_references,
+               count > 0 ? (double)rerun_references / count * 100.0 : 0.0);
+        printf("Wall Time: %.3f ms (%.2f million references/s)\n", seconds * 1e3,
+               seconds > 0 ? result->references / seconds / 1e6 : 0.0);
+    }
+    else
+    {
+        printf("Error: Unable to set up the speculative epochs.\n");
+        memset(result, 0, sizeof(ReplayResult));
+    }
+
+    for (int i = 0; epochs != NULL && i < epoch_count; i++)
+    {
+        free(epochs[i].start_pages);
+        free(epochs[i].end_pages);
+    }
+    for (int i = 0; i < initialized; i++)
+    {
+        if (speculators[i].seeded)
+        {
+            free_replay_shard(&speculators[i].shard);
+        }
+        free_replay_pool(&speculators[i].pool);
+    }
+    free(speculators);
+    free(epochs);
+    free(references);
+}
+
+void speculative_replay_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    char path[INPUT_BUFFER_SIZE];
+    int epoch_count, workers, warmup, tolerance;
+
+    printf("\n=== Speculative Trace Replay ===\n");
+    printf("Epochs replay private copies of the traced process; the simulator state is left unchanged.\n");
+    printf("Enter trace file path: ");
+    if (scanf("%99s", path) != 1)
+    {
+        clear_input_buffer();
+        return;
+    }
+    printf("Online CPUs: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    if (!read_int("Enter number of epochs: ", &epoch_count) ||
+        !read_int("Enter number of worker threads: ", &workers) ||
+        !read_int("Enter warm-up references per epoch: ", &warmup) ||
+        !read_int("Enter divergence tolerance in pages: ", &tolerance))
+    {
+        return;
+    }
+    if (epoch_count < 1 || epoch_count > SPECULATION_MAX_EPOCHS)
+    {
+        printf("Error: Number of epochs must be between 1 and %d.\n", SPECULATION_MAX_EPOCHS);
+        return;
+    }
+    if (workers < 1 || workers > PARALLEL_MAX_WORKERS)
+    {
+        printf("Error: Worker threads must be between 1 and %d.\n", PARALLEL_MAX_WORKERS);
+        return;
+    }
+    if (warmup < 0 || tolerance < 0)
+    {
+        printf("Error: Warm-up and tolerance must not be negative.\n");
+        return;
+    }
+
+    FILE *trace = fopen(path, "r");
+    if (trace == NULL)
+    {
+        printf("Error: Unable to open trace file \"%s\".\n", path);
+        return;
+    }
+
+    ReplayResult result;
+    speculative_replay_trace(phys_mem, proc_list, trace, epoch_count, workers, warmup, tolerance, &result);
+    fclose(trace);
+
+    printf("\nReplay complete.\n");
+    print_replay_result(&result);
+}
+
+void configure_prefetcher_menu(Prefetcher *prefetcher)
+{
+    int choice;
+    while (1)
+    {
+        printf("\n+------------------------------------------+\n");
+        printf("|          PREFETCHER CONFIGURATION        |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Sequential Readahead         [%s]    |\n", (prefetcher->flags & PREFETCH_SEQUENTIAL) ? "on " : "off");
+        printf("| 2. Stride Detection             [%s]    |\n", (prefetcher->flags & PREFETCH_STRIDE) ? "on " : "off");
+        printf("| 3. Markov Correlation           [%s]    |\n", (prefetcher->flags & PREFETCH_MARKOV) ? "on " : "off");
+        printf("| 4. Maximum Readahead Window     [%5d]   |\n", prefetcher->max_window);
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
+        {
+            printf("Invalid input. Please enter a valid option.\n");
+            clear_input_buffer();
+            continue;
+        }
+
+        switch (choice)
+        {
+        case 0:
+            return;
+        case 1:
+            prefetcher->flags ^= PREFETCH_SEQUENTIAL;
+            break;
+        case 2:
+            prefetcher->flags ^= PREFETCH_STRIDE;
+            break;
+        case 3:
+            prefetcher->flags ^= PREFETCH_MARKOV;
+            break;
+        case 4:
+        {
+            int window;
+            if (!read_int("Enter maximum readahead window in pages: ", &window))
+            {
+                break;
+            }
+            if (window < 1 || window > 99999)
+            {
+                printf("Error: Window must be between 1 and 99999 pages.\n");
+                break;
+            }
+            prefetcher->max_window = window;
+            break;
+        }
+        default:
+            printf("Invalid option. Please select a valid option from the menu.\n");
+        }
+    }
+}
+
+int initialize_cache_level(CacheLevel *level, int size, int associativity, int latency_ns)
+{
+    if (!is_power_of_two(size) || !is_power_of_two(associativity) ||
+        size < associativity * CACHE_LINE_SIZE)
+    {
+        return 0;
+    }
+
+    int ways = size / CACHE_LINE_SIZE;
+    long long *tags = (long long *)malloc(ways * sizeof(long long));
+    unsigned long long *last_used = (unsigned long long *)calloc(ways, sizeof(unsigned long long));
+    unsigned char *walk_lines = (unsigned char *)calloc(ways, sizeof(unsigned char));
+    if (tags == NULL || last_used == NULL || walk_lines == NULL)
+    {
+        free(tags);
+        free(last_used);
+        free(walk_lines);
+        return 0;
+    }
+
+    for (int i = 0; i < ways; i++)
+    {
+        tags[i] = -1;
+    }
+
+    level->size = size;
+    level->associativity = associativity;
+    level->sets = ways / associativity;
+    level->latency_ns = latency_ns;
+    level->tags = tags;
+    level->last_used = last_used;
+    level->walk_lines = walk_lines;
+    level->hits = 0;
+    level->misses = 0;
+    return 1;
+}
+
+void free_cache_level(CacheLevel *level)
+{
+    free(level->tags);
+    free(level->last_used);
+    free(level->walk_lines);
+    level->tags = NULL;
+    level->last_used = NULL;
+    level->walk_lines = NULL;
+}
+
+void initialize_cache_hierarchy(CacheHierarchy *caches, int page_size)
+{
+    caches->enabled = 0;
+    caches->inclusion_policy = CACHE_INCLUSIVE;
+    caches->clock = 0;
+    caches->back_invalidations = 0;
+    caches->walk_accesses = 0;
+    caches->walk_memory_accesses = 0;
+    caches->color_accesses = NULL;
+    caches->color_misses = NULL;
+
+    if (!initialize_cache_level(&caches->levels[0], L1_DEFAULT_SIZE, L1_DEFAULT_ASSOCIATIVITY, L1_LATENCY_NS) ||
+        !initialize_cache_level(&caches->levels[1], L2_DEFAULT_SIZE, L2_DEFAULT_ASSOCIATIVITY, L2_LATENCY_NS) ||
+        !initialize_cache_level(&caches->levels[2], LLC_DEFAULT_SIZE, LLC_DEFAULT_ASSOCIATIVITY, LLC_LATENCY_NS) ||
+        !update_cache_colors(caches, page_size))
+    {
+        fprintf(stderr, "Error: Unable to allocate the cache hierarchy.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+int update_cache_colors(CacheHierarchy *caches, int page_size)
+{
+    const CacheLevel *llc = &caches->levels[CACHE_LEVELS - 1];
+    long long way_bytes = (long long)llc->sets * CACHE_LINE_SIZE;
+    int colors = way_bytes > page_size ? (int)(way_bytes >> log2_exact((uint64_t)page_size)) : 1;
+
+    long long *accesses = (long long *)calloc(colors, sizeof(long long));
+    long long *misses = (long long *)calloc(colors, sizeof(long long));
+    if (accesses == NULL || misses == NULL)
+    {
+        free(accesses);
+        free(misses);
+        return 0;
+    }
+
+    free(caches->color_accesses);
+    free(caches->color_misses);
+    caches->colors = colors;
+    caches->color_accesses = accesses;
+    caches->color_misses = misses;
+    return 1;
+}
+
+int cache_level_lookup(CacheLevel *level, long long line, unsigned long long stamp)
+{
+    int base = (int)(line % level->sets) * level->associativity;
+    for (int way = 0; way < level->associativity; way++)
+    {
+        if (level->tags[base + way] == line)
+        {
+            level->last_used[base + way] = stamp;
+            return way;
+        }
+    }
+    return -1;
+}
+
+long long cache_level_insert(CacheLevel *level, long long line, int walk_line, unsigned long long stamp,
+                             int *victim_walk)
+{
+    int base = (int)(line % level->sets) * level->associativity;
+    int victim = base;
+    for (int way = 0; way < level->associativity; way++)
+    {
+        if (level->tags[base + way] < 0)
+        {
+            victim = base + way;
+            break;
+        }
+        if (level->last_used[base + way] < level->last_used[victim])
+        {
+            victim = base + way;
+        }
+    }
+
+    long long evicted = level->tags[victim];
+    *victim_walk = level->walk_lines[victim];
+    level->tags[victim] = line;
+    level->last_used[victim] = stamp;
+    level->walk_lines[victim] = (unsigned char)walk_line;
+    return evicted;
+}
+
+int cache_level_invalidate(CacheLevel *level, long long line)
+{
+    int base = (int)(line % level->sets) * level->associativity;
+    for (int way = 0; way < level->associativity; way++)
+    {
+        if (level->tags[base + way] == line)
+        {
+            level->tags[base + way] = -1;
+            level->walk_lines[base + way] = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int cache_access(CacheHierarchy *caches, long long physical_address, int page_shift, int walk_reference,
+                 int memory_latency_ns)
+{
+    long long line = physical_address / CACHE_LINE_SIZE;
+    unsigned long long stamp = ++caches->clock;
+    int color = (int)((physical_address >> page_shift) % caches->colors);
+    int hit_level = CACHE_LEVELS;
+    int latency = memory_latency_ns;
+    int victim_walk;
+
+    if (walk_reference)
+    {
+        caches->walk_accesses++;
+    }
+
+    for (int i = 0; i < CACHE_LEVELS; i++)
+    {
+        if (cache_level_lookup(&caches->levels[i], line, stamp) >= 0)
+        {
+            caches->levels[i].hits++;
+            hit_level = i;
+            latency = caches->levels[i].latency_ns;
+            break;
+        }
+        caches->levels[i].misses++;
+    }
+
+    if (hit_level >= CACHE_LEVELS - 1)
+    {
+        caches->color_accesses[color]++;
+        if (hit_level == CACHE_LEVELS)
+        {
+            caches->color_misses[color]++;
+            if (walk_reference)
+            {
+                caches->walk_memory_accesses++;
+            }
+        }
+    }
+    if (hit_level == 0)
+    {
+        return latency;
+    }
+
+    if (caches->inclusion_policy == CACHE_EXCLUSIVE)
+    {
+        int walk_line = walk_reference;
+        if (hit_level < CACHE_LEVELS)
+        {
+            CacheLevel *source = &caches->levels[hit_level];
+            int base = (int)(line % source->sets) * source->associativity;
+            for (int way = 0; way < source->associativity; way++)
+            {
+                if (source->tags[base + way] == line)
+                {
+                    walk_line = source->walk_lines[base + way];
+                }
+            }
+            cache_level_invalidate(source, line);
+        }
+
+        long long moving = line;
+        for (int i = 0; i < CACHE_LEVELS && moving >= 0; i++)
+        {
+            moving = cache_level_insert(&caches->levels[i], moving, walk_line, stamp, &victim_walk);
+            walk_line = victim_walk;
+        }
+        return latency;
+    }
+
+    for (int i = hit_level - 1; i >= 0; i--)
+    {
+        long long evicted = cache_level_insert(&caches->levels[i], line, walk_reference, stamp, &victim_walk);
+        if (i == CACHE_LEVELS - 1 && evicted >= 0 && caches->inclusion_policy == CACHE_INCLUSIVE)
+        {
+            for (int inner = 0; inner < CACHE_LEVELS - 1; inner++)
+            {
+                caches->back_invalidations += cache_level_invalidate(&caches->levels[inner], evicted);
+            }
+        }
+    }
+    return latency;
+}
+
+int initialize_tlb(Tlb *tlb, int entries, int associativity)
+{
+    if (!is_power_of_two(entries) || !is_power_of_two(associativity) || associativity > entries)
+    {
+        return 0;
+    }
+
+    TlbEntry *storage = (TlbEntry *)malloc(entries * sizeof(TlbEntry));
+    if (storage == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < entries; i++)
+    {
+        storage[i].owner = -1;
+        storage[i].page = -1;
+        storage[i].frame = -1;
+        storage[i].last_used = 0;
+    }
+
+    tlb->entries = storage;
+    tlb->number_of_entries = entries;
+    tlb->associativity = associativity;
+    tlb->sets = entries / associativity;
+    tlb->clock = 0;
+    tlb->hits = 0;
+    tlb->misses = 0;
+    tlb->walk_references = 0;
+    return 1;
+}
+
+int tlb_lookup(Tlb *tlb, int owner, int page, int frame)
+{
+    TlbEntry *set = &tlb->entries[(page % tlb->sets) * tlb->associativity];
+    for (int way = 0; way < tlb->associativity; way++)
+    {
+        if (set[way].owner == owner && set[way].page == page && set[way].frame == frame)
+        {
+            set[way].last_used = ++tlb->clock;
+            tlb->hits++;
+            return 1;
+        }
+    }
+    tlb->misses++;
+    return 0;
+}
+
+void tlb_insert(Tlb *tlb, int owner, int page, int frame)
+{
+    TlbEntry *set = &tlb->entries[(page % tlb->sets) * tlb->associativity];
+    TlbEntry *victim = &set[0];
+    for (int way = 0; way < tlb->associativity; way++)
+    {
+        if (set[way].owner == owner && set[way].page == page)
+        {
+            victim = &set[way];
+            break;
+        }
+        if (set[way].last_used < victim->last_used)
+        {
+            victim = &set[way];
+        }
+    }
+
+    victim->owner = owner;
+    victim->page = page;
+    victim->frame = frame;
+    victim->last_used = ++tlb->clock;
+}
+
+long long page_table_entry_address(const PhysicalMemory *phys_mem, int owner, int level, int page)
+{
+    long long base = 0;
+    for (int i = WALK_LEVELS - 1; i > level; i--)
+    {
+        base += PAGE_TABLE_REGION_STRIDE >> (WALK_LEVELS - i);
+    }
+    long long index = page >> ((WALK_LEVELS - 1 - level) * WALK_INDEX_BITS);
+    return (long long)phys_mem->number_of_frames * phys_mem->page_size + (long long)owner * PAGE_TABLE_REGION_STRIDE +
+           base + index * (long long)sizeof(int);
+}
+
+int initialize_paging_structure_cache(PagingStructureCache *cache, int entries)
+{
+    if (entries < 1)
+    {
+        return 0;
+    }
+
+    PscEntry *storage = (PscEntry *)malloc(entries * sizeof(PscEntry));
+    if (storage == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < entries; i++)
+    {
+        storage[i].owner = -1;
+        storage[i].prefix = -1;
+        storage[i].last_used = 0;
+    }
+
+    cache->entries = storage;
+    cache->number_of_entries = entries;
+    cache->lookups = 0;
+    cache->hits = 0;
+    cache->references_saved = 0;
+    return 1;
+}
+
+void initialize_page_walker(PageWalker *walker)
+{
+    walker->enabled = 1;
+    walker->clock = 0;
+    walker->walks = 0;
+    if (!initialize_paging_structure_cache(&walker->levels[0], PSC_DEFAULT_PML4_ENTRIES) ||
+        !initialize_paging_structure_cache(&walker->levels[1], PSC_DEFAULT_PDPT_ENTRIES) ||
+        !initialize_paging_structure_cache(&walker->levels[2], PSC_DEFAULT_PDE_ENTRIES))
+    {
+        fprintf(stderr, "Error: Unable to allocate paging-structure caches.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+int psc_lookup(PagingStructureCache *cache, int owner, int prefix, unsigned long long stamp)
+{
+    cache->lookups++;
+    for (int i = 0; i < cache->number_of_entries; i++)
+    {
+        if (cache->entries[i].owner == owner && cache->entries[i].prefix == prefix)
+        {
+            cache->entries[i].last_used = stamp;
+            cache->hits++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void psc_insert(PagingStructureCache *cache, int owner, int prefix, unsigned long long stamp)
+{
+    PscEntry *victim = &cache->entries[0];
+    for (int i = 0; i < cache->number_of_entries; i++)
+    {
+        if (cache->entries[i].owner == owner && cache->entries[i].prefix == prefix)
+        {
+            victim = &cache->entries[i];
+            break;
+        }
+        if (cache->entries[i].last_used < victim->last_used)
+        {
+            victim = &cache->entries[i];
+        }
+    }
+
+    victim->owner = owner;
+    victim->prefix = prefix;
+    victim->last_used = stamp;
+}
+
+int psc_walk_start(PageWalker *walker, int owner, int page)
+{
+    unsigned long long stamp = ++walker->clock;
+
+    walker->walks++;
+    if (!walker->enabled)
+    {
+        return 0;
+    }
+
+    for (int level = WALK_LEVELS - 2; level >= 0; level--)
+    {
+        int prefix = page >> ((WALK_LEVELS - 1 - level) * WALK_INDEX_BITS);
+        if (psc_lookup(&walker->levels[level], owner, prefix, stamp))
+        {
+            walker->levels[level].references_saved += level + 1;
+            return level + 1;
+        }
+    }
+    return 0;
+}
+
+void psc_fill(PageWalker *walker, int owner, int page, int level)
+{
+    if (walker->enabled && level < WALK_LEVELS - 1)
+    {
+        psc_insert(&walker->levels[level], owner, page >> ((WALK_LEVELS - 1 - level) * WALK_INDEX_BITS),
+                   walker->clock);
+    }
+}
+
+int page_walk(PhysicalMemory *phys_mem, int owner, int page)
+{
+    int latency = 0;
+    for (int level = psc_walk_start(&phys_mem->walker, owner, page); level < WALK_LEVELS; level++)
+    {
+        phys_mem->tlb.walk_references++;
+        latency += memory_reference_cost(phys_mem, page_table_entry_address(phys_mem, owner, level, page), 1);
+        psc_fill(&phys_mem->walker, owner, page, level);
+    }
+    return latency;
+}
+
+void configure_page_walker(PageWalker *walker)
+{
+    static const char *prompts[WALK_LEVELS - 1] = {"Enter PML4 cache entries: ", "Enter PDPT cache entries: ",
+                                                   "Enter PDE cache entries: "};
+    PagingStructureCache replacement[WALK_LEVELS - 1];
+    int enabled, entries[WALK_LEVELS - 1];
+
+    if (!read_int("Enable paging-structure caches (1 = yes, 0 = no): ", &enabled))
+    {
+        return;
+    }
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
+    {
+        if (!read_int(prompts[i], &entries[i]))
+        {
+            return;
+        }
+    }
+
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
+    {
+        if (!initialize_paging_structure_cache(&replacement[i], entries[i]))
+        {
+            printf("Error: Each cache needs at least one entry.\n");
+            for (int j = 0; j < i; j++)
+            {
+                free(replacement[j].entries);
+            }
+            return;
+        }
+    }
+
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
+    {
+        free(walker->levels[i].entries);
+        walker->levels[i] = replacement[i];
+    }
+    walker->enabled = enabled != 0;
+}
+
+int memory_reference_cost(PhysicalMemory *phys_mem, long long physical_address, int walk_reference)
+{
+    MemoryTier *tier = &phys_mem->tiering.tiers[TIER_DRAM];
+    if (physical_address < (long long)phys_mem->number_of_frames * phys_mem->page_size)
+    {
+        tier = &phys_mem->tiering.tiers[frame_tier(phys_mem, (int)(physical_address >> phys_mem->page_shift))];
+        if (!walk_reference)
+        {
+            tier->accesses++;
+        }
+    }
+
+    if (!phys_mem->caches.enabled)
+    {
+        return tier->latency_ns;
+    }
+    return cache_access(&phys_mem->caches, physical_address, phys_mem->page_shift, walk_reference, tier->latency_ns);
+}
+
+void view_cache_statistics(const PhysicalMemory *phys_mem)
+{
+    const Tlb *tlb = &phys_mem->tlb;
+    const CacheHierarchy *caches = &phys_mem->caches;
+    static const char *level_names[CACHE_LEVELS] = {"L1", "L2", "LLC"};
+    static const char *policy_names[] = {"inclusive", "non-inclusive", "exclusive"};
+    long long tlb_lookups = tlb->hits + tlb->misses;
+
+    printf("\n=== TLB and Cache Statistics ===\n");
+    printf("TLB: %d entries, %d-way\n", tlb->number_of_entries, tlb->associativity);
+    printf("TLB Hits: %lld\n", tlb->hits);
+    printf("TLB Misses: %lld\n", tlb->misses);
+    printf("TLB Hit Ratio: %.2f%%\n", tlb_lookups > 0 ? (double)tlb->hits / tlb_lookups * 100.0 : 0.0);
+    printf("Page Walks: %lld\n", phys_mem->walker.walks);
+    printf("Page Walk References: %lld\n", tlb->walk_references);
+
+    static const char *psc_names[WALK_LEVELS - 1] = {"PML4", "PDPT", "PDE"};
+    const PageWalker *walker = &phys_mem->walker;
+    long long saved = 0;
+    printf("\nPaging-Structure Caches: %s\n", walker->enabled ? "enabled" : "disabled");
+    printf("Cache\tEntries\tLookups\t\tHits\t\tRefs Saved\n");
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
+    {
+        const PagingStructureCache *cache = &walker->levels[i];
+        printf("%s\t%d\t%-12lld\t%-12lld\t%lld\n", psc_names[i], cache->number_of_entries, cache->lookups,
+               cache->hits, cache->references_saved);
+        saved += cache->references_saved;
+    }
+    printf("Walk References Saved: %lld of %lld (%.2f%%)\n", saved, walker->walks * WALK_LEVELS,
+           walker->walks > 0 ? (double)saved / (walker->walks * WALK_LEVELS) * 100.0 : 0.0);
+
+    if (!caches->enabled)
+    {
+        printf("\nCache model is disabled.\n");
+        return;
+    }
+
+    printf("\nInclusion Policy: %s\n", policy_names[caches->inclusion_policy]);
+    printf("Level\tSize\tWays\tSets\tHits\t\tMisses\t\tHit Ratio\n");
+    for (int i = 0; i < CACHE_LEVELS; i++)
+    {
+        const CacheLevel *level = &caches->levels[i];
+        long long lookups = level->hits + level->misses;
+        printf("%s\t%dK\t%d\t%d\t%-12lld\t%-12lld\t%.2f%%\n", level_names[i], level->size / 1024,
+               level->associativity, level->sets, level->hits, level->misses,
+               lookups > 0 ? (double)level->hits / lookups * 100.0 : 0.0);
+    }
+
+    const CacheLevel *llc = &caches->levels[CACHE_LEVELS - 1];
+    int walk_lines = 0;
+    for (int i = 0; i < llc->sets * llc->associativity; i++)
+    {
+        if (llc->tags[i] >= 0 && llc->walk_lines[i])
+        {
+            walk_lines++;
+        }
+    }
+    printf("Back Invalidations: %lld\n", caches->back_invalidations);
+    printf("Page Walk Cache Accesses: %lld (%lld went to memory)\n",
+           caches->walk_accesses, caches->walk_memory_accesses);
+    printf("LLC Lines Holding Page Table Entries: %d (%.2f%%)\n", walk_lines,
+           (double)walk_lines / (llc->sets * llc->associativity) * 100.0);
+
+    printf("\nLLC Page Colors: %d\n", caches->colors);
+    if (caches->colors > CACHE_MAX_COLORS_SHOWN)
+    {
+        printf("(Per-color breakdown omitted for more than %d colors.)\n", CACHE_MAX_COLORS_SHOWN);
+        return;
+    }
+    printf("Color\tAccesses\tMisses\t\tMiss Ratio\n");
+    for (int i = 0; i < caches->colors; i++)
+    {
+        printf("%d\t%-12lld\t%-12lld\t%.2f%%\n", i, caches->color_accesses[i], caches->color_misses[i],
+               caches->color_accesses[i] > 0 ? (double)caches->color_misses[i] / caches->color_accesses[i] * 100.0
+                                             : 0.0);
+    }
+}
+
+void configure_cache_level(PhysicalMemory *phys_mem, int index)
+{
+    CacheLevel *level = &phys_mem->caches.levels[index];
+    CacheLevel replacement;
+    int size, associativity;
+
+    if (!read_int("Enter cache size in bytes (power of 2): ", &size) ||
+        !read_int("Enter associativity (power of 2): ", &associativity))
+    {
+        return;
+    }
+    if (!initialize_cache_level(&replacement, size, associativity, level->latency_ns))
+    {
+        printf("Error: Size and associativity must be powers of 2 with at least one %d-byte line per way.\n",
+               CACHE_LINE_SIZE);
+        return;
+    }
+
+    free_cache_level(level);
+    *level = replacement;
+    if (index == CACHE_LEVELS - 1 &&
+        (!update_cache_colors(&phys_mem->caches, phys_mem->page_size) || !rebuild_color_bins(phys_mem)))
+    {
+        printf("Error: Unable to allocate page color counters.\n");
+    }
+}
+
+void view_color_occupancy(const PhysicalMemory *phys_mem, const ProcessList *proc_list)
+{
+    const ColorAllocator *allocator = &phys_mem->color_allocator;
+    int colors = allocator->colors;
+
+    printf("\n=== Page Color Occupancy ===\n");
+    printf("Colors: %d (%d frames each)\n", colors, allocator->bin_capacity);
+    printf("Partition Overflows: %lld\n", allocator->partition_overflows);
+
+    if (colors <= CACHE_MAX_COLORS_SHOWN)
+    {
+        int *anonymous = (int *)calloc(colors, sizeof(int));
+        int *cached = (int *)calloc(colors, sizeof(int));
+        if (anonymous == NULL || cached == NULL)
+        {
+            printf("Error: Unable to allocate occupancy counters.\n");
+            free(anonymous);
+            free(cached);
+            return;
+        }
+        for (int i = 0; i < phys_mem->tiering.tiers[TIER_DRAM].number_of_frames; i++)
+        {
+            if (phys_mem->frames[i].type == FRAME_ANONYMOUS)
+            {
+                anonymous[frame_color(phys_mem, i)]++;
+            }
+            else if (phys_mem->frames[i].type == FRAME_PAGE_CACHE)
+            {
+                cached[frame_color(phys_mem, i)]++;
+            }
+        }
+
+        printf("Color\tFree\tAnonymous\tPage Cache\n");
+        for (int color = 0; color < colors; color++)
+        {
+            printf("%d\t%d\t%d\t\t%d\n", color, allocator->free_counts[color], anonymous[color], cached[color]);
+        }
+        free(anonymous);
+        free(cached);
+    }
+
+    if (proc_list->count == 0)
+    {
+        return;
+    }
+
+    printf("\nPID\tPartition\tColors Used\tResident\n");
+    unsigned char *used = (unsigned char *)malloc(colors);
+    if (used == NULL)
+    {
+        return;
+    }
+    for (int p = 0; p < proc_list->count; p++)
+    {
+        const Process *process = &proc_list->processes[p];
+        int distinct = 0;
+        memset(used, 0, colors);
+        for (int i = 0; i < phys_mem->tiering.tiers[TIER_DRAM].number_of_frames; i++)
+        {
+            const FrameInfo *info = &phys_mem->frames[i];
+            if (info->type == FRAME_ANONYMOUS && info->owner == p && !used[frame_color(phys_mem, i)])
+            {
+                used[frame_color(phys_mem, i)] = 1;
+                distinct++;
+            }
+        }
+
+        if (process->color_count > 0)
+        {
+            printf("%d\t[%d, %d)\t\t%d\t\t%d\n", process->process_id, process->color_first % colors,
+                   process->color_first % colors + (process->color_count < colors ? process->color_count : colors),
+                   distinct, proc_list->resident_pages[p]);
+        }
+        else
+        {
+            printf("%d\tall\t\t%d\t\t%d\n", process->process_id, distinct, proc_list->resident_pages[p]);
+        }
+    }
+    free(used);
+}
+
+void partition_colors_evenly(const PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    int colors = phys_mem->color_allocator.colors;
+    if (proc_list->count == 0)
+    {
+        printf("\nNo processes available to partition.\n");
+        return;
+    }
+
+    int share = colors / proc_list->count;
+    if (share == 0)
+    {
+        printf("Warning: More processes than colors; partitions will overlap.\n");
+        share = 1;
+    }
+
+    for (int i = 0; i < proc_list->count; i++)
+    {
+        Process *process = &proc_list->processes[i];
+        process->color_first = (i * share) % colors;
+        process->color_count = share;
+        process->color_cursor = 0;
+        printf("Process %d: colors [%d, %d)\n", process->process_id, process->color_first,
+               process->color_first + share);
+    }
+}
+
+int prompt_color_partition(const PhysicalMemory *phys_mem, int *first, int *count)
+{
+    int colors = phys_mem->color_allocator.colors;
+    if (!read_int("Enter first color: ", first) || !read_int("Enter number of colors (0 = all): ", count))
+    {
+        return 0;
+    }
+    if (*first < 0 || *first >= colors || *count < 0 || *first + *count > colors)
+    {
+        printf("Error: Partition must lie within colors 0-%d.\n", colors - 1);
+        return 0;
+    }
+    return 1;
+}
+
+void create_virtual_machine(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list)
+{
+    int vm_id, guest_size;
+
+    printf("\n=== Create Virtual Machine ===\n");
+    if (!read_int("Enter VM ID: ", &vm_id))
+    {
+        return;
+    }
+    for (int i = 0; i < vm_list->count; i++)
+    {
+        if (vm_list->vms[i].vm_id == vm_id)
+        {
+            printf("Error: VM ID must be unique.\n");
+            return;
+        }
+    }
+
+    printf("Select the host process that runs the VMM.\n");
+    Process *vmm = prompt_for_process(host_list);
+    if (vmm == NULL || !read_int("Enter guest memory size in bytes (power of 2): ", &guest_size))
+    {
+        return;
+    }
+    if (!is_power_of_two(guest_size) || guest_size < host->page_size)
+    {
+        printf("Error: Guest memory must be a power of 2 of at least one page.\n");
+        return;
+    }
+    if (vm_list->committed_bytes + guest_size > (long long)host->total_size * vm_list->overcommit_percent / 100)
+    {
+        printf("Error: Guest memory would exceed the %d%% overcommit limit (%lld of %lld bytes committed).\n",
+               vm_list->overcommit_percent, vm_list->committed_bytes,
+               (long long)host->total_size * vm_list->overcommit_percent / 100);
+        return;
+    }
+
+    if (vm_list->count >= vm_list->capacity)
+    {
+        int capacity = vm_list->capacity > 0 ? vm_list->capacity * 2 : INITIAL_VM_LIST_CAPACITY;
+        VirtualMachine *temp = (VirtualMachine *)realloc(vm_list->vms, capacity * sizeof(VirtualMachine));
+        if (temp == NULL)
+        {
+            printf("Error: Unable to expand the VM list.\n");
+            return;
+        }
+        vm_list->vms = temp;
+        vm_list->capacity = capacity;
+    }
+
+    int guest_base = process_mmap(host, vmm, 0, guest_size, VMA_PROT_READ | VMA_PROT_WRITE, 0, 0, 0);
+    if (guest_base < 0)
+    {
+        printf("Error: Unable to map guest memory into process %d.\n", vmm->process_id);
+        return;
+    }
+
+    VirtualMachine *vm = &vm_list->vms[vm_list->count];
+    vm->balloon_frames = (int *)malloc(pages_for_size((uint64_t)guest_size, host->page_shift) * sizeof(int));
+    if (vm->balloon_frames == NULL ||
+        !initialize_tlb(&vm->combined_tlb, TLB_DEFAULT_ENTRIES, TLB_DEFAULT_ASSOCIATIVITY))
+    {
+        printf("Error: Unable to allocate the combined TLB and balloon.\n");
+        free(vm->balloon_frames);
+        process_munmap(host, host_list, vmm, guest_base, guest_size);
+        return;
+    }
+    vm->vm_id = vm_id;
+    vm->vmm_pid = vmm->process_id;
+    vm->guest_base = guest_base;
+    vm->table_base = GUEST_TABLE_REGION_BASE + (long long)vm_list->count * GUEST_TABLE_REGION_STRIDE;
+    vm->accesses = 0;
+    vm->nested_walks = 0;
+    vm->guest_references = 0;
+    vm->host_references = 0;
+    vm->max_walk_references = 0;
+    vm->balloon_pages = 0;
+    vm->balloon_inflations = 0;
+    vm->balloon_deflations = 0;
+    vm->balloon_guest_evictions = 0;
+    vm->host_pages_saved = 0;
+    vm->ballooned_accesses = 0;
+    vm->ballooned_faults = 0;
+    vm->unballooned_accesses = 0;
+    vm->unballooned_faults = 0;
+    vm_list->committed_bytes += guest_size;
+    initialize_physical_memory(&vm->guest, guest_size, host->page_size, NULL);
+    random_split(&host->random, &vm->guest.random);
+    vm->guest.guest_mode = 1;
+    initialize_process_list(&vm->guest_processes);
+    vm_list->count++;
+
+    printf("VM %d created: %d bytes of guest memory at 0x%08x in process %d.\n", vm_id, guest_size, guest_base,
+           vmm->process_id);
+}
+
+VirtualMachine *prompt_for_vm(VmList *vm_list)
+{
+    if (vm_list->count == 0)
+    {
+        printf("\nNo virtual machines available.\n");
+        return NULL;
+    }
+
+    int vm_id;
+    if (!read_int("Enter VM ID: ", &vm_id))
+    {
+        return NULL;
+    }
+    for (int i = 0; i < vm_list->count; i++)
+    {
+        if (vm_list->vms[i].vm_id == vm_id)
+        {
+            return &vm_list->vms[i];
+        }
+    }
+    printf("Error: VM with ID %d not found.\n", vm_id);
+    return NULL;
+}
+
+int nested_walk(PhysicalMemory *host, VirtualMachine *vm, int vmm_owner, int guest_owner, int page)
+{
+    PageWalker *walker = &vm->guest.walker;
+    int latency = 0;
+
+    for (int level = psc_walk_start(walker, guest_owner, page); level < WALK_LEVELS; level++)
+    {
+        long long guest_entry = page_table_entry_address(&vm->guest, guest_owner, level, page);
+        int table_page = (int)((vm->guest_base + guest_entry) >> host->page_shift);
+        latency += page_walk(host, vmm_owner, table_page);
+        latency += memory_reference_cost(
+            host, vm->table_base + guest_entry - (long long)vm->guest.number_of_frames * vm->guest.page_size, 1);
+        vm->guest_references++;
+        psc_fill(walker, guest_owner, page, level);
+    }
+    return latency;
+}
+
+int vm_access_memory(PhysicalMemory *host, ProcessList *host_list, VirtualMachine *vm, Process *process,
+                     int address, int access_type, int *guest_physical_address, int *host_physical_address)
+{
+    Process *vmm = find_process(host_list, vm->vmm_pid);
+    long long faults_before = vm->guest.stats.minor_faults + vm->guest.stats.major_faults;
+    int result = access_memory(&vm->guest, &vm->guest_processes, process, address, access_type,
+                               guest_physical_address);
+    if (result != ACCESS_OK)
+    {
+        return result;
+    }
+    vm->accesses++;
+
+    long long faults = vm->guest.stats.minor_faults + vm->guest.stats.major_faults - faults_before;
+    if (vm->balloon_pages > 0)
+    {
+        vm->ballooned_accesses++;
+        vm->ballooned_faults += faults;
+    }
+    else
+    {
+        vm->unballooned_accesses++;
+        vm->unballooned_faults += faults;
+    }
+
+    int guest_owner = process_index(&vm->guest_processes, process);
+    int page = address >> vm->guest.page_shift;
+    int host_address = vm->guest_base + *guest_physical_address;
+    int host_page = host_address >> host->page_shift;
+    PageTableEntry host_entry = pte_get(vmm, host_page);
+    int host_frame = PTE_IS_PRESENT(host_entry) ? PTE_FRAME(host_entry) : -1;
+
+    if (tlb_lookup(&vm->combined_tlb, guest_owner, page, host_frame))
+    {
+        host->stats.accesses++;
+        pte_set(vmm, host_page, host_entry | PTE_ACCESSED | (access_type == ACCESS_WRITE ? PTE_DIRTY : 0));
+        if (access_type == ACCESS_WRITE && mark_frame_dirty(host, host_frame))
+        {
+            host->frames[host_frame].pinned = 1;
+            balance_dirty_pages(host);
+            host->frames[host_frame].pinned = 0;
+        }
+        *host_physical_address = (host_frame << host->page_shift) | (host_address & host->page_mask);
+        host->stats.simulated_time_ns += memory_reference_cost(host, *host_physical_address, 0);
+        return ACCESS_OK;
+    }
+
+    int vmm_owner = process_index(host_list, vmm);
+    long long host_before = host->tlb.walk_references;
+    long long guest_before = vm->guest_references;
+    vm->nested_walks++;
+    host->stats.simulated_time_ns += nested_walk(host, vm, vmm_owner, guest_owner, page);
+
+    result = access_memory(host, host_list, vmm, host_address, access_type, host_physical_address);
+    if (result != ACCESS_OK)
+    {
+        return result;
+    }
+
+    long long host_references = host->tlb.walk_references - host_before;
+    int references = (int)(host_references + vm->guest_references - guest_before);
+    vm->host_references += host_references;
+    if (references > vm->max_walk_references)
+    {
+        vm->max_walk_references = references;
+    }
+    tlb_insert(&vm->combined_tlb, guest_owner, page, PTE_FRAME(pte_get(vmm, host_page)));
+    return ACCESS_OK;
+}
+
+void vm_access_memory_menu(PhysicalMemory *host, ProcessList *host_list, VirtualMachine *vm)
+{
+    printf("\n=== Access Guest Memory ===\n");
+    Process *process = prompt_for_process(&vm->guest_processes);
+    if (process == NULL)
+    {
+        return;
+    }
+
+    int address, value = 0;
+    char text[INPUT_BUFFER_SIZE];
+    if (!read_int("Enter guest-virtual address: ", &address))
+    {
+        return;
+    }
+    printf("Enter access type (r/w): ");
+    if (scanf("%99s", text) != 1 || (text[0] != 'r' && text[0] != 'w'))
+    {
+        printf("Error: Access type must be 'r' or 'w'.\n");
+        return;
+    }
+    int access_type = text[0] == 'w' ? ACCESS_WRITE : ACCESS_READ;
+    if (access_type == ACCESS_WRITE && !read_int("Enter byte value to write: ", &value))
+    {
+        return;
+    }
+
+    long long walks_before = vm->nested_walks;
+    int guest_physical_address, host_physical_address;
+    switch (vm_access_memory(host, host_list, vm, process, address, access_type, &guest_physical_address,
+                             &host_physical_address))
+    {
+    case ACCESS_SEGFAULT:
+        printf("Segmentation fault: address 0x%08x is not mapped.\n", address);
+        return;
+    case ACCESS_PROTECTION:
+        printf("Protection fault: %s access to 0x%08x is not permitted.\n",
+               access_type == ACCESS_WRITE ? "write" : "read", address);
+        return;
+    case ACCESS_OUT_OF_MEMORY:
+        printf("Error: Out of physical memory while handling the page fault.\n");
+        return;
+    }
+
+    if (access_type == ACCESS_WRITE)
+    {
+        vm->guest.memory[guest_physical_address] = (unsigned char)value;
+    }
+
+    printf("Guest-Virtual Address: 0x%08x\n", address);
+    printf("Guest-Physical Address: 0x%08x\n", guest_physical_address);
+    printf("Host-Physical Address: 0x%08x (Frame %d, Offset %d)\n", host_physical_address,
+           host_physical_address >> host->page_shift, host_physical_address & host->page_mask);
+    printf("Combined TLB: %s\n", vm->nested_walks > walks_before ? "Miss (2D walk)" : "Hit");
+    printf("Value: %d\n", vm->guest.memory[guest_physical_address]);
+}
+
+void view_vm_statistics(const VirtualMachine *vm)
+{
+    static const char *psc_names[WALK_LEVELS - 1] = {"PML4", "PDPT", "PDE"};
+    const Tlb *tlb = &vm->combined_tlb;
+    long long lookups = tlb->hits + tlb->misses;
+    long long references = vm->guest_references + vm->host_references;
+
+    printf("\n=== VM %d Translation Statistics ===\n", vm->vm_id);
+    printf("VMM Process: %d (guest memory at 0x%08x, %d bytes)\n", vm->vmm_pid, vm->guest_base,
+           vm->guest.total_size);
+    printf("Guest Processes: %d\n", vm->guest_processes.count);
+    printf("Nested Accesses: %lld\n", vm->accesses);
+    printf("Combined TLB: %d entries, %d-way\n", tlb->number_of_entries, tlb->associativity);
+    printf("Combined TLB Hits: %lld\n", tlb->hits);
+    printf("Combined TLB Misses: %lld\n", tlb->misses);
+    printf("Combined TLB Hit Ratio: %.2f%%\n", lookups > 0 ? (double)tlb->hits / lookups * 100.0 : 0.0);
+    printf("2D Walks: %lld\n", vm->nested_walks);
+    printf("Guest Paging-Structure References: %lld\n", vm->guest_references);
+    printf("Host Paging-Structure References: %lld\n", vm->host_references);
+    printf("References per 2D Walk: %.2f (max %d, worst case %d)\n",
+           vm->nested_walks > 0 ? (double)references / vm->nested_walks : 0.0, vm->max_walk_references,
+           WALK_LEVELS * (WALK_LEVELS + 1) + WALK_LEVELS);
+
+    printf("\nGuest Paging-Structure Caches: %s\n", vm->guest.walker.enabled ? "enabled" : "disabled");
+    printf("Cache\tEntries\tLookups\t\tHits\t\tRefs Saved\n");
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
+    {
+        const PagingStructureCache *cache = &vm->guest.walker.levels[i];
+        printf("%s\t%d\t%-12lld\t%-12lld\t%lld\n", psc_names[i], cache->number_of_entries, cache->lookups,
+               cache->hits, cache->references_saved);
+    }
+}
+
+int inflate_balloon(PhysicalMemory *host, ProcessList *host_list, VirtualMachine *vm, int pages)
+{
+    Process *vmm = find_process(host_list, vm->vmm_pid);
+    int limit = vm->guest.number_of_frames * BALLOON_MAX_PERCENT / 100;
+    int inflated = 0;
+
+    while (inflated < pages && vm->balloon_pages < limit)
+    {
+        long long evictions_before = vm->guest.stats.anonymous_evictions + vm->guest.stats.page_cache_evictions;
+        int frame;
+        if (!obtain_frame(&vm->guest, &vm->guest_processes, NULL, &frame))
+        {
+            break;
+        }
+        vm->balloon_guest_evictions +=
+            vm->guest.stats.anonymous_evictions + vm->guest.stats.page_cache_evictions - evictions_before;
+
+        FrameInfo *info = &vm->guest.frames[frame];
+        journal_record(&vm->guest, JOURNAL_FRAME_ALLOC, -1, -1, frame, FRAME_BALLOON, -1);
+        info->type = FRAME_BALLOON;
+        info->referenced = 0;
+        info->prefetched = 0;
+        info->swap_slot = -1;
+        vm->balloon_frames[vm->balloon_pages++] = frame;
+
+        int host_page = (vm->guest_base + (frame << vm->guest.page_shift)) >> host->page_shift;
+        if (PTE_IS_PRESENT(pte_get(vmm, host_page)))
+        {
+            vm->host_pages_saved++;
+        }
+        release_page_range(host, host_list, vmm, host_page, host_page + 1);
+        inflated++;
+    }
+
+    vm->balloon_inflations += inflated;
+    return inflated;
+}
+
+int deflate_balloon(VirtualMachine *vm, int pages)
+{
+    int deflated = 0;
+    while (deflated < pages && vm->balloon_pages > 0)
+    {
+        int frame = vm->balloon_frames[--vm->balloon_pages];
+        release_frames(&vm->guest, &frame, 1);
+        deflated++;
+    }
+
+    vm->balloon_deflations += deflated;
+    return deflated;
+}
+
+void balance_balloons(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list)
+{
+    if (!vm_list->balloon_enabled || vm_list->count == 0)
+    {
+        return;
+    }
+
+    int low = host->tiering.tiers[TIER_DRAM].number_of_frames * vm_list->low_watermark / 100;
+    int high = host->tiering.tiers[TIER_DRAM].number_of_frames * vm_list->high_watermark / 100;
+
+    if (host->free_frame_count < low)
+    {
+        int deficit = high - host->free_frame_count;
+        int share = (deficit + vm_list->count - 1) / vm_list->count;
+        for (int i = 0; i < vm_list->count && host->free_frame_count < high; i++)
+        {
+            inflate_balloon(host, host_list, &vm_list->vms[i], share);
+        }
+    }
+    else if (host->free_frame_count > high)
+    {
+        for (int i = 0; i < vm_list->count; i++)
+        {
+            deflate_balloon(&vm_list->vms[i], BALLOON_DEFLATE_STEP);
+        }
+    }
+}
+
+void replay_guest_trace(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list, FILE *trace,
+                        ReplayResult *result)
+{
+    char line[TRACE_LINE_SIZE];
+    long long time_before = host->stats.simulated_time_ns;
+    memset(result, 0, sizeof(ReplayResult));
+    for (int i = 0; i < vm_list->count; i++)
+    {
+        time_before += vm_list->vms[i].guest.stats.simulated_time_ns;
+    }
+
+    while (fgets(line, sizeof(line), trace) != NULL)
+    {
+        int vm_id, consumed = 0, pid, access_type, address;
+        int parsed = sscanf(line, "%d%n", &vm_id, &consumed) == 1
+                         ? parse_trace_line(line + consumed, &pid, &access_type, &address)
+                         : parse_trace_line(line, &pid, &access_type, &address);
+        if (parsed < 0 || (parsed > 0 && consumed == 0))
+        {
+            result->malformed_lines++;
+            continue;
+        }
+        if (parsed == 0)
+        {
+            continue;
+        }
+
+        VirtualMachine *vm = NULL;
+        for (int i = 0; i < vm_list->count; i++)
+        {
+            if (vm_list->vms[i].vm_id == vm_id)
+            {
+                vm = &vm_list->vms[i];
+            }
+        }
+        Process *process = vm != NULL ? find_process(&vm->guest_processes, pid) : NULL;
+        if (process == NULL)
+        {
+            result->unknown_processes++;
+            continue;
+        }
+
+        long long faults_before = vm->guest.stats.minor_faults + vm->guest.stats.major_faults;
+        int guest_physical_address, host_physical_address;
+        result->references++;
+        switch (vm_access_memory(host, host_list, vm, process, address, access_type, &guest_physical_address,
+                                 &host_physical_address))
+        {
+        case ACCESS_OK:
+            if (access_type == ACCESS_WRITE)
+            {
+                vm->guest.memory[guest_physical_address] = (unsigned char)address;
+            }
+            result->faults += vm->guest.stats.minor_faults + vm->guest.stats.major_faults - faults_before;
+            break;
+        case ACCESS_SEGFAULT:
+            result->segfaults++;
+            break;
+        case ACCESS_PROTECTION:
+            result->protection_faults++;
+            break;
+        case ACCESS_OUT_OF_MEMORY:
+            result->out_of_memory++;
+            break;
+        }
+
+        if (result->references % BALLOON_CHECK_INTERVAL == 0)
+        {
+            balance_balloons(host, host_list, vm_list);
+        }
+    }
+
+    result->simulated_time_ns = host->stats.simulated_time_ns - time_before;
+    for (int i = 0; i < vm_list->count; i++)
+    {
+        result->simulated_time_ns += vm_list->vms[i].guest.stats.simulated_time_ns;
+    }
+}
+
+void view_overcommit_summary(const PhysicalMemory *host, const VmList *vm_list)
+{
+    long long saved = 0;
+    int ballooned = 0;
+
+    printf("\n=== Overcommit Summary ===\n");
+    printf("Host Memory: %d bytes (%d frames, %d free)\n", host->total_size, host->number_of_frames,
+           host->free_frame_count);
+    printf("Committed Guest Memory: %lld bytes (%.2f%% of host, limit %d%%)\n", vm_list->committed_bytes,
+           (double)vm_list->committed_bytes / host->total_size * 100.0, vm_list->overcommit_percent);
+    printf("Balloon Manager: %s (watermarks %d%% / %d%%)\n", vm_list->balloon_enabled ? "enabled" : "disabled",
+           vm_list->low_watermark, vm_list->high_watermark);
+    printf("Host Swap Outs: %lld\n", host->stats.swap_outs);
+
+    if (vm_list->count == 0)
+    {
+        return;
+    }
+
+    printf("\nVM\tBalloon\tEvicted\tSaved\tFaults/1K (no balloon)\tFaults/1K (balloon)\tInflation\n");
+    for (int i = 0; i < vm_list->count; i++)
+    {
+        const VirtualMachine *vm = &vm_list->vms[i];
+        double base_rate = vm->unballooned_accesses > 0
+                               ? (double)vm->unballooned_faults / vm->unballooned_accesses * 1000.0
+                               : 0.0;
+        double balloon_rate =
+            vm->ballooned_accesses > 0 ? (double)vm->ballooned_faults / vm->ballooned_accesses * 1000.0 : 0.0;
+        printf("%d\t%d\t%lld\t%lld\t%-24.2f%-24.2f", vm->vm_id, vm->balloon_pages, vm->balloon_guest_evictions,
+               vm->host_pages_saved, base_rate, balloon_rate);
+        if (base_rate > 0.0 && vm->ballooned_accesses > 0)
+        {
+            printf("%.2fx\n", balloon_rate / base_rate);
+        }
+        else
+        {
+            printf("n/a\n");
+        }
+        saved += vm->host_pages_saved;
+        ballooned += vm->balloon_pages;
+    }
+    printf("\nPages in Balloons: %d (%d bytes)\n", ballooned, ballooned * host->page_size);
+    printf("Host Frames Reclaimed by Ballooning: %lld\n", saved);
+}
+
+void configure_overcommit(VmList *vm_list)
+{
+    int percent, enabled, low, high;
+    if (!read_int("Enter overcommit limit (percent of host memory, >= 100): ", &percent) ||
+        !read_int("Enable automatic ballooning (1 = yes, 0 = no): ", &enabled) ||
+        !read_int("Enter low watermark (percent of host frames free): ", &low) ||
+        !read_int("Enter high watermark (percent of host frames free): ", &high))
+    {
+        return;
+    }
+    if (percent < 100 || low < 0 || high > 100 || low >= high)
+    {
+        printf("Error: Limit must be at least 100%% and 0 <= low < high <= 100.\n");
+        return;
+    }
+
+    vm_list->overcommit_percent = percent;
+    vm_list->balloon_enabled = enabled != 0;
+    vm_list->low_watermark = low;
+    vm_list->high_watermark = high;
+}
+
+void virtual_machine_menu(PhysicalMemory *host, ProcessList *host_list, VmList *vm_list)
+{
+    int choice;
+    while (1)
+    {
+        printf("\n+------------------------------------------+\n");
+        printf("|            VIRTUAL MACHINES              |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Create Virtual Machine                |\n");
+        printf("| 2. Create Guest Process                  |\n");
+        printf("| 3. Guest Memory Map Operations           |\n");
+        printf("| 4. Access Guest Memory                   |\n");
+        printf("| 5. View VM Translation Statistics        |\n");
+        printf("| 6. View Guest Statistics                 |\n");
+        printf("| 7. Configure Combined TLB                |\n");
+        printf("| 8. Replay Guest Trace                    |\n");
+        printf("| 9. Set Balloon Size                      |\n");
+        printf("| 10. Configure Overcommit and Ballooning  |\n");
+        printf("| 11. View Overcommit Summary              |\n");
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
+        {
+            printf("Invalid input. Please enter a valid option.\n");
+            clear_input_buffer();
+            continue;
+        }
+
+        if (choice == VM_MENU_BACK)
+        {
+            return;
+        }
+        if (choice < VM_MENU_CREATE || choice > VM_MENU_OVERCOMMIT_SUMMARY)
+        {
+            printf("Invalid option. Please select a valid option from the menu.\n");
+            continue;
+        }
+        if (choice == VM_MENU_CREATE)
+        {
+            create_virtual_machine(host, host_list, vm_list);
+            continue;
+        }
+        if (choice == VM_MENU_CONFIGURE_OVERCOMMIT)
+        {
+            configure_overcommit(vm_list);
+            continue;
+        }
+        if (choice == VM_MENU_OVERCOMMIT_SUMMARY)
+        {
+            view_overcommit_summary(host, vm_list);
+            continue;
+        }
+        if (choice == VM_MENU_REPLAY)
+        {
+            char path[INPUT_BUFFER_SIZE];
+            printf("\n=== Replay Guest Trace ===\n");
+            printf("Trace format: one \"<vm_id> <pid> <r|w> <address>\" per line, '#' starts a comment.\n");
+            printf("Enter trace file path: ");
+            if (scanf("%99s", path) != 1)
+            {
+                clear_input_buffer();
+                continue;
+            }
+            FILE *trace = fopen(path, "r");
+            if (trace == NULL)
+            {
+                printf("Error: Unable to open trace file \"%s\".\n", path);
+                continue;
+            }
+            ReplayResult result;
+            replay_guest_trace(host, host_list, vm_list, trace, &result);
+            fclose(trace);
+            printf("\nReplay complete.\n");
+            print_replay_result(&result);
+            continue;
+        }
+
+        VirtualMachine *vm = prompt_for_vm(vm_list);
+        if (vm == NULL)
+        {
+            continue;
+        }
+
+        switch (choice)
+        {
+        case VM_MENU_CREATE_PROCESS:
+            create_process(&vm->guest, &vm->guest_processes, vm->guest.total_size);
+            break;
+        case VM_MENU_MEMORY_MAP:
+            memory_map_menu(&vm->guest, &vm->guest_processes);
+            break;
+        case VM_MENU_ACCESS:
+            vm_access_memory_menu(host, host_list, vm);
+            balance_balloons(host, host_list, vm_list);
+            break;
+        case VM_MENU_STATISTICS:
+            view_vm_statistics(vm);
+            break;
+        case VM_MENU_GUEST_STATISTICS:
+            view_statistics(&vm->guest);
+            break;
+        case VM_MENU_CONFIGURE_TLB:
+        {
+            Tlb replacement;
+            int entries, associativity;
+            if (!read_int("Enter number of combined TLB entries (power of 2): ", &entries) ||
+                !read_int("Enter combined TLB associativity (power of 2): ", &associativity))
+            {
+                break;
+            }
+            if (!initialize_tlb(&replacement, entries, associativity))
+            {
+                printf("Error: Entries and associativity must be powers of 2 with associativity <= entries.\n");
+                break;
+            }
+            free(vm->combined_tlb.entries);
+            vm->combined_tlb = replacement;
+            break;
+        }
+        case VM_MENU_BALLOON_TARGET:
+        {
+            int target;
+            printf("Balloon currently holds %d of %d guest pages.\n", vm->balloon_pages,
+                   vm->guest.number_of_frames);
+            if (!read_int("Enter target balloon size in pages: ", &target))
+            {
+                break;
+            }
+            if (target < 0 || target > vm->guest.number_of_frames * BALLOON_MAX_PERCENT / 100)
+            {
+                printf("Error: Balloon size must be between 0 and %d pages.\n",
+                       vm->guest.number_of_frames * BALLOON_MAX_PERCENT / 100);
+                break;
+            }
+            if (target > vm->balloon_pages)
+            {
+                inflate_balloon(host, host_list, vm, target - vm->balloon_pages);
+            }
+            else
+            {
+                deflate_balloon(vm, vm->balloon_pages - target);
+            }
+            printf("Balloon now holds %d pages.\n", vm->balloon_pages);
+            break;
+        }
+        }
+    }
+}
+
+void free_virtual_machines(VmList *vm_list)
+{
+    for (int i = 0; i < vm_list->count; i++)
+    {
+        free(vm_list->vms[i].combined_tlb.entries);
+        free(vm_list->vms[i].balloon_frames);
+        free_memory(&vm_list->vms[i].guest, &vm_list->vms[i].guest_processes);
     }
+    free(vm_list->vms);
+}
+
+void configure_caches_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    static const char *level_names[CACHE_LEVELS] = {"L1", "L2", "LLC"};
+    static const char *policy_names[] = {"inclusive", "non-inclusive", "exclusive"};
+    static const char *color_policy_names[] = {"none", "spread", "partition"};
+    CacheHierarchy *caches = &phys_mem->caches;
+    int choice;
 
     while (1)
     {
-        printf("Enter the size of a page/frame in bytes (power of 2): ");
-        if (scanf("%d", &page_size) != 1)
+        printf("\nCurrent configuration:\n");
+        printf("  Cache model: %s, %s\n", caches->enabled ? "enabled" : "disabled",
+               policy_names[caches->inclusion_policy]);
+        for (int i = 0; i < CACHE_LEVELS; i++)
         {
-            printf("Invalid input. Please enter a valid integer.\n");
+            printf("  %s: %d bytes, %d-way, %d sets, %d ns\n", level_names[i], caches->levels[i].size,
+                   caches->levels[i].associativity, caches->levels[i].sets, caches->levels[i].latency_ns);
+        }
+        printf("  TLB: %d entries, %d-way\n", phys_mem->tlb.number_of_entries, phys_mem->tlb.associativity);
+        printf("  Paging-structure caches: %s, PML4 %d, PDPT %d, PDE %d entries\n",
+               phys_mem->walker.enabled ? "enabled" : "disabled", phys_mem->walker.levels[0].number_of_entries,
+               phys_mem->walker.levels[1].number_of_entries, phys_mem->walker.levels[2].number_of_entries);
+        printf("  Frame coloring: %s, %d colors\n", color_policy_names[phys_mem->color_allocator.policy],
+               phys_mem->color_allocator.colors);
+
+        printf("\n+------------------------------------------+\n");
+        printf("|       CPU CACHE AND TLB CONFIGURATION    |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Enable/Disable Cache Model            |\n");
+        printf("| 2. Set Inclusion Policy                  |\n");
+        printf("| 3. Configure L1 Cache                    |\n");
+        printf("| 4. Configure L2 Cache                    |\n");
+        printf("| 5. Configure Last-Level Cache            |\n");
+        printf("| 6. Configure TLB                         |\n");
+        printf("| 7. View TLB and Cache Statistics         |\n");
+        printf("| 8. Set Frame Coloring Policy             |\n");
+        printf("| 9. Assign Process Color Partition        |\n");
+        printf("| 10. Partition Colors Evenly              |\n");
+        printf("| 11. View Page Color Occupancy            |\n");
+        printf("| 12. Configure Paging-Structure Caches    |\n");
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
+        {
+            printf("Invalid input. Please enter a valid option.\n");
             clear_input_buffer();
             continue;
         }
-        if (!is_power_of_two(page_size))
+
+        switch (choice)
         {
-            printf("Error: Page size must be a power of 2.\n");
-            continue;
+        case 0:
+            return;
+        case 1:
+            caches->enabled = !caches->enabled;
+            break;
+        case 2:
+        {
+            int policy;
+            if (!read_int("Enter inclusion policy (0 = inclusive, 1 = non-inclusive, 2 = exclusive): ", &policy))
+            {
+                break;
+            }
+            if (policy < CACHE_INCLUSIVE || policy > CACHE_EXCLUSIVE)
+            {
+                printf("Error: Unknown inclusion policy.\n");
+                break;
+            }
+            caches->inclusion_policy = policy;
+            for (int i = 0; i < CACHE_LEVELS; i++)
+            {
+                CacheLevel *level = &caches->levels[i];
+                for (int way = 0; way < level->sets * level->associativity; way++)
+                {
+                    level->tags[way] = -1;
+                    level->walk_lines[way] = 0;
+                }
+            }
+            break;
         }
-        if (page_size > total_memory_size)
+        case 3:
+        case 4:
+        case 5:
+            configure_cache_level(phys_mem, choice - 3);
+            break;
+        case 6:
         {
-            printf("Error: Page size cannot exceed total memory size.\n");
-            continue;
+            Tlb replacement;
+            int entries, associativity;
+            if (!read_int("Enter number of TLB entries (power of 2): ", &entries) ||
+                !read_int("Enter TLB associativity (power of 2): ", &associativity))
+            {
+                break;
+            }
+            if (!initialize_tlb(&replacement, entries, associativity))
+            {
+                printf("Error: Entries and associativity must be powers of 2 with associativity <= entries.\n");
+                break;
+            }
+            free(phys_mem->tlb.entries);
+            phys_mem->tlb = replacement;
+            break;
+        }
+        case 7:
+            view_cache_statistics(phys_mem);
+            break;
+        case 8:
+        {
+            int policy;
+            if (!read_int("Enter coloring policy (0 = none, 1 = spread, 2 = partition): ", &policy))
+            {
+                break;
+            }
+            if (policy < COLOR_POLICY_NONE || policy > COLOR_POLICY_PARTITION)
+            {
+                printf("Error: Unknown coloring policy.\n");
+                break;
+            }
+            phys_mem->color_allocator.policy = policy;
+            break;
+        }
+        case 9:
+        {
+            Process *process = prompt_for_process(proc_list);
+            int first, count;
+            if (process == NULL || !prompt_color_partition(phys_mem, &first, &count))
+            {
+                break;
+            }
+            process->color_first = first;
+            process->color_count = count;
+            process->color_cursor = 0;
+            break;
+        }
+        case 10:
+            partition_colors_evenly(phys_mem, proc_list);
+            break;
+        case 11:
+            view_color_occupancy(phys_mem, proc_list);
+            break;
+        case 12:
+            configure_page_walker(&phys_mem->walker);
+            break;
+        default:
+            printf("Invalid option. Please select a valid option from the menu.\n");
         }
-        break;
     }
+}
 
+void configure_writeback_menu(PhysicalMemory *phys_mem)
+{
+    WritebackControl *writeback = &phys_mem->writeback;
+    int choice, value;
     while (1)
     {
-        printf("Enter the maximum size of a process in bytes (power of 2): ");
-        if (scanf("%d", &max_process_size) != 1)
+        printf("\n+------------------------------------------+\n");
+        printf("|          WRITEBACK CONFIGURATION         |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Background Dirty Ratio       [%3d%%]   |\n", writeback->background_ratio);
+        printf("| 2. Dirty Ratio (throttle)       [%3d%%]   |\n", writeback->dirty_ratio);
+        printf("| 3. Writeback Batch Size         [%5d]  |\n", writeback->batch_pages);
+        printf("| 4. Flusher Interval (us)        [%7lld]|\n", writeback->interval_ns / 1000);
+        printf("| 5. Flush All Dirty Pages Now             |\n");
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
         {
-            printf("Invalid input. Please enter a valid integer.\n");
+            printf("Invalid input. Please enter a valid option.\n");
             clear_input_buffer();
             continue;
         }
-        if (!is_power_of_two(max_process_size))
+
+        switch (choice)
         {
-            printf("Error: Maximum process size must be a power of 2.\n");
-            continue;
+        case 0:
+            return;
+        case 1:
+            if (!read_int("Enter background dirty ratio (percent): ", &value))
+            {
+                break;
+            }
+            if (value < 0 || value > writeback->dirty_ratio)
+            {
+                printf("Error: Background ratio must be between 0 and the dirty ratio (%d%%).\n",
+                       writeback->dirty_ratio);
+                break;
+            }
+            writeback->background_ratio = value;
+            break;
+        case 2:
+            if (!read_int("Enter dirty ratio (percent): ", &value))
+            {
+                break;
+            }
+            if (value < writeback->background_ratio || value > 100)
+            {
+                printf("Error: Dirty ratio must be between the background ratio (%d%%) and 100.\n",
+                       writeback->background_ratio);
+                break;
+            }
+            writeback->dirty_ratio = value;
+            break;
+        case 3:
+            if (!read_int("Enter writeback batch size in pages: ", &value))
+            {
+                break;
+            }
+            if (value < 1)
+            {
+                printf("Error: Batch size must be at least 1 page.\n");
+                break;
+            }
+            writeback->batch_pages = value;
+            break;
+        case 4:
+            if (!read_int("Enter flusher interval in microseconds: ", &value))
+            {
+                break;
+            }
+            if (value < 0)
+            {
+                printf("Error: Interval cannot be negative.\n");
+                break;
+            }
+            writeback->interval_ns = (long long)value * 1000;
+            break;
+        case 5:
+        {
+            int flushed = 0, batch;
+            while ((batch = flush_dirty_pages(phys_mem, writeback->batch_pages, 0)) > 0)
+            {
+                flushed += batch;
+            }
+            printf("Flushed %d dirty pages; %d remain dirty.\n", flushed, writeback->dirty_pages);
+            break;
         }
-        if (max_process_size > total_memory_size)
+        default:
+            printf("Invalid option. Please select a valid option from the menu.\n");
+        }
+    }
+}
+
+void configure_sampling_menu(PhysicalMemory *phys_mem)
+{
+    SamplingControl *sampling = &phys_mem->sampling;
+    int choice, value;
+    while (1)
+    {
+        printf("\n+------------------------------------------+\n");
+        printf("|       TIME-SERIES SAMPLING (REPLAY)      |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Sample Every N References    [%7d]|\n", sampling->reference_interval);
+        printf("| 2. Sample Every N Microseconds  [%7lld]|\n", sampling->interval_ns / 1000);
+        printf("| 3. Set Output File                       |\n");
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Output File: %s\n", sampling->path);
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
         {
-            printf("Error: Maximum process size cannot exceed total memory size.\n");
+            printf("Invalid input. Please enter a valid option.\n");
+            clear_input_buffer();
             continue;
         }
-        break;
+
+        switch (choice)
+        {
+        case 0:
+            return;
+        case 1:
+            if (!read_int("Enter reference interval (0 to disable): ", &value))
+            {
+                break;
+            }
+            if (value < 0)
+            {
+                printf("Error: Interval cannot be negative.\n");
+                break;
+            }
+            sampling->reference_interval = value;
+            break;
+        case 2:
+            if (!read_int("Enter simulated time interval in microseconds (0 to disable): ", &value))
+            {
+                break;
+            }
+            if (value < 0)
+            {
+                printf("Error: Interval cannot be negative.\n");
+                break;
+            }
+            sampling->interval_ns = (long long)value * 1000;
+            break;
+        case 3:
+            printf("Enter output file path: ");
+            if (scanf("%99s", sampling->path) != 1)
+            {
+                clear_input_buffer();
+            }
+            break;
+        default:
+            printf("Invalid option. Please select a valid option from the menu.\n");
+        }
     }
+}
 
-    initialize_physical_memory(&phys_mem, total_memory_size, page_size);
-    initialize_process_list(&proc_list);
+void view_tier_statistics(const PhysicalMemory *phys_mem)
+{
+    static const char *tier_names[MEMORY_TIERS] = {"DRAM", "Slow"};
+    const TierControl *tiering = &phys_mem->tiering;
+    long long accesses = 0, latency = 0;
 
-    int choice;
+    printf("\n=== Memory Tier Statistics ===\n");
+    for (int i = 0; i < tiering->tier_count; i++)
+    {
+        const MemoryTier *tier = &tiering->tiers[i];
+        int free_count = i == TIER_DRAM ? phys_mem->free_frame_count : tier->free_count;
+        printf("%s Tier: %d frames, %d free, %d ns, %lld accesses\n", tier_names[i], tier->number_of_frames,
+               free_count, tier->latency_ns, tier->accesses);
+        accesses += tier->accesses;
+        latency += tier->accesses * tier->latency_ns;
+    }
+    printf("Average Memory Latency: %.1f ns\n", accesses > 0 ? (double)latency / accesses : 0.0);
+    printf("Hotness Samples: %lld\n", tiering->samples);
+    printf("Promotions: %lld\n", tiering->promotions);
+    printf("Demotions: %lld\n", tiering->demotions);
+    printf("Promotions Throttled: %lld\n", tiering->promotions_throttled);
+    printf("Slow Tier Evictions: %lld\n", tiering->slow_evictions);
+}
+
+void configure_tiering_menu(PhysicalMemory *phys_mem)
+{
+    TierControl *tiering = &phys_mem->tiering;
+    MemoryTier *slow = &tiering->tiers[TIER_SLOW];
+    int choice, value;
     while (1)
     {
         printf("\n+------------------------------------------+\n");
-        printf("|                MAIN MENU                 |\n");
+        printf("|        MEMORY TIERING CONFIGURATION      |\n");
         printf("+------------------------------------------+\n");
-        printf("| 1. View Physical Memory                  |\n");
-        printf("| 2. View Process Page Table               |\n");
-        printf("| 3. Create Process                        |\n");
-        printf("| 4. Exit                                  |\n");
+        printf("| 1. Add Slow Tier                [%5d]  |\n", slow->number_of_frames);
+        printf("| 2. Slow Tier Latency (ns)       [%5d]  |\n", slow->latency_ns);
+        printf("| 3. Promotion Rate (pages/ms)    [%5d]  |\n", tiering->promotion_rate);
+        printf("| 4. Hotness Threshold (samples)  [%5d]  |\n", tiering->hotness_threshold);
+        printf("| 5. Sample Interval (accesses)   [%5d]  |\n", tiering->sample_interval);
+        printf("| 6. View Tier Statistics                  |\n");
+        printf("| 0. Back                                  |\n");
         printf("+------------------------------------------+\n");
         printf("Select an option: ");
 
@@ -204,297 +12067,511 @@ int main()
 
         switch (choice)
         {
-        case MENU_VIEW_MEMORY:
-            view_physical_memory(&phys_mem);
+        case 0:
+            return;
+        case 1:
+            if (tiering->tier_count > 1)
+            {
+                printf("Error: A slow tier is already configured.\n");
+                break;
+            }
+            if (!read_int("Enter slow tier size in bytes: ", &value))
+            {
+                break;
+            }
+            if (value < phys_mem->page_size || (value & phys_mem->page_mask) != 0)
+            {
+                printf("Error: Tier size must be a positive multiple of the page size (%d bytes).\n",
+                       phys_mem->page_size);
+                break;
+            }
+            if ((long long)phys_mem->number_of_frames * phys_mem->page_size + value > INT_MAX)
+            {
+                printf("Error: DRAM and the slow tier together cannot exceed %d bytes.\n", INT_MAX);
+                break;
+            }
+            if (!add_slow_tier(phys_mem, value, slow->latency_ns))
+            {
+                printf("Error: Unable to allocate the slow tier.\n");
+                break;
+            }
+            printf("Slow tier added: frames %d-%d.\n", slow->first_frame, phys_mem->number_of_frames - 1);
             break;
-        case MENU_CREATE_PROCESS:
-            create_process(&phys_mem, &proc_list, max_process_size);
+        case 2:
+            if (!read_int("Enter slow tier latency in nanoseconds: ", &value))
+            {
+                break;
+            }
+            if (value < 1)
+            {
+                printf("Error: Latency must be at least 1 ns.\n");
+                break;
+            }
+            slow->latency_ns = value;
             break;
-        case MENU_VIEW_PAGE_TABLE:
-            view_page_table(&proc_list);
+        case 3:
+            if (!read_int("Enter promotion rate limit in pages per millisecond: ", &value))
+            {
+                break;
+            }
+            if (value < 0)
+            {
+                printf("Error: Promotion rate cannot be negative.\n");
+                break;
+            }
+            tiering->promotion_rate = value;
+            break;
+        case 4:
+            if (!read_int("Enter hotness threshold in samples: ", &value))
+            {
+                break;
+            }
+            if (value < 1)
+            {
+                printf("Error: Threshold must be at least 1 sample.\n");
+                break;
+            }
+            tiering->hotness_threshold = value;
+            break;
+        case 5:
+            if (!read_int("Enter sample interval in slow tier accesses: ", &value))
+            {
+                break;
+            }
+            if (value < 1)
+            {
+                printf("Error: Sample interval must be at least 1 access.\n");
+                break;
+            }
+            tiering->sample_interval = value;
+            break;
+        case 6:
+            view_tier_statistics(phys_mem);
             break;
-        case MENU_EXIT:
-            printf("Exiting the simulator...\n");
-            free_memory(&phys_mem, &proc_list);
-            return 0;
         default:
             printf("Invalid option. Please select a valid option from the menu.\n");
         }
     }
+}
 
-    return 0;
+int parse_protection(const char *text)
+{
+    if (strlen(text) != 3)
+    {
+        return -1;
+    }
+
+    int prot = VMA_PROT_NONE;
+    if (text[0] == 'r')
+    {
+        prot |= VMA_PROT_READ;
+    }
+    else if (text[0] != '-')
+    {
+        return -1;
+    }
+    if (text[1] == 'w')
+    {
+        prot |= VMA_PROT_WRITE;
+    }
+    else if (text[1] != '-')
+    {
+        return -1;
+    }
+    if (text[2] == 'x')
+    {
+        prot |= VMA_PROT_EXEC;
+    }
+    else if (text[2] != '-')
+    {
+        return -1;
+    }
+    return prot;
 }
 
-int is_power_of_two(int number)
+void format_protection(int prot, char *buffer)
 {
-    return (number > 0) && ((number & (number - 1)) == 0);
+    buffer[0] = (prot & VMA_PROT_READ) ? 'r' : '-';
+    buffer[1] = (prot & VMA_PROT_WRITE) ? 'w' : '-';
+    buffer[2] = (prot & VMA_PROT_EXEC) ? 'x' : '-';
+    buffer[3] = '\0';
 }
 
-void initialize_physical_memory(PhysicalMemory *phys_mem, int total_size, int page_size)
+int read_int(const char *prompt, int *value)
 {
-    phys_mem->total_size = total_size;
-    phys_mem->page_size = page_size;
-    phys_mem->memory = (unsigned char *)calloc(total_size, sizeof(unsigned char));
-    if (phys_mem->memory == NULL)
+    printf("%s", prompt);
+    if (scanf("%i", value) != 1)
     {
-        fprintf(stderr, "Error: Unable to allocate physical memory.\n");
-        exit(EXIT_FAILURE);
+        printf("Invalid input. Please enter a valid integer.\n");
+        clear_input_buffer();
+        return 0;
     }
+    return 1;
+}
 
-    phys_mem->number_of_frames = total_size / page_size;
-    phys_mem->free_frames = (int *)malloc(phys_mem->number_of_frames * sizeof(int));
-    if (phys_mem->free_frames == NULL)
+Process *prompt_for_process(const ProcessList *proc_list)
+{
+    if (proc_list->count == 0)
     {
-        fprintf(stderr, "Error: Unable to allocate free frames list.\n");
-        free(phys_mem->memory);
-        exit(EXIT_FAILURE);
+        printf("\nNo processes available.\n");
+        return NULL;
     }
 
-    for (int i = 0; i < phys_mem->number_of_frames; i++)
+    int pid;
+    if (!read_int("Enter Process ID: ", &pid))
     {
-        phys_mem->free_frames[i] = i;
+        return NULL;
     }
-    phys_mem->free_frame_count = phys_mem->number_of_frames;
-}
 
-void initialize_process_list(ProcessList *proc_list)
-{
-    proc_list->capacity = INITIAL_PROCESS_LIST_CAPACITY;
-    proc_list->count = 0;
-    proc_list->processes = (Process *)malloc(proc_list->capacity * sizeof(Process));
-    if (proc_list->processes == NULL)
+    Process *process = find_process(proc_list, pid);
+    if (process == NULL)
     {
-        fprintf(stderr, "Error: Unable to allocate process list.\n");
-        exit(EXIT_FAILURE);
+        printf("Error: Process with ID %d not found.\n", pid);
     }
+    return process;
 }
 
-int allocate_frames(PhysicalMemory *phys_mem, int required_frames, int *allocated_frames)
+void print_vma_tree(const VmArea *node)
 {
-    if (phys_mem->free_frame_count < required_frames)
+    if (node == NULL)
     {
-        return 0;
+        return;
     }
 
-    for (int i = 0; i < required_frames; i++)
+    print_vma_tree(node->left);
+
+    char perms[4];
+    format_protection(node->prot, perms);
+    printf("0x%08x-0x%08x\t%s%c\t", node->start, node->end, perms,
+           (node->flags & VMA_FLAG_SHARED) ? 's' : 'p');
+    if (node->flags & VMA_FLAG_FILE)
     {
-        allocated_frames[i] = phys_mem->free_frames[phys_mem->free_frame_count - 1];
-        phys_mem->free_frame_count--;
+        printf("file %d @ 0x%x\n", node->file_id, node->file_offset);
+    }
+    else if (node->flags & VMA_FLAG_HEAP)
+    {
+        printf("[heap]\n");
+    }
+    else
+    {
+        printf("anonymous\n");
     }
 
-    return 1;
+    print_vma_tree(node->right);
 }
 
-void create_process(PhysicalMemory *phys_mem, ProcessList *proc_list, int max_process_size)
+void view_memory_map(const ProcessList *proc_list, const Process *process)
 {
-    int pid, size;
-
-    printf("\n=== Create New Process ===\n");
+    printf("\nMemory Map for Process ID %d:\n", process->process_id);
+    printf("Heap Start: 0x%08x\n", process->heap_start);
+    printf("Program Break: 0x%08x\n", process->brk);
+    printf("Mmap Base: 0x%08x\n", process->mmap_base);
+    printf("VMAs: %d\n", process->vma_count);
+    printf("Resident Pages: %d\n", proc_list->resident_pages[process_index(proc_list, process)]);
+    printf("Page Faults: %d\n", process->page_faults);
+    printf("Range\t\t\tPerms\tBacking\n");
+    print_vma_tree(process->vma_root);
+}
 
+void memory_map_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    int choice;
     while (1)
     {
-        printf("Enter Process ID (integer): ");
-        if (scanf("%d", &pid) != 1)
+        printf("\n+------------------------------------------+\n");
+        printf("|          MEMORY MAP OPERATIONS           |\n");
+        printf("+------------------------------------------+\n");
+        printf("| 1. Map Region (mmap)                     |\n");
+        printf("| 2. Unmap Region (munmap)                 |\n");
+        printf("| 3. Change Protection (mprotect)          |\n");
+        printf("| 4. Set Program Break (brk)               |\n");
+        printf("| 5. View Memory Map                       |\n");
+        printf("| 0. Back                                  |\n");
+        printf("+------------------------------------------+\n");
+        printf("Select an option: ");
+
+        if (scanf("%d", &choice) != 1)
         {
-            printf("Invalid input. Please enter a valid integer.\n");
+            printf("Invalid input. Please enter a valid option.\n");
             clear_input_buffer();
             continue;
         }
 
-        int duplicate = 0;
-        for (int i = 0; i < proc_list->count; i++)
+        if (choice == MMAP_MENU_BACK)
         {
-            if (proc_list->processes[i].process_id == pid)
-            {
-                duplicate = 1;
-                break;
-            }
+            return;
         }
-
-        if (duplicate)
+        if (choice < MMAP_MENU_MAP || choice > MMAP_MENU_VIEW)
         {
-            printf("Error: Process ID must be unique. Please enter a different ID.\n");
+            printf("Invalid option. Please select a valid option from the menu.\n");
             continue;
         }
-        break;
-    }
 
-    while (1)
-    {
-        printf("Enter Process Size in bytes (power of 2, max %d): ", max_process_size);
-        if (scanf("%d", &size) != 1)
+        Process *process = prompt_for_process(proc_list);
+        if (process == NULL)
         {
-            printf("Invalid input. Please enter a valid integer.\n");
-            clear_input_buffer();
             continue;
         }
 
-        if (!is_power_of_two(size))
-        {
-            printf("Error: Process size must be a power of 2.\n");
-            continue;
-        }
+        char text[INPUT_BUFFER_SIZE];
+        int address, length, prot;
 
-        if (size > max_process_size)
+        switch (choice)
         {
-            printf("Error: Process size exceeds the maximum allowed size of %d bytes.\n", max_process_size);
-            continue;
-        }
+        case MMAP_MENU_MAP:
+        {
+            int flags = 0, file_id = 0, file_offset = 0;
+            if (!read_int("Enter length in bytes: ", &length) ||
+                !read_int("Enter start address (0 to let the simulator choose): ", &address))
+            {
+                break;
+            }
+            printf("Enter protection (e.g. rw-, r-x): ");
+            if (scanf("%99s", text) != 1 || (prot = parse_protection(text)) < 0)
+            {
+                printf("Error: Protection must be three characters from \"rwx\" or '-'.\n");
+                break;
+            }
+            printf("Enter mapping type (anon/file): ");
+            if (scanf("%99s", text) != 1 || (strcmp(text, "anon") != 0 && strcmp(text, "file") != 0))
+            {
+                printf("Error: Mapping type must be \"anon\" or \"file\".\n");
+                break;
+            }
+            if (strcmp(text, "file") == 0)
+            {
+                flags |= VMA_FLAG_FILE;
+                if (!read_int("Enter file ID: ", &file_id) ||
+                    !read_int("Enter file offset in bytes (page aligned): ", &file_offset))
+                {
+                    break;
+                }
+                printf("Shared mapping? (y/n): ");
+                if (scanf("%99s", text) == 1 && (text[0] == 'y' || text[0] == 'Y'))
+                {
+                    flags |= VMA_FLAG_SHARED;
+                }
+            }
 
-        break;
+            int start = process_mmap(phys_mem, process, address, length, prot, flags, file_id, file_offset);
+            if (start < 0)
+            {
+                printf("Error: Unable to map the region. Check alignment, overlap and address space limits.\n");
+                break;
+            }
+            printf("Mapped %d bytes at 0x%08x.\n", page_align_up(phys_mem, length), start);
+            break;
+        }
+        case MMAP_MENU_UNMAP:
+            if (!read_int("Enter start address (page aligned): ", &address) ||
+                !read_int("Enter length in bytes: ", &length))
+            {
+                break;
+            }
+            if (!process_munmap(phys_mem, proc_list, process, address, length))
+            {
+                printf("Error: Unable to unmap the range.\n");
+                break;
+            }
+            printf("Range unmapped successfully.\n");
+            break;
+        case MMAP_MENU_PROTECT:
+            if (!read_int("Enter start address (page aligned): ", &address) ||
+                !read_int("Enter length in bytes: ", &length))
+            {
+                break;
+            }
+            printf("Enter protection (e.g. rw-, r-x): ");
+            if (scanf("%99s", text) != 1 || (prot = parse_protection(text)) < 0)
+            {
+                printf("Error: Protection must be three characters from \"rwx\" or '-'.\n");
+                break;
+            }
+            if (!process_mprotect(phys_mem, process, address, length, prot))
+            {
+                printf("Error: Range must be page aligned and fully mapped.\n");
+                break;
+            }
+            printf("Protection changed successfully.\n");
+            break;
+        case MMAP_MENU_BRK:
+            printf("Current program break: 0x%08x\n", process->brk);
+            if (!read_int("Enter new program break: ", &address))
+            {
+                break;
+            }
+            if (process_brk(phys_mem, proc_list, process, address) < 0)
+            {
+                printf("Error: Unable to move the program break to 0x%08x.\n", address);
+                break;
+            }
+            printf("Program break set to 0x%08x.\n", process->brk);
+            break;
+        case MMAP_MENU_VIEW:
+            view_memory_map(proc_list, process);
+            break;
+        }
     }
+}
 
-    int pages_needed = (int)ceil((double)size / phys_mem->page_size);
-
-    int *allocated_frames = (int *)malloc(pages_needed * sizeof(int));
-    if (allocated_frames == NULL)
+void access_memory_menu(PhysicalMemory *phys_mem, ProcessList *proc_list)
+{
+    printf("\n=== Access Memory ===\n");
+    Process *process = prompt_for_process(proc_list);
+    if (process == NULL)
     {
-        printf("Error: Unable to allocate memory for frame allocation.\n");
         return;
     }
 
-    if (!allocate_frames(phys_mem, pages_needed, allocated_frames))
+    int address, value = 0;
+    char text[INPUT_BUFFER_SIZE];
+    if (!read_int("Enter virtual address: ", &address))
     {
-        printf("Error: Insufficient physical memory to allocate the process.\n");
-        free(allocated_frames);
         return;
     }
-
-    unsigned char *logical_memory = (unsigned char *)malloc(size * sizeof(unsigned char));
-    if (logical_memory == NULL)
+    printf("Enter access type (r/w): ");
+    if (scanf("%99s", text) != 1 || (text[0] != 'r' && text[0] != 'w'))
     {
-        printf("Error: Unable to allocate logical memory for the process.\n");
-        free(allocated_frames);
+        printf("Error: Access type must be 'r' or 'w'.\n");
         return;
     }
-
-    for (int i = 0; i < size; i++)
+    int access_type = text[0] == 'w' ? ACCESS_WRITE : ACCESS_READ;
+    if (access_type == ACCESS_WRITE && !read_int("Enter byte value to write: ", &value))
     {
-        logical_memory[i] = (unsigned char)(rand() % 256);
+        return;
     }
 
-    for (int i = 0; i < pages_needed; i++)
+    int faults_before = process->page_faults;
+    int physical_address;
+    switch (access_memory(phys_mem, proc_list, process, address, access_type, &physical_address))
     {
-        int frame_index = allocated_frames[i];
-        int logical_start = i * phys_mem->page_size;
-        int physical_start = frame_index * phys_mem->page_size;
-
-        for (int j = 0; j < phys_mem->page_size && (logical_start + j) < size; j++)
-        {
-            phys_mem->memory[physical_start + j] = logical_memory[logical_start + j];
-        }
+    case ACCESS_SEGFAULT:
+        printf("Segmentation fault: address 0x%08x is not mapped.\n", address);
+        return;
+    case ACCESS_PROTECTION:
+        printf("Protection fault: %s access to 0x%08x is not permitted.\n",
+               access_type == ACCESS_WRITE ? "write" : "read", address);
+        return;
+    case ACCESS_OUT_OF_MEMORY:
+        printf("Error: Out of physical memory while handling the page fault.\n");
+        return;
     }
 
-    free(logical_memory);
-
-    if (proc_list->count >= proc_list->capacity)
+    if (access_type == ACCESS_WRITE)
     {
-        proc_list->capacity *= 2;
-        Process *temp = (Process *)realloc(proc_list->processes, proc_list->capacity * sizeof(Process));
-        if (temp == NULL)
-        {
-            printf("Error: Unable to expand the process list.\n");
-            free(allocated_frames);
-            return;
-        }
-        proc_list->processes = temp;
+        phys_mem->memory[physical_address] = (unsigned char)value;
     }
 
-    Process new_process;
-    new_process.process_id = pid;
-    new_process.process_size = size;
-    new_process.number_of_pages = pages_needed;
-    new_process.page_table = allocated_frames;
-
-    proc_list->processes[proc_list->count++] = new_process;
-
-    printf("Process created successfully!\n");
-    printf("Process ID: %d\n", pid);
-    printf("Process Size: %d bytes\n", size);
-    printf("Number of Pages: %d\n", pages_needed);
+    printf("Virtual Address: 0x%08x\n", address);
+    printf("Physical Address: 0x%08x (Frame %d, Offset %d)\n", physical_address,
+           physical_address >> phys_mem->page_shift, physical_address & phys_mem->page_mask);
+    printf("Page Fault: %s\n", process->page_faults > faults_before ? "Yes" : "No");
+    printf("Value: %d\n", phys_mem->memory[physical_address]);
 }
 
-void view_physical_memory(const PhysicalMemory *phys_mem)
+void view_statistics(const PhysicalMemory *phys_mem)
 {
-    printf("\n=== Physical Memory Status ===\n");
-    printf("Total Physical Memory: %d bytes\n", phys_mem->total_size);
-    printf("Page Size: %d bytes\n", phys_mem->page_size);
-    printf("Total Number of Frames: %d\n", phys_mem->number_of_frames);
-    printf("Free Frames: %d (%.2f%%)\n",
-           phys_mem->free_frame_count,
-           ((double)phys_mem->free_frame_count / phys_mem->number_of_frames) * 100.0);
-
-    printf("\nFrame Status:\n");
-    printf("Frame\tStatus\n");
+    const MemoryStats *stats = &phys_mem->stats;
+    long long cache_lookups = stats->page_cache_hits + stats->page_cache_misses;
+    int dirty_cache_pages = 0;
     for (int i = 0; i < phys_mem->number_of_frames; i++)
     {
-        int is_free = 0;
-        for (int j = 0; j < phys_mem->free_frame_count; j++)
+        if (phys_mem->frames[i].type == FRAME_PAGE_CACHE && phys_mem->frames[i].dirty)
         {
-            if (phys_mem->free_frames[j] == i)
-            {
-                is_free = 1;
-                break;
-            }
+            dirty_cache_pages++;
         }
-        printf("%d\t%s\n", i, is_free ? "Free" : "Occupied");
-    }
-}
-
-void view_page_table(const ProcessList *proc_list)
-{
-    if (proc_list->count == 0)
-    {
-        printf("\nNo processes available to display.\n");
-        return;
     }
 
-    int pid;
-    printf("\n=== View Process Page Table ===\n");
-    printf("Enter Process ID: ");
-    if (scanf("%d", &pid) != 1)
-    {
-        printf("Invalid input. Please enter a valid integer.\n");
-        clear_input_buffer();
-        return;
-    }
+    printf("\n=== Memory Statistics ===\n");
+    printf("Memory Accesses: %lld\n", stats->accesses);
+    printf("Minor Faults: %lld\n", stats->minor_faults);
+    printf("Major Faults: %lld\n", stats->major_faults);
+    printf("\nSwap Slots Used: %d of %d\n",
+           phys_mem->swap.number_of_slots - phys_mem->swap.free_slot_count, phys_mem->swap.number_of_slots);
+    printf("Swap Ins: %lld\n", stats->swap_ins);
+    printf("Swap Outs: %lld\n", stats->swap_outs);
+    printf("Swap Writebacks: %lld (written ahead of eviction)\n", stats->swap_writebacks);
+    printf("\nPage Cache Pages: %d (%d dirty)\n", phys_mem->page_cache_pages, dirty_cache_pages);
+    printf("Page Cache Hits: %lld\n", stats->page_cache_hits);
+    printf("Page Cache Misses: %lld\n", stats->page_cache_misses);
+    printf("Page Cache Hit Ratio: %.2f%%\n",
+           cache_lookups > 0 ? (double)stats->page_cache_hits / cache_lookups * 100.0 : 0.0);
+    printf("Readahead Pages: %lld\n", stats->readahead_pages);
+    printf("Files Written Back: %d pages stored\n", phys_mem->file_store.page_count);
+    printf("\nAnonymous Evictions: %lld\n", stats->anonymous_evictions);
+    printf("Page Cache Evictions: %lld\n", stats->page_cache_evictions);
+    printf("Clean Evictions: %lld\n", stats->clean_evictions);
+    printf("Dirty Evictions: %lld\n", stats->dirty_evictions);
+    printf("\nDirty Pages: %d (%.2f%%)\n", phys_mem->writeback.dirty_pages,
+           (double)phys_mem->writeback.dirty_pages / phys_mem->number_of_frames * 100.0);
+    printf("Writeback Pages: %lld in %lld I/Os\n", stats->writeback_pages, stats->writeback_ios);
+    printf("Writeback Bandwidth: %.2f MB/s\n",
+           stats->writeback_time_ns > 0
+               ? (double)stats->writeback_pages * phys_mem->page_size / (stats->writeback_time_ns / 1e9) / 1e6
+               : 0.0);
+    printf("Background Flushes: %lld\n", stats->background_flushes);
+    printf("Writer Throttle Events: %lld\n", stats->throttle_events);
+    printf("Writer Stall Time: %.3f ms\n", stats->stall_time_ns / 1e6);
+    printf("Simulated Time: %.3f ms\n", stats->simulated_time_ns / 1e6);
 
-    Process *target_process = NULL;
-    for (int i = 0; i < proc_list->count; i++)
-    {
-        if (proc_list->processes[i].process_id == pid)
-        {
-            target_process = &proc_list->processes[i];
-            break;
-        }
-    }
+    const Prefetcher *prefetcher = &phys_mem->prefetcher;
+    long long covered = prefetcher->useful + prefetcher->demand_faults;
+    printf("\nPrefetches Issued: %lld\n", prefetcher->issued);
+    printf("Prefetches Used: %lld\n", prefetcher->useful);
+    printf("Prefetch Accuracy: %.2f%%\n",
+           prefetcher->issued > 0 ? (double)prefetcher->useful / prefetcher->issued * 100.0 : 0.0);
+    printf("Prefetch Coverage: %.2f%%\n", covered > 0 ? (double)prefetcher->useful / covered * 100.0 : 0.0);
+    printf("Prefetch Pollution: %lld evicted unused (%.2f%%)\n", prefetcher->polluted,
+           prefetcher->issued > 0 ? (double)prefetcher->polluted / prefetcher->issued * 100.0 : 0.0);
+    printf("Prefetch I/O Time: %.3f ms\n", prefetcher->io_time_ns / 1e6);
 
-    if (target_process == NULL)
-    {
-        printf("Error: Process with ID %d not found.\n", pid);
-        return;
-    }
+    long long tlb_lookups = phys_mem->tlb.hits + phys_mem->tlb.misses;
+    printf("\nTLB Hit Ratio: %.2f%%\n",
+           tlb_lookups > 0 ? (double)phys_mem->tlb.hits / tlb_lookups * 100.0 : 0.0);
 
-    printf("\nPage Table for Process ID %d:\n", pid);
-    printf("Process Size: %d bytes\n", target_process->process_size);
-    printf("Number of Pages: %d\n", target_process->number_of_pages);
-    printf("Page\tFrame\n");
-    for (int i = 0; i < target_process->number_of_pages; i++)
+    if (phys_mem->tiering.tier_count > 1)
     {
-        printf("%d\t%d\n", i, target_process->page_table[i]);
+        view_tier_statistics(phys_mem);
     }
 }
 
 void free_memory(PhysicalMemory *phys_mem, ProcessList *proc_list)
 {
-    free(phys_mem->memory);
+    unmap_memory_array(&phys_mem->backing, phys_mem->memory);
     free(phys_mem->free_frames);
-
-    for (int i = 0; i < proc_list->count; i++)
+    free(phys_mem->color_allocator.free_counts);
+    free(phys_mem->tiering.tiers[TIER_SLOW].free_frames);
+    free(phys_mem->frames);
+    free(phys_mem->swap.data);
+    free(phys_mem->swap.free_slots);
+    free(phys_mem->page_cache_buckets);
+    free(phys_mem->prefetcher.markov_table);
+    for (int i = 0; i < CACHE_LEVELS; i++)
+    {
+        free_cache_level(&phys_mem->caches.levels[i]);
+    }
+    free(phys_mem->caches.color_accesses);
+    free(phys_mem->caches.color_misses);
+    free(phys_mem->tlb.entries);
+    for (int i = 0; i < WALK_LEVELS - 1; i++)
     {
-        free(proc_list->processes[i].page_table);
+        free(phys_mem->walker.levels[i].entries);
     }
 
+    free_object_pool(&phys_mem->file_store.pages);
+    free(phys_mem->file_store.buckets);
+
+    free_page_table_arena(&proc_list->allocator->page_tables);
+    free_object_pool(&proc_list->allocator->vma_nodes);
+    free(proc_list->allocator);
+    free(proc_list->pid_index.slots);
+    free(proc_list->cpu_time_ns);
+    free(proc_list->scheduled_references);
+    free(proc_list->quanta);
+    free(proc_list->vruntimes);
+    free(proc_list->weights);
+    free(proc_list->resident_pages);
+    free(proc_list->process_ids);
     free(proc_list->processes);
 }
 